@@ -17,35 +17,37 @@
 
 #include <string>
 
+#include "./basic_balance_checker.h"
+#include "./small_token_stack.h"
 #include "./token.h"
 #include "./tokenizer.h"
-#include "./builtin_stack.h"
+#include "./token_stack.h"
 
 
 namespace tokenizer {
-class BalanceChecker {
+// Checks balance through the Tokenizer and TokenStack interfaces: a
+// thin wrapper around a
+// BasicBalanceChecker<Tokenizer, SmallTokenStack>, which fetches the
+// tokens in batches (see Tokenizer::next_tokens).
+// (Where the tokenizer's type is known, a BasicBalanceChecker over it
+// is faster.)
+class BalanceChecker : public BalanceCheckerActions {
  public:
-  enum StackAction {
-    kReportUnbalancedToken,
-    kPushNewToken,
-    kPopOldToken,
-    kNoAction
-  };
-
   // Constructs a BalanceChecker object with the given istream
   explicit BalanceChecker(Tokenizer *tokenizer)
-    : tokenizer_(tokenizer) { }
+    : checker_(tokenizer) { }
 
   // Checks to see whether whether stream is balanced
   // and updates stack as going through stream
   Token check_balance();
 
  private:
-  Tokenizer *tokenizer_;
-  BuiltinStack token_stack_;
+  BasicBalanceChecker<Tokenizer, SmallTokenStack> checker_;
 
   StackAction determine_action(TokenStack const &token_stack,
-                               Token const &new_token) const;
+                               Token const &new_token) const {
+    return checker_.determine_action(token_stack, new_token);
+  }
 
   // The tests "reach inside" to test the private function
   // determine_action; so, the Google-provided macro below makes the
@@ -60,6 +62,9 @@ class BalanceChecker {
   FRIEND_TEST(BalanceCheckerTest, OpeningToken);
   FRIEND_TEST(BalanceCheckerTest, EOFToken);
 };
+
+// (Compiled once, in balance_checker.cc.)
+extern template class BasicBalanceChecker<Tokenizer, SmallTokenStack>;
 }  // namespace tokenizer
 
 
@@ -12,16 +12,84 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+using ::testing::Eq;
 using ::testing::Test;
 
+#include <random>
 #include <sstream>
 #include <stack>
+#include <string>
+#include <vector>
 
 #include "./racket_tokenizer.h"
 #include "./balance_checker.h"
+#include "./basic_balance_checker.h"
+#include "./bracket_tokenizer.h"
 #include "./builtin_stack.h"
+#include "./small_token_stack.h"
+#include "./tokenizer_test_util.h"
 
 namespace tokenizer {
+// Produces the given tokens, then EOF tokens, classifying them as a
+// RacketTokenizer does.  (Tokens made for tests all sit at offset 0,
+// so their records are alike.)
+class ListTokenizer : public Tokenizer {
+ public:
+  explicit ListTokenizer(std::vector<Token> const &tokens)
+      : tokens_(tokens) { }
+
+  virtual Token next_token() {
+    if (next_ == tokens_.size())
+      return Token(RacketTokenizer::kEof, "", 9, 9, 1, 1);
+    return tokens_[next_++];
+  }
+
+  virtual bool are_matching(Token const & opener, Token const & closer) const {
+    return RacketTokenizer::are_matching_types(opener.type(), closer.type());
+  }
+
+  virtual bool is_opening(Token const & token) const {
+    return RacketTokenizer::is_opening_type(token.type());
+  }
+
+  virtual bool is_closing(Token const & token) const {
+    return RacketTokenizer::is_closing_type(token.type());
+  }
+
+  virtual bool classifies_by_type() const {
+    return true;
+  }
+
+ private:
+  std::vector<Token> tokens_;
+  std::size_t next_ = 0;
+};
+
+// Produces the given tags (like "<a>" and "</a>"), all of one type,
+// then EOF tokens: its tokens can only be classified by their data.
+class TagTokenizer : public ListTokenizer {
+ public:
+  explicit TagTokenizer(std::vector<Token> const &tags)
+      : ListTokenizer(tags) { }
+
+  virtual bool are_matching(Token const & opener, Token const & closer) const {
+    return is_opening(opener) && is_closing(closer) &&
+        opener.data().substr(1) == closer.data().substr(2);
+  }
+
+  virtual bool is_opening(Token const & token) const {
+    return !token.is_eof() && !is_closing(token);
+  }
+
+  virtual bool is_closing(Token const & token) const {
+    return token.data().compare(0, 2, "</") == 0;
+  }
+
+  virtual bool classifies_by_type() const {
+    return false;
+  }
+};
+
 class BalanceCheckerTest : public Test {
  protected:
   BalanceCheckerTest() { }
@@ -346,4 +414,80 @@ TEST_F(BalanceCheckerTest, Balanced) {
   EXPECT_EQ(token_EOF_, bal_check_balanced2.check_balance());
   EXPECT_EQ(token_EOF_, bal_check_balanced3.check_balance());
 }
+
+TEST_F(BalanceCheckerTest, BatchesGiveTheSameAnswer) {
+  // Deep enough that tokens stay open across many batches, with the
+  // imbalance anywhere.
+  std::default_random_engine random(221);
+  std::string const alphabet = "((([[{\")))]]}\\;#|'\n ab";
+  std::vector<std::string> texts;
+  for (int i = 0; i < 200; ++i)
+    texts.push_back(random_text(&random, 3000, alphabet));
+  texts.push_back(std::string(1000, '(') + "]" + std::string(999, ')'));
+  texts.push_back("[" + std::string(1000, '(') + std::string(1000, ')'));
+  texts.push_back(std::string(1000, '(') + std::string(1000, ')'));
+
+  for (std::string const &text : texts) {
+    std::stringstream expected_stream(text);
+    RacketTokenizer expected_tokenizer(expected_stream, "file");
+    BasicBalanceChecker<RacketTokenizer, SmallTokenStack> one_at_a_time(
+        &expected_tokenizer);
+    Token expected = one_at_a_time.check_balance();
+
+    // RacketTokenizer batches natively; BracketTokenizer through a
+    // TokenBatcher.
+    std::stringstream racket_stream(text), bracket_stream(text);
+    RacketTokenizer racket(racket_stream, "file", 64);
+    BracketTokenizer brackets(bracket_stream, "file", 64);
+    BalanceChecker racket_checker(&racket), bracket_checker(&brackets);
+    for (Token const &token : {racket_checker.check_balance(),
+                               bracket_checker.check_balance()}) {
+      expect_same_token(token, expected, text);
+    }
+  }
+}
+
+TEST_F(BalanceCheckerTest, BatchesTellAlikeRecordsApart) {
+  // The two ('s have the same record; the one left open is the
+  // second.
+  ListTokenizer tokenizer({
+      Token(RacketTokenizer::kOpenParen, "(", 1, 1, 1, 2),
+      Token(RacketTokenizer::kCloseParen, ")", 2, 2, 1, 2),
+      Token(RacketTokenizer::kOpenParen, "(", 3, 3, 1, 2)});
+  BalanceChecker checker(&tokenizer);
+  Token token = checker.check_balance();
+  EXPECT_THAT(token.data(), Eq("("));
+  EXPECT_THAT(token.start_line(), Eq(3));
+
+  // A TokenBatcher gives back its latest batch's tokens whole; a
+  // tokenizer that doesn't batch natively, only what a record says.
+  ListTokenizer batched({Token(RacketTokenizer::kOpenParen, "(", 1, 1, 1, 2)});
+  TokenBatcher<Tokenizer> batcher(&batched);
+  TokenRecord batch[4];
+  ASSERT_THAT(batcher.next_tokens(batch, 4), Eq(2u));
+  EXPECT_THAT(batcher.token_for(batch[0], 0).data(), Eq("("));
+  EXPECT_THAT(batcher.token_for(batch[0], 0).start_line(), Eq(1));
+  EXPECT_TRUE(batcher.token_for(batch[1], 1).is_eof());
+
+  ListTokenizer alone({Token(RacketTokenizer::kOpenParen, "(", 1, 1, 1, 2)});
+  EXPECT_FALSE(alone.batches_natively());
+  ASSERT_THAT(alone.next_tokens(batch, 4), Eq(2u));
+  EXPECT_THAT(alone.token_for(batch[0], 0).type(),
+              Eq(RacketTokenizer::kOpenParen));
+  EXPECT_THAT(alone.token_for(batch[0], 0).data(), Eq(""));
+  EXPECT_TRUE(alone.token_for(batch[1], 1).is_eof());
+}
+
+TEST_F(BalanceCheckerTest, BatchesClassifyByDataUnlessToldOtherwise) {
+  TagTokenizer balanced({Token(1, "<a>", 1, 1, 1, 4),
+                         Token(1, "<b>", 1, 1, 4, 7),
+                         Token(1, "</b>", 1, 1, 7, 11),
+                         Token(1, "</a>", 1, 1, 11, 15)});
+  EXPECT_TRUE(BalanceChecker(&balanced).check_balance().is_eof());
+
+  TagTokenizer unbalanced({Token(1, "<a>", 1, 1, 1, 4),
+                           Token(1, "</b>", 1, 1, 4, 8)});
+  EXPECT_THAT(BalanceChecker(&unbalanced).check_balance().data(),
+              Eq("</b>"));
+}
 }  // namespace tokenizer
@@ -0,0 +1,340 @@
+// basic_balance_checker.h --- The BasicBalanceChecker template: the
+// BalanceChecker's logic over any tokenizer and stack types, so that
+// for concrete (final) ones the compiler can inline the tokenizer's
+// classification of tokens and the stack operations.  Part of the
+// RackaBrackaStack project.
+
+// basic_balance_checker.h is Copyright (C) 2014 by the University of
+// British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#ifndef RACKET_BRACKET_STACK_BASIC_BALANCE_CHECKER_H_
+#define RACKET_BRACKET_STACK_BASIC_BALANCE_CHECKER_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "./token.h"
+#include "./token_record.h"
+#include "./tokenizer.h"
+
+namespace tokenizer {
+class BalanceChecker;
+
+// What a balance checker does with its stack for each token.
+struct BalanceCheckerActions {
+  enum StackAction {
+    kReportUnbalancedToken,
+    kPushNewToken,
+    kPopOldToken,
+    kNoAction
+  };
+};
+
+// TokenizerT needs Tokenizer's next_token, are_matching, is_opening
+// and is_closing (and, for check_balance_in_batches,
+// batches_natively, classifies_by_type and, if it batches natively,
+// next_tokens and token_for); it may be Tokenizer itself, called
+// virtually.  And
+// StackT needs TokenStack's empty, pop, push and top (as
+// std::stack<Token> has).  BalanceChecker is the
+// BasicBalanceChecker<Tokenizer, SmallTokenStack>.
+template <typename TokenizerT, typename StackT>
+class BasicBalanceChecker : public BalanceCheckerActions {
+ public:
+  // Constructs a checker of the tokens tokenizer produces.
+  explicit BasicBalanceChecker(TokenizerT *tokenizer)
+    : tokenizer_(tokenizer) { }
+
+  // Checks whether the tokenizer's tokens are balanced, reading them
+  // to the EOF token or the first imbalance.
+  //
+  // Returns one of three types of things:
+  //
+  // A closing token (i.e., a token that is closing but IS NOT
+  // opening) if a closing token did not match the preceeding opening
+  // token.
+  //
+  // An opening token if the file ended without closing an opening
+  // token.
+  //
+  // Or, on success, the EOF token that terminated input.
+  Token check_balance();
+
+  // Gives the same answer as check_balance, fetching the tokens a
+  // batch at a time as records: with TokenizerT's next_tokens, if it
+  // batches natively, else through a TokenBatcher.  If the tokenizer
+  // classifies_by_type, the open tokens are kept as records, not on a
+  // StackT; whole Tokens are only built of those still open at the
+  // end of a batch and of the one returned; and the classification of
+  // each (small) type and pair of types is asked for only once.
+  // Otherwise, each token is built whole and checked just as
+  // check_balance checks it (by check_balance itself, for a tokenizer
+  // that builds each token whole anyway).
+  Token check_balance_in_batches();
+
+  // How many tokens check_balance_in_batches fetches at a time.
+  static std::size_t const kBatchSize = 256;
+
+ private:
+  friend class BalanceChecker;
+
+  // check_balance_in_batches for a tokenizer that batches natively
+  // but doesn't classifies_by_type: check_balance's loop over each
+  // batch.
+  Token check_each_in_batches();
+
+  // check_balance_in_batches for a tokenizer that classifies_by_type,
+  // fetching its records from source (the tokenizer itself or a
+  // TokenBatcher of it).
+  template <typename SourceT>
+  Token check_records(SourceT *source);
+
+  // Determines what to do with new_token given token_stack (of any
+  // type with empty and top).
+  template <typename AnyStackT>
+  StackAction determine_action(AnyStackT const &token_stack,
+                               Token const &new_token) const;
+
+  TokenizerT *tokenizer_;
+  StackT token_stack_;
+};
+
+template <typename TokenizerT, typename StackT>
+Token BasicBalanceChecker<TokenizerT, StackT>::check_balance() {
+  // Loop until EOF, which leaves two cases to handle: (1) an empty
+  // stack (balanced, so return the EOF token itself) or (2) a
+  // non-empty stack (return its top: an opener never closed).  Any
+  // other unbalanced token (3) is returned as soon as it's found.
+  // (EOF = End of File.)
+  Token current_token = tokenizer_->next_token();
+  while (!current_token.is_eof()) {
+    StackAction action = determine_action(token_stack_, current_token);
+
+    switch (action) {
+      case kNoAction:
+        // Do nothing
+        break;
+      case kPopOldToken:
+        token_stack_.pop();
+        break;
+      case kPushNewToken:
+        token_stack_.push(current_token);
+        break;
+      case kReportUnbalancedToken:
+        // Case (3).
+        return current_token;
+    }
+
+    current_token = tokenizer_->next_token();
+  }
+
+  // Cases (1) and (2).
+  if (!token_stack_.empty())
+    return token_stack_.top();
+  return current_token;
+}
+
+template <typename TokenizerT, typename StackT>
+std::size_t const BasicBalanceChecker<TokenizerT, StackT>::kBatchSize;
+
+template <typename TokenizerT, typename StackT>
+Token BasicBalanceChecker<TokenizerT, StackT>::check_each_in_batches() {
+  TokenRecord batch[kBatchSize];
+  for (;;) {
+    std::size_t count = tokenizer_->next_tokens(batch, kBatchSize);
+    for (std::size_t i = 0; i < count; ++i) {
+      Token current_token = tokenizer_->token_for(batch[i], i);
+      if (current_token.is_eof()) {
+        // Cases (1) and (2), as in check_balance.
+        if (!token_stack_.empty())
+          return token_stack_.top();
+        return current_token;
+      }
+
+      switch (determine_action(token_stack_, current_token)) {
+        case kNoAction:
+          break;
+        case kPopOldToken:
+          token_stack_.pop();
+          break;
+        case kPushNewToken:
+          token_stack_.push(current_token);
+          break;
+        case kReportUnbalancedToken:
+          return current_token;   // Case (3).
+      }
+    }
+  }
+}
+
+template <typename TokenizerT, typename StackT>
+Token BasicBalanceChecker<TokenizerT, StackT>::check_balance_in_batches() {
+  if (!tokenizer_->batches_natively()) {
+    // Its tokens are built whole anyway; records only help classify
+    // them.
+    if (!tokenizer_->classifies_by_type())
+      return check_balance();
+    TokenBatcher<TokenizerT> batcher(tokenizer_);
+    return check_records(&batcher);
+  }
+  if (!tokenizer_->classifies_by_type())
+    return check_each_in_batches();
+  return check_records(tokenizer_);
+}
+
+template <typename TokenizerT, typename StackT>
+template <typename SourceT>
+Token BasicBalanceChecker<TokenizerT, StackT>::check_records(
+    SourceT *source) {
+  // The open tokens, innermost last, as records with their indexes in
+  // the batch they came in, and the first low of them whole.  Those
+  // from low on were opened in the current batch, so the tokenizer
+  // can still give them back whole.
+  struct OpenToken {
+    TokenRecord record;
+    std::size_t index;
+  };
+  std::vector<OpenToken> open;
+  std::vector<Token> whole;
+  std::size_t low = 0;
+  auto open_token = [&](std::size_t i) {
+    return i < low ? whole[i] :
+        source->token_for(open[i].record, open[i].index);
+  };
+
+  // What's known of the types below kCachedTypes: whether each (once
+  // kKnown) opens and closes, and whether each pair matches (once
+  // kKnown).
+  enum { kCachedTypes = 64, kKnown = 1, kOpening = 2, kClosing = 4,
+         kMatching = 2 };
+  unsigned char kinds[kCachedTypes] = {};
+  unsigned char matches[kCachedTypes][kCachedTypes] = {};
+  auto kind_of = [&](TokenRecord const &record, std::size_t index) -> int {
+    bool cached = record.type >= 0 && record.type < kCachedTypes;
+    if (cached && kinds[record.type] != 0)
+      return kinds[record.type];
+    Token const &token = source->token_for(record, index);
+    int kind = kKnown | (tokenizer_->is_opening(token) ? kOpening : 0) |
+        (tokenizer_->is_closing(token) ? kClosing : 0);
+    if (cached)
+      kinds[record.type] = static_cast<unsigned char>(kind);
+    return kind;
+  };
+  auto matches_top = [&](TokenRecord const &closer, std::size_t index) {
+    int opener_type = open.back().record.type;
+    bool cached = opener_type >= 0 && opener_type < kCachedTypes &&
+        closer.type >= 0 && closer.type < kCachedTypes;
+    if (cached && matches[opener_type][closer.type] != 0)
+      return matches[opener_type][closer.type] == (kKnown | kMatching);
+    bool match = tokenizer_->are_matching(open_token(open.size() - 1),
+                                          source->token_for(closer, index));
+    if (cached)
+      matches[opener_type][closer.type] = kKnown | (match ? kMatching : 0);
+    return match;
+  };
+
+  TokenRecord batch[kBatchSize];
+  for (;;) {
+    std::size_t count = source->next_tokens(batch, kBatchSize);
+    for (std::size_t i = 0; i < count; ++i) {
+      TokenRecord const &record = batch[i];
+      if (record.is_eof()) {
+        // Cases (1) and (2), as in check_balance.
+        if (!open.empty())
+          return open_token(open.size() - 1);
+        return source->token_for(record, i);
+      }
+
+      // As determine_action decides.
+      int kind = kind_of(record, i);
+      if ((kind & kClosing) != 0) {
+        if (!open.empty() && matches_top(record, i)) {
+          open.pop_back();
+          low = std::min(low, open.size());
+          continue;
+        }
+        if ((kind & kOpening) == 0)
+          return source->token_for(record, i);   // Case (3).
+      }
+      if ((kind & kOpening) != 0)
+        open.push_back(OpenToken{record, i});
+    }
+
+    // Build the tokens opened in this batch and still open, while the
+    // tokenizer can.
+    whole.erase(whole.begin() + low, whole.end());
+    for (; low < open.size(); ++low)
+      whole.push_back(source->token_for(open[low].record, open[low].index));
+  }
+}
+
+// Returns a stack action based on the passed stack and token.
+//
+// There are four cases to consider:
+//
+// A token that is both opening and closing (like a quotation mark
+// might be) acts as an opening token against an empty stack or a
+// stack whose top doesn't match it and gets pushed on the stack.
+// Against a stack whose top DOES match it, it acts as a closing token
+// instead and pops the token on the top of the stack.
+//
+// Otherwise, an opening token is easy: it gets pushed on the stack.
+//
+// A closing token must match the top of the stack and will then pop
+// it.  Otherwise, we have an unbalanced closing token.
+//
+// Finally, an EOF with something still on the stack means some
+// opening token was never closed. With an empty stack, it's fine!
+//
+// Note that this function is just about determining the action, NOT
+// doing it.  That should facilitate testing.  (No need to consider
+// the current state of this BalanceChecker's tokenizer or to
+// construct a full input stream.  Just make a stack and a token and
+// test what should happen with them directly.)
+template <typename TokenizerT, typename StackT>
+template <typename AnyStackT>
+BalanceCheckerActions::StackAction
+BasicBalanceChecker<TokenizerT, StackT>::determine_action(
+    AnyStackT const &token_stack, Token const &new_token) const {
+  // **** HANS WAS HERE!!!! **** Case #1? We don't need no stinking Case #1.
+  if (tokenizer_->is_opening(new_token) && tokenizer_->is_closing(new_token)) {
+    // Case #1: Both opener and closer. If token matches top of stack,
+    // then interpret as close token. If not, interpret as opening token.
+    if (!token_stack.empty()
+        && tokenizer_->are_matching(token_stack.top(), new_token)) {
+      return kPopOldToken;
+    } else {
+      return kPushNewToken;
+    }
+  } else if (tokenizer_->is_opening(new_token)) {
+    // Case #2: An opener ONLY. Just push.
+    return kPushNewToken;
+  } else if (tokenizer_->is_closing(new_token)) {
+    // Case #3: A close ONLY. To be matching, there must be a matching
+    // opening token on the top of the stack (which must be non-empty).
+    if (!token_stack.empty()
+        && tokenizer_->are_matching(token_stack.top(), new_token)) {
+      return kPopOldToken;
+    } else {
+      return kReportUnbalancedToken;
+    }
+  } else if (new_token.is_eof()) {
+    // Case #4: Reached EOF
+    if (token_stack.empty()) {
+      return kNoAction;
+    } else {
+      return kReportUnbalancedToken;
+    }
+  } else {
+    // Otherwise: a "normal" token (no bracketing effect).
+    return kNoAction;
+  }
+}
+}  // namespace tokenizer
+
+#endif  // RACKET_BRACKET_STACK_BASIC_BALANCE_CHECKER_H_
@@ -0,0 +1,202 @@
+// batch_checker.cc --- Defines the checking of many Racket files at
+// once on a pool of threads.
+
+// batch_checker.cc is Copyright (C) 2014 by the University of British
+// Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+
+#include "./batch_checker.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <dirent.h>
+#include <sys/stat.h>
+#define RACKET_BRACKET_STACK_HAVE_DIRENT 1
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#include "./basic_balance_checker.h"
+#include "./bracket_tokenizer.h"
+#include "./mapped_file.h"
+#include "./pipelined_balance_checker.h"
+#include "./small_token_stack.h"
+#include "./structural_tokenizer.h"
+
+namespace tokenizer {
+namespace {
+bool ends_with(std::string const &text, std::string const &suffix) {
+  return text.size() >= suffix.size() &&
+      text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+#ifdef RACKET_BRACKET_STACK_HAVE_DIRENT
+bool is_directory(std::string const &path) {
+  struct stat status;
+  return stat(path.c_str(), &status) == 0 && S_ISDIR(status.st_mode);
+}
+
+std::uint64_t file_size(std::string const &path) {
+  struct stat status;
+  if (stat(path.c_str(), &status) != 0 || !S_ISREG(status.st_mode))
+    return 0;
+  return status.st_size;
+}
+
+// Appends the .rkt files beneath directory to filenames, or
+// directory itself if it can't be listed.
+void append_racket_files(std::string const &directory,
+                         std::vector<std::string> *filenames) {
+  DIR *dir = opendir(directory.c_str());
+  if (dir == nullptr) {
+    filenames->push_back(directory);
+    return;
+  }
+  std::vector<std::string> entries;
+  while (struct dirent *entry = readdir(dir)) {
+    std::string name = entry->d_name;
+    if (name != "." && name != "..")
+      entries.push_back(name);
+  }
+  closedir(dir);
+
+  std::sort(entries.begin(), entries.end());
+  std::string prefix = ends_with(directory, "/") ? directory : directory + "/";
+  for (std::string const &name : entries) {
+    std::string path = prefix + name;
+    if (is_directory(path))
+      append_racket_files(path, filenames);
+    else if (ends_with(name, ".rkt"))
+      filenames->push_back(path);
+  }
+}
+#else
+// Without directory listings, every path is taken to be a file.
+bool is_directory(std::string const &) {
+  return false;
+}
+
+std::uint64_t file_size(std::string const &path) {
+  std::ifstream in(path, std::ifstream::in | std::ifstream::binary |
+                   std::ifstream::ate);
+  return in ? static_cast<std::uint64_t>(in.tellg()) : 0;
+}
+
+void append_racket_files(std::string const &,
+                         std::vector<std::string> *) { }
+#endif
+}  // namespace
+
+std::string imbalance_report(Token const &token) {
+  if (token.is_eof())
+    return "";
+  std::ostringstream report;
+  report << token.filename() << ":"
+         << token.end_line() << ":" << token.start_column() << ":  "
+         << "\'" << token.data_view() << "\' is causing an imbalance"
+         << std::endl;
+  return report.str();
+}
+
+std::vector<std::string> expand_paths(std::vector<std::string> const &paths) {
+  std::vector<std::string> filenames;
+  for (std::string const &path : paths) {
+    if (path != "-" && is_directory(path))
+      append_racket_files(path, &filenames);
+    else
+      filenames.push_back(path);
+  }
+  return filenames;
+}
+
+FileCheckResult check_file(std::string const &filename, bool use_mmap,
+                           bool pipelined) {
+  FileCheckResult result;
+  result.filename = filename;
+
+  Token token(Token::kEofToken, "", 1, 1, 1, 1);
+  MappedFile mapped_file;
+  if (use_mmap && filename != "-" && mapped_file.map(filename)) {
+    result.size = mapped_file.size();
+    StructuralTokenizer tokenizer(mapped_file.begin(), mapped_file.end(),
+                                  filename);
+    BasicBalanceChecker<StructuralTokenizer, SmallTokenStack> checker(
+        &tokenizer);
+    token = checker.check_balance();
+  } else {
+    std::ifstream file_stream;
+    if (filename != "-") {
+      file_stream.open(filename, std::ifstream::in);
+      if (!file_stream.is_open() || is_directory(filename)) {
+        result.opened = false;
+        result.balanced = false;
+        result.report = filename + ": cannot open\n";
+        return result;
+      }
+    }
+    std::istream &in = filename == "-" ? std::cin : file_stream;
+    if (pipelined) {
+      PipelinedBalanceChecker checker(in, filename);
+      token = checker.check_balance();
+    } else {
+      BracketTokenizer tokenizer(in, filename);
+      BasicBalanceChecker<BracketTokenizer, SmallTokenStack> checker(
+          &tokenizer);
+      token = checker.check_balance();
+    }
+    if (filename != "-")
+      result.size = file_size(filename);
+  }
+
+  result.balanced = token.is_eof();
+  result.report = imbalance_report(token);
+  return result;
+}
+
+std::vector<FileCheckResult> check_files(
+    std::vector<std::string> const &filenames, unsigned jobs, bool use_mmap,
+    bool pipelined) {
+  std::vector<FileCheckResult> results(filenames.size());
+
+  // Schedule the largest files first.  (Standard input has no size
+  // but is only ever read by one worker.)
+  std::vector<std::uint64_t> sizes(filenames.size());
+  std::vector<std::size_t> order(filenames.size());
+  for (std::size_t i = 0; i < filenames.size(); ++i) {
+    sizes[i] = filenames[i] == "-" ? 0 : file_size(filenames[i]);
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [&sizes](std::size_t a, std::size_t b) {
+                     return sizes[a] > sizes[b];
+                   });
+
+  // Workers claim files one at a time; each writes only its own
+  // results.
+  std::atomic<std::size_t> next(0);
+  auto work = [&]() {
+    for (std::size_t i = next++; i < order.size(); i = next++)
+      results[order[i]] = check_file(filenames[order[i]], use_mmap,
+                                     pipelined);
+  };
+
+  jobs = std::max<std::size_t>(1, std::min<std::size_t>(jobs,
+                                                        filenames.size()));
+  std::vector<std::thread> threads;
+  for (unsigned i = 1; i < jobs; ++i)
+    threads.push_back(std::thread(work));
+  work();
+  for (std::thread &thread : threads)
+    thread.join();
+
+  return results;
+}
+}  // namespace tokenizer
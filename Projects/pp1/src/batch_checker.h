@@ -0,0 +1,59 @@
+// batch_checker.h --- Declares the checking of many Racket files at
+// once, as racka_bracka does when given several files or
+// directories.  Part of the RackaBrackaStack project.
+
+// batch_checker.h is Copyright (C) 2014 by the University of British
+// Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#ifndef RACKET_BRACKET_STACK_BATCH_CHECKER_H_
+#define RACKET_BRACKET_STACK_BATCH_CHECKER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "./token.h"
+
+namespace tokenizer {
+// The outcome of checking one file.
+struct FileCheckResult {
+  std::string filename;
+  std::uint64_t size = 0;       // In bytes, if known.
+  bool opened = true;           // False if the file couldn't be read.
+  bool balanced = true;
+  std::string report;           // What racka_bracka prints, if anything.
+};
+
+// Gives the line racka_bracka prints (newline included) for the
+// token BalanceChecker::check_balance returned: nothing for the EOF
+// token.
+std::string imbalance_report(Token const &token);
+
+// Replaces each directory among paths with the .rkt files beneath it
+// (recursively, in sorted order); other paths, and directories that
+// can't be listed, are kept as they are (so that checking them
+// reports them).
+std::vector<std::string> expand_paths(std::vector<std::string> const &paths);
+
+// Checks one file (or, given -, standard input) as racka_bracka
+// does: mapped into memory if use_mmap and that's possible, else
+// streamed (tokenized on a thread of its own if pipelined; see
+// PipelinedBalanceChecker).  A file that can't be opened (or is a
+// directory) is neither opened nor balanced, and its report is
+// "<filename>: cannot open".
+FileCheckResult check_file(std::string const &filename, bool use_mmap,
+                           bool pipelined = false);
+
+// Checks every file in filenames on up to jobs threads, the largest
+// files first (so that one big file left for last doesn't hold up
+// the rest).  Returns the results in the order of filenames.
+std::vector<FileCheckResult> check_files(
+    std::vector<std::string> const &filenames, unsigned jobs, bool use_mmap,
+    bool pipelined = false);
+}  // namespace tokenizer
+
+#endif  // RACKET_BRACKET_STACK_BATCH_CHECKER_H_
@@ -0,0 +1,69 @@
+// batch_checker_benchmark.cc --- Times checking many Racket files at
+// once, as racka_bracka does given several files or directories, and
+// reports the throughput in files and megabytes per second.
+
+
+// batch_checker_benchmark.cc is Copyright (C) 2014 by the University
+// of British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#include <cstdlib>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "./batch_checker.h"
+
+int main(int argc, char *argv[]) {
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0] << " <rounds> <path>..." << std::endl;
+    std::cerr << "\tChecks every file named (a directory names every .rkt "
+              << "file beneath it)" << std::endl
+              << "\trounds times for each way racka_bracka can." << std::endl;
+    return 1;
+  }
+  int rounds = std::atoi(argv[1]);
+  if (rounds < 1) {
+    std::cerr << "Error: rounds must be positive." << std::endl;
+    return 1;
+  }
+  std::vector<std::string> filenames =
+      tokenizer::expand_paths(std::vector<std::string>(argv + 2, argv + argc));
+
+  unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<unsigned> job_counts = {1};
+  if (cores > 1)
+    job_counts.push_back(cores);
+
+  typedef std::chrono::steady_clock Clock;
+  for (bool use_mmap : {false, true}) {
+    for (unsigned jobs : job_counts) {
+      std::uint64_t bytes = 0;
+      std::size_t unbalanced = 0;
+      Clock::time_point start = Clock::now();
+      for (int round = 0; round < rounds; round++) {
+        for (tokenizer::FileCheckResult const &result :
+                 tokenizer::check_files(filenames, jobs, use_mmap)) {
+          bytes += result.size;
+          unbalanced += !result.balanced;
+        }
+      }
+      std::chrono::duration<double> elapsed = Clock::now() - start;
+
+      std::cout << (use_mmap ? "mapped,   " : "streamed, ") << jobs
+                << (jobs == 1 ? " thread:  " : " threads: ")
+                << filenames.size() * rounds / elapsed.count()
+                << " files/s, " << bytes / 1e6 / elapsed.count() << " MB/s ("
+                << unbalanced / rounds << " of " << filenames.size()
+                << " files unbalanced)" << std::endl;
+    }
+  }
+  return 0;
+}
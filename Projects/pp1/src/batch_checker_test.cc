@@ -0,0 +1,112 @@
+// batch_checker_test.cc --- Test code for checking many files at
+// once, declared in batch_checker.h.
+
+// batch_checker_test is Copyright (C) 2014 by CPSC 221 at the
+// University of British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#include <gmock/gmock.h>
+using ::testing::ElementsAre;
+using ::testing::Eq;
+#include <gtest/gtest.h>
+using ::testing::Test;
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "./batch_checker.h"
+
+namespace tokenizer {
+class BatchCheckerTest : public Test {
+ protected:
+  BatchCheckerTest() { }
+
+  virtual ~BatchCheckerTest() { }
+
+  // The contents of the named file.
+  std::string read_file(std::string const &filename) {
+    std::ifstream in(filename);
+    std::ostringstream text;
+    text << in.rdbuf();
+    return text.str();
+  }
+
+  // The test files (copied to the build directory) and what
+  // racka_bracka should print for each.
+  std::vector<std::string> const names_ = {
+    "empty", "nobrackets", "smallmatching", "largematching",
+    "unbalancedopen", "unbalancedclose"
+  };
+};
+
+TEST_F(BatchCheckerTest, ImbalanceReport) {
+  EXPECT_THAT(imbalance_report(Token(0, "", "a.rkt", 1, 1, 1, 1)), Eq(""));
+  EXPECT_THAT(imbalance_report(Token(2, ")", "a.rkt", 3, 4, 5, 6)),
+              Eq("a.rkt:4:5:  ')' is causing an imbalance\n"));
+}
+
+TEST_F(BatchCheckerTest, ResultsInInputOrder) {
+  // Many copies of each file, so that the largest-first schedule
+  // differs from the input order.
+  std::vector<std::string> filenames;
+  for (int i = 0; i < 10; ++i) {
+    for (std::string const &name : names_)
+      filenames.push_back(name + ".in.txt");
+  }
+
+  // Streamed, mapped and pipelined.
+  for (int mode = 0; mode < 3; ++mode) {
+    std::vector<FileCheckResult> results = check_files(filenames, 4, mode == 1,
+                                                       mode == 2);
+    ASSERT_THAT(results.size(), Eq(filenames.size()));
+    for (std::size_t i = 0; i < results.size(); ++i) {
+      std::string name = names_[i % names_.size()];
+      EXPECT_THAT(results[i].filename, Eq(filenames[i]));
+      EXPECT_THAT(results[i].report, Eq(read_file(name + ".out.txt")));
+      EXPECT_THAT(results[i].balanced, Eq(results[i].report.empty()));
+      EXPECT_THAT(results[i].size, Eq(read_file(filenames[i]).size()));
+    }
+  }
+}
+
+TEST_F(BatchCheckerTest, MissingFileCannotBeOpened) {
+  // Streamed, mapped and pipelined, and whether missing or a
+  // directory.
+  for (char const *name :
+           {"batch_checker_test_missing.rkt", "batch_checker_test_dir"}) {
+    std::string filename(name);
+    for (int mode = 0; mode < 3; ++mode) {
+      FileCheckResult result = check_file(filename, mode == 1, mode == 2);
+      EXPECT_FALSE(result.opened) << filename;
+      EXPECT_FALSE(result.balanced) << filename;
+      EXPECT_THAT(result.report, Eq(filename + ": cannot open\n"));
+      EXPECT_THAT(result.size, Eq(0u));
+    }
+  }
+
+  std::vector<FileCheckResult> results =
+      check_files({"empty.in.txt", "batch_checker_test_missing.rkt"}, 2,
+                  false);
+  ASSERT_THAT(results.size(), Eq(2u));
+  EXPECT_TRUE(results[0].opened);
+  EXPECT_FALSE(results[1].opened);
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+TEST_F(BatchCheckerTest, ExpandPaths) {
+  // CMake sets up batch_checker_test_dir with a few .rkt files and
+  // one that isn't.
+  EXPECT_THAT(expand_paths({"a.rkt", "batch_checker_test_dir", "-"}),
+              ElementsAre("a.rkt",
+                          "batch_checker_test_dir/open.rkt",
+                          "batch_checker_test_dir/sub/close.rkt",
+                          "batch_checker_test_dir/sub/matching.rkt",
+                          "-"));
+}
+#endif
+}  // namespace tokenizer
@@ -0,0 +1,140 @@
+// bracket_tokenizer.cc --- Defines the BracketTokenizer class, which
+// skips from one bracket or quotation mark to the next.
+
+// bracket_tokenizer.cc is Copyright (C) 2014 by the University of
+// British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+
+#include "./bracket_tokenizer.h"
+
+#include <cstring>
+
+namespace {
+// The characters that matter outside strings and comments: those
+// making structural tokens plus ; (starting a comment).
+struct CodeCharacters {
+  CodeCharacters() {
+    std::memset(matters, 0, sizeof(matters));
+    for (char const *c = "()[]{}\";"; *c != '\0'; ++c)
+      matters[static_cast<unsigned char>(*c)] = true;
+  }
+
+  bool matters[256];
+};
+
+CodeCharacters const kCodeCharacters;
+}  // namespace
+
+namespace tokenizer {
+Token BracketTokenizer::next_token() {
+  for (;;) {
+    if (pos_ == end_ && !refill_buffer()) {
+      // EOF sits just past the last character.
+      return Token(RacketTokenizer::kEof, StringView(), nullptr, nullptr,
+                   file_id_, line_, line_, column_, column_, block_offset_);
+    }
+
+    switch (state_) {
+      case kInCode: {
+        char const *position = pos_;
+        while (position != end_ &&
+               !kCodeCharacters.matters[
+                   static_cast<unsigned char>(*position)])
+          ++position;
+        pos_ = position;
+        if (position == end_)
+          break;
+
+        ++pos_;
+        if (*position == ';') {
+          state_ = kInComment;
+          break;
+        }
+        if (*position == '"')
+          state_ = kInString;
+        return make_token(position);
+      }
+      case kInString: {
+        if (escaped_) {
+          // Whatever follows a backslash is just string data.
+          ++pos_;
+          escaped_ = false;
+          break;
+        }
+        // Find the block's next quotation mark only once pos_ has
+        // passed the last one found: escapes may skip past many, but
+        // rescanning for it after each would be quadratic.
+        if (quote_ == nullptr || quote_ < pos_) {
+          quote_ = static_cast<char const *>(
+              std::memchr(pos_, '"', end_ - pos_));
+          if (quote_ == nullptr)
+            quote_ = end_;
+        }
+        char const *backslash = static_cast<char const *>(
+            std::memchr(pos_, '\\', quote_ - pos_));
+        if (backslash != nullptr) {
+          pos_ = backslash + 1;
+          escaped_ = true;
+        } else if (quote_ != end_) {
+          pos_ = quote_ + 1;
+          state_ = kInCode;
+          return make_token(quote_);
+        } else {
+          pos_ = end_;
+        }
+        break;
+      }
+      case kInComment: {
+        // The comment ends at the end of the line.
+        char const *newline = static_cast<char const *>(
+            std::memchr(pos_, '\n', end_ - pos_));
+        if (newline != nullptr) {
+          pos_ = newline + 1;
+          state_ = kInCode;
+        } else {
+          pos_ = end_;
+        }
+        break;
+      }
+    }
+  }
+}
+
+Token BracketTokenizer::make_token(char const *position) {
+  advance_to(position);
+  char c = *position;
+  return Token(RacketTokenizer::structural_type(c),
+               RacketTokenizer::structural_data(c), nullptr, nullptr,
+               file_id_, line_, line_, column_, column_ + 1,
+               block_offset_ + (position - buffer_.data()));
+}
+
+void BracketTokenizer::advance_to(char const *position) {
+  char const *newline;
+  while (scanned_ < position &&
+         (newline = static_cast<char const *>(
+             std::memchr(scanned_, '\n', position - scanned_))) != nullptr) {
+    line_++;
+    column_ = 1;
+    scanned_ = newline + 1;
+  }
+  column_ += position - scanned_;
+  scanned_ = position;
+}
+
+bool BracketTokenizer::refill_buffer() {
+  // Count the lines in the rest of this block before it's replaced.
+  advance_to(end_);
+  block_offset_ += end_ - buffer_.data();
+
+  in_.read(buffer_.data(), buffer_.size());
+  pos_ = scanned_ = buffer_.data();
+  end_ = pos_ + in_.gcount();
+  quote_ = nullptr;
+  return pos_ != end_;
+}
+}  // namespace tokenizer
@@ -0,0 +1,127 @@
+// bracket_tokenizer.h --- Concrete (leaf) class for a tokenizer for
+// Racket programs that produces only the tokens balance checking
+// needs (brackets and quotation marks) and skips everything else in
+// bulk.  Part of the RackaBrackaStack project.
+
+// bracket_tokenizer.h is Copyright (C) 2014 by the University of
+// British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#ifndef RACKET_BRACKET_STACK_BRACKET_TOKENIZER_H_
+#define RACKET_BRACKET_STACK_BRACKET_TOKENIZER_H_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+#include "./file_id.h"
+#include "./racket_tokenizer.h"
+#include "./token.h"
+#include "./tokenizer.h"
+
+namespace tokenizer {
+// Produces exactly the kOpenParen, kCloseParen, kOpenBracket,
+// kCloseBracket, kOpenBrace, kCloseBrace, kQuotationMark and kEof
+// tokens a RacketTokenizer would produce for the same stream, with
+// the same data and positions, skipping all the others.  So, a
+// BalanceChecker gives the same answer with either.
+//
+// Rather than running every character through RacketTokenizer's
+// state machine, it jumps from one character that matters to the
+// next: with a table lookup per character between tokens, and with
+// memchr through strings (to the next quotation mark or backslash)
+// and comments (to the end of the line).  Lines and columns are only
+// worked out for the tokens produced.
+//
+// (For input already in memory, a StructuralTokenizer does the same
+// job with bitmasks.)
+class BracketTokenizer final : public Tokenizer {
+ public:
+  // Constructs a tokenizer that will report itself as reading a
+  // file with no name (empty string).
+  explicit BracketTokenizer(std::istream &in) : BracketTokenizer(in, "") { }
+
+  // Constructs a tokenizer that will report itself as reading the
+  // given file and reads its input block_size (> 0) characters at a
+  // time.
+  BracketTokenizer(std::istream &in, std::string const &filename,
+                   std::size_t block_size =
+                   RacketTokenizer::kDefaultBlockSize)
+      : in_(in), file_id_(intern_filename(filename)), buffer_(block_size),
+        pos_(buffer_.data()), end_(buffer_.data()),
+        scanned_(buffer_.data()) {
+    assert(block_size > 0);
+  }
+
+  BracketTokenizer(BracketTokenizer const &) = delete;
+  BracketTokenizer &operator=(BracketTokenizer const &) = delete;
+
+  virtual Token next_token();
+
+  virtual bool are_matching(Token const & opener, Token const & closer) const {
+    return RacketTokenizer::are_matching_types(opener.type(), closer.type());
+  }
+
+  virtual bool is_opening(Token const & token) const {
+    return RacketTokenizer::is_opening_type(token.type());
+  }
+
+  virtual bool is_closing(Token const & token) const {
+    return RacketTokenizer::is_closing_type(token.type());
+  }
+
+  virtual bool classifies_by_type() const {
+    return true;
+  }
+
+ private:
+  enum ScannerState {
+    kInCode,
+    kInString,
+    kInComment
+  };
+
+  // Produces the token for the structural character at position (in
+  // the current block).
+  Token make_token(char const *position);
+
+  // Advances line_ and column_ from scanned_ to position (in the
+  // current block).
+  void advance_to(char const *position);
+
+  // Reads the next block of input.  Returns false at the end of the
+  // input.
+  bool refill_buffer();
+
+  std::istream &in_;
+  FileId file_id_;
+
+  // The current block of input: pos_ is the next character to scan,
+  // and end_ is just past the last character read.
+  std::vector<char> buffer_;
+  char const *pos_;
+  char const *end_;
+
+  ScannerState state_ = kInCode;
+  bool escaped_ = false;    // In a string, just after a backslash.
+  // In a string, the first quotation mark at or after pos_ in the
+  // current block, or end_ if there is none.  (nullptr, or anything
+  // before pos_, means it has yet to be found.)
+  char const *quote_ = nullptr;
+
+  // The position (line, column and offset) of scanned_, up to which
+  // lines have been counted.
+  char const *scanned_;
+  int line_ = 1;
+  int column_ = 1;
+  std::uint64_t block_offset_ = 0;
+};
+}  // namespace tokenizer
+
+#endif  // RACKET_BRACKET_STACK_BRACKET_TOKENIZER_H_
@@ -0,0 +1,135 @@
+// bracket_tokenizer_test.cc --- Test code for the BracketTokenizer
+// class.
+
+// bracket_tokenizer_test is Copyright (C) 2014 by CPSC 221 at the
+// University of British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#include <gmock/gmock.h>
+using ::testing::Eq;
+#include <gtest/gtest.h>
+using ::testing::Test;
+
+#include <random>
+#include <sstream>
+#include <string>
+
+#include "./balance_checker.h"
+#include "./bracket_tokenizer.h"
+#include "./racket_tokenizer.h"
+#include "./tokenizer_test_util.h"
+
+namespace tokenizer {
+class BracketTokenizerTest : public Test {
+ protected:
+  BracketTokenizerTest() { }
+
+  virtual ~BracketTokenizerTest() { }
+
+  // Checks that a BracketTokenizer reading text block_size characters
+  // at a time produces exactly the bracket, quotation mark and EOF
+  // tokens a RacketTokenizer does.
+  void check_same_bracket_tokens(std::string const &text,
+                                 std::size_t block_size) {
+    std::stringstream racket_stream(text), bracket_stream(text);
+    RacketTokenizer racket(racket_stream, "file");
+    BracketTokenizer brackets(bracket_stream, "file", block_size);
+    bool at_eof = false;
+    while (!at_eof) {
+      Token expected = racket.next_token();
+      if (!expected.is_eof() &&
+          !RacketTokenizer::is_opening_type(expected.type()) &&
+          !RacketTokenizer::is_closing_type(expected.type()))
+        continue;
+
+      expect_same_token(brackets.next_token(), expected, text);
+      at_eof = expected.is_eof();
+    }
+  }
+};
+
+TEST_F(BracketTokenizerTest, EmptyFile) {
+  std::stringstream stream("");
+  BracketTokenizer tokenizer(stream);
+  EXPECT_TRUE(tokenizer.next_token().is_eof());
+  EXPECT_TRUE(tokenizer.next_token().is_eof());
+}
+
+TEST_F(BracketTokenizerTest, SkipsEverythingElse) {
+  std::stringstream stream("(a \"b(\\\"\" ;c)\n[d])");
+  BracketTokenizer tokenizer(stream);
+  EXPECT_THAT(tokenizer.next_token(),
+              Eq(Token(RacketTokenizer::kOpenParen, "(", 1, 1, 1, 2)));
+  EXPECT_THAT(tokenizer.next_token(),
+              Eq(Token(RacketTokenizer::kQuotationMark, "\"", 1, 1, 4, 5)));
+  EXPECT_THAT(tokenizer.next_token(),
+              Eq(Token(RacketTokenizer::kQuotationMark, "\"", 1, 1, 9, 10)));
+  EXPECT_THAT(tokenizer.next_token(),
+              Eq(Token(RacketTokenizer::kOpenBracket, "[", 2, 2, 1, 2)));
+  EXPECT_THAT(tokenizer.next_token(),
+              Eq(Token(RacketTokenizer::kCloseBracket, "]", 2, 2, 3, 4)));
+  EXPECT_THAT(tokenizer.next_token(),
+              Eq(Token(RacketTokenizer::kCloseParen, ")", 2, 2, 4, 5)));
+  EXPECT_TRUE(tokenizer.next_token().is_eof());
+}
+
+TEST_F(BracketTokenizerTest, SameTokensAsRacketTokenizer) {
+  std::string const texts[] = {
+    "", "(define (f x) ;; cmt\r\n  {\"s\\\"\" [x]})", ";\r\r\n(\"\r\n\")",
+    "\"hello\\", "(\"\\\\\" )", "; only a comment ( [ {"
+  };
+  for (std::string const &text : texts) {
+    for (std::size_t block_size = 1; block_size <= 4; ++block_size)
+      check_same_bracket_tokens(text, block_size);
+  }
+
+  std::default_random_engine random(221);
+  for (int i = 0; i < 300; ++i) {
+    std::string text = random_text(&random, 200);
+    check_same_bracket_tokens(text, 1 + random() % 16);
+  }
+}
+
+// A 4 MB string of nothing but escapes is scanned in one pass over
+// each block, not one (looking for its end) per escape.
+TEST_F(BracketTokenizerTest, EscapeHeavyString) {
+  std::string escapes;
+  for (int i = 0; i < 2 * 1024 * 1024; ++i)
+    escapes += "\\n";
+  std::stringstream stream("(\"" + escapes + "\")");
+  BracketTokenizer tokenizer(stream);
+  int const column = 3 + escapes.size();
+  EXPECT_THAT(tokenizer.next_token().type(),
+              Eq(RacketTokenizer::kOpenParen));
+  EXPECT_THAT(tokenizer.next_token().type(),
+              Eq(RacketTokenizer::kQuotationMark));
+  Token quote = tokenizer.next_token();
+  EXPECT_THAT(quote.type(), Eq(RacketTokenizer::kQuotationMark));
+  EXPECT_THAT(quote.start_column(), Eq(column));
+  Token close = tokenizer.next_token();
+  EXPECT_THAT(close.type(), Eq(RacketTokenizer::kCloseParen));
+  EXPECT_THAT(close.start_column(), Eq(column + 1));
+  EXPECT_TRUE(tokenizer.next_token().is_eof());
+}
+
+TEST_F(BracketTokenizerTest, SameBalance) {
+  std::string const texts[] = {
+    "(* ({+[8 7]} 9))", ";blue({))}\n(+[3 5])", "(stringeq(\"foo\", \"bar)",
+    "{ *[+(3 5) 9] ]", "\"cool(({\" {(12345)}", "(/(+ (3 5)) 6 "
+  };
+  for (std::string const &text : texts) {
+    std::stringstream racket_stream(text), bracket_stream(text);
+    RacketTokenizer racket(racket_stream, "file");
+    BracketTokenizer brackets(bracket_stream, "file");
+    BalanceChecker racket_checker(&racket), bracket_checker(&brackets);
+    Token expected = racket_checker.check_balance();
+    Token token = bracket_checker.check_balance();
+    EXPECT_THAT(token, Eq(expected));
+    EXPECT_THAT(token.end_line(), Eq(expected.end_line()));
+    EXPECT_THAT(token.start_column(), Eq(expected.start_column()));
+  }
+}
+}  // namespace tokenizer
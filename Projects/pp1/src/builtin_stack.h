@@ -17,30 +17,25 @@
 #include "./token.h"
 
 namespace tokenizer {
-class BuiltinStack : public TokenStack {
+class BuiltinStack final : public TokenStack {
  public:
   BuiltinStack() { }
-  virtual ~BuiltinStack() {
-    // Calling pop will automatically delete each allocated Token.
-    while (!empty())
-      pop();
-  }
+  virtual ~BuiltinStack() { }
 
   virtual bool empty() const {
     return stack_.empty();
   }
 
   virtual void pop() {
-    delete stack_.top();
     stack_.pop();
   }
 
   virtual void push(Token const value) {
-    stack_.push(new Token(value));
+    stack_.push(value);
   }
 
   virtual Token const top() const {
-    return *(stack_.top());
+    return stack_.top();
   }
 
  private:
@@ -49,9 +44,10 @@ class BuiltinStack : public TokenStack {
   // deallocated automatically.  Thus, we need not do anything to it
   // in the destructor.
   //
-  // It is, however, a stack CONTAINING pointers, and the contained
-  // pointers require deleting if we allocated them (which we did!).
-  std::stack<Token const*> stack_;
+  // Tokens are assignable; so, the stack holds them by value (in
+  // the std::deque underlying std::stack) rather than allocating
+  // each one separately.
+  std::stack<Token> stack_;
 };
 }  // namespace tokenizer
 
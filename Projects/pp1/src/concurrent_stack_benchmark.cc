@@ -0,0 +1,111 @@
+// concurrent_stack_benchmark.cc --- Times threads sharing one stack of
+// tokens, the ConcurrentTokenStack against a BuiltinStack behind a
+// mutex, and reports the pushes (each with a pop) per second.
+
+// concurrent_stack_benchmark.cc is Copyright (C) 2014 by the
+// University of British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#include <cstdlib>
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "./builtin_stack.h"
+#include "./concurrent_token_stack.h"
+#include "./token.h"
+
+namespace {
+// A BuiltinStack any number of threads can share, by taking turns.
+class LockedBuiltinStack {
+ public:
+  void push(tokenizer::Token const &token) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stack_.push(token);
+  }
+
+  bool try_pop(tokenizer::Token *token) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stack_.empty())
+      return false;
+    *token = stack_.top();
+    stack_.pop();
+    return true;
+  }
+
+ private:
+  std::mutex mutex_;
+  tokenizer::BuiltinStack stack_;
+};
+
+// Has threads each push token onto stack (and then pop whatever's on
+// top) pushes times, and returns the pushes per second for all of
+// them together.
+template <typename StackT>
+double time_stack(StackT *stack, unsigned threads, long pushes,
+                  tokenizer::Token const &token) {
+  typedef std::chrono::steady_clock Clock;
+  Clock::time_point start = Clock::now();
+  std::vector<std::thread> workers;
+  for (unsigned t = 0; t < threads; ++t) {
+    workers.emplace_back([stack, pushes, &token] {
+      tokenizer::Token popped = token;
+      for (long i = 0; i < pushes; ++i) {
+        stack->push(token);
+        stack->try_pop(&popped);
+      }
+    });
+  }
+  for (std::thread &worker : workers)
+    worker.join();
+  std::chrono::duration<double> elapsed = Clock::now() - start;
+  return threads * pushes / elapsed.count();
+}
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  if (argc != 2) {
+    std::cerr << "Usage: " << argv[0] << " <pushes>" << std::endl;
+    std::cerr << "\tHas 1, 2, 4 and (if more) one per core threads "
+              << "each push that many" << std::endl
+              << "\ttokens onto one shared stack, popping one after "
+              << "each." << std::endl;
+    return 1;
+  }
+  long pushes = std::atol(argv[1]);
+  if (pushes < 1) {
+    std::cerr << "Error: pushes must be positive." << std::endl;
+    return 1;
+  }
+
+  // A token like the tokenizers' own: a view of data it shares.
+  std::shared_ptr<std::string const> data =
+      std::make_shared<std::string const>("(");
+  tokenizer::Token token(1, tokenizer::StringView(*data), data, nullptr,
+                         tokenizer::intern_filename("benchmark"),
+                         1, 1, 1, 2);
+
+  std::vector<unsigned> thread_counts = {1, 2, 4};
+  unsigned cores = std::thread::hardware_concurrency();
+  if (cores > 4)
+    thread_counts.push_back(cores);
+  for (unsigned threads : thread_counts) {
+    tokenizer::ConcurrentTokenStack concurrent_stack;
+    LockedBuiltinStack locked_stack;
+    std::cout << threads << (threads == 1 ? " thread:  " : " threads: ")
+              << "ConcurrentTokenStack "
+              << time_stack(&concurrent_stack, threads, pushes, token) / 1e6
+              << " M pushes/s, locked BuiltinStack "
+              << time_stack(&locked_stack, threads, pushes, token) / 1e6
+              << " M pushes/s" << std::endl;
+  }
+  return 0;
+}
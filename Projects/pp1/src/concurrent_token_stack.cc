@@ -0,0 +1,130 @@
+// concurrent_token_stack.cc --- Defines the ConcurrentTokenStack's
+// lock-free pushes and pops.
+
+// concurrent_token_stack.cc is Copyright (C) 2014 by the University
+// of British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#include "./concurrent_token_stack.h"
+
+#include <cassert>
+#include <new>
+#include <utility>
+
+namespace {
+// The index of the highest bit set in x, which must not be 0.
+int highest_bit(std::uint64_t x) {
+#if defined(__GNUC__)
+  return 63 - __builtin_clzll(x);
+#else
+  int bit = 0;
+  while (x >>= 1)
+    bit++;
+  return bit;
+#endif
+}
+}  // namespace
+
+namespace tokenizer {
+std::size_t const ConcurrentTokenStack::kFirstChunkSize;
+int const ConcurrentTokenStack::kMaxChunks;
+
+ConcurrentTokenStack::~ConcurrentTokenStack() {
+  while (!empty())
+    pop();
+  for (std::atomic<Node *> &chunk : chunks_)
+    delete [] chunk.load();
+}
+
+bool ConcurrentTokenStack::empty() const {
+  return link_of(head_.load(std::memory_order_acquire)) == 0;
+}
+
+void ConcurrentTokenStack::pop() {
+  std::uint32_t link = pop_link(&head_);
+  assert(link != 0);
+  reinterpret_cast<Token *>(&node(link).token)->~Token();
+  push_link(&free_, link);
+}
+
+void ConcurrentTokenStack::push(Token const value) {
+  std::uint32_t link = allocate_node();
+  new (&node(link).token) Token(value);
+  push_link(&head_, link);
+}
+
+Token const ConcurrentTokenStack::top() const {
+  assert(!empty());
+  Node &top = node(link_of(head_.load(std::memory_order_acquire)));
+  return *reinterpret_cast<Token const *>(&top.token);
+}
+
+bool ConcurrentTokenStack::try_pop(Token *token) {
+  std::uint32_t link = pop_link(&head_);
+  if (link == 0)
+    return false;
+  Token *popped = reinterpret_cast<Token *>(&node(link).token);
+  *token = std::move(*popped);
+  popped->~Token();
+  push_link(&free_, link);
+  return true;
+}
+
+ConcurrentTokenStack::Node &ConcurrentTokenStack::node(
+    std::uint32_t link) const {
+  // Chunk k holds the indices from kFirstChunkSize * (2^k - 1) on.
+  std::uint64_t position = link - 1 + kFirstChunkSize;
+  int chunk = highest_bit(position) - highest_bit(kFirstChunkSize);
+  Node *nodes = chunks_[chunk].load(std::memory_order_acquire);
+  return nodes[position - (kFirstChunkSize << chunk)];
+}
+
+void ConcurrentTokenStack::push_link(std::atomic<Head> *head,
+                                     std::uint32_t link) {
+  Node &pushed = node(link);
+  Head old_head = head->load(std::memory_order_relaxed);
+  do {
+    pushed.next.store(link_of(old_head), std::memory_order_relaxed);
+  } while (!head->compare_exchange_weak(old_head, next_head(old_head, link),
+                                        std::memory_order_release,
+                                        std::memory_order_relaxed));
+}
+
+std::uint32_t ConcurrentTokenStack::pop_link(std::atomic<Head> *head) {
+  Head old_head = head->load(std::memory_order_acquire);
+  std::uint32_t link;
+  do {
+    link = link_of(old_head);
+    if (link == 0)
+      return 0;
+    // If another thread pops this node first, next may be stale (or
+    // the node reused), but then the head's tag has changed and the
+    // swap fails.
+  } while (!head->compare_exchange_weak(
+      old_head, next_head(old_head, node(link).next.load(
+          std::memory_order_relaxed)),
+      std::memory_order_acquire, std::memory_order_acquire));
+  return link;
+}
+
+std::uint32_t ConcurrentTokenStack::allocate_node() {
+  std::uint32_t link = pop_link(&free_);
+  if (link != 0)
+    return link;
+
+  std::uint32_t index = used_.fetch_add(1, std::memory_order_relaxed);
+  assert(index + 1 != 0);  // else, out of indices
+  std::uint64_t position = index + kFirstChunkSize;
+  int chunk = highest_bit(position) - highest_bit(kFirstChunkSize);
+  if (chunks_[chunk].load(std::memory_order_acquire) == nullptr) {
+    std::lock_guard<std::mutex> lock(chunks_mutex_);
+    if (chunks_[chunk].load(std::memory_order_relaxed) == nullptr)
+      chunks_[chunk].store(new Node[kFirstChunkSize << chunk],
+                           std::memory_order_release);
+  }
+  return index + 1;
+}
+}  // namespace tokenizer
@@ -0,0 +1,130 @@
+// concurrent_token_stack.h --- Declares the ConcurrentTokenStack, a
+// lock-free (Treiber) stack of tokens that many threads can push onto
+// and pop from at once.  Part of the RackaBrackaStack project.
+
+// concurrent_token_stack.h is Copyright (C) 2014 by the University of
+// British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#ifndef RACKET_BRACKET_STACK_CONCURRENT_TOKEN_STACK_H_
+#define RACKET_BRACKET_STACK_CONCURRENT_TOKEN_STACK_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <type_traits>
+
+#include "./token_stack.h"
+#include "./token.h"
+
+namespace tokenizer {
+// push, try_pop, pop and empty may be called from any number of
+// threads at once.  top is the exception: another thread may pop the
+// token it's looking at, so threads sharing the stack should take
+// tokens with try_pop, which looks and pops in one step.  (Used from
+// one thread at a time, it's an ordinary TokenStack.)
+//
+// The stack is Treiber's: a linked list whose head is swapped in with
+// compare-and-swap.  Two things make that safe.
+//
+// ABA: a thread may read the head and its successor, stall while the
+// head is popped, its node reused and pushed again, then wrongly
+// succeed in swapping in the stale successor.  So the head holds a
+// tag, bumped on every change, alongside the node, and a stalled swap
+// fails because the tag has moved on.
+//
+// Reclamation: the stalled thread still reads the successor of a node
+// another thread may have popped.  So nodes are never freed while the
+// stack exists: popped nodes go on a free list (another tagged
+// Treiber stack) for the next push, and reading a reused node only
+// ever gives a successor that the tag then rejects.
+//
+// Nodes live in chunks, each twice the size of the last, and are
+// named by their index so that a node and a tag fit in one word any
+// platform can swap atomically.  Taking a new chunk locks a mutex; no
+// other operation blocks.
+class ConcurrentTokenStack final : public TokenStack {
+ public:
+  ConcurrentTokenStack() { }
+  virtual ~ConcurrentTokenStack();
+
+  ConcurrentTokenStack(ConcurrentTokenStack const &) = delete;
+  ConcurrentTokenStack &operator=(ConcurrentTokenStack const &) = delete;
+
+  // Whether the stack was empty at some moment during the call.
+  virtual bool empty() const;
+
+  // Pops a token (the top one, if no other thread gets there first).
+  // precondition: empty() == false.
+  virtual void pop();
+
+  virtual void push(Token const value);
+
+  // Not safe while other threads pop; see try_pop.
+  // precondition: empty() == false.
+  virtual Token const top() const;
+
+  // If the stack is not empty, pops its top token into *token and
+  // returns true; else, returns false.
+  bool try_pop(Token *token);
+
+  // The number of nodes in the first chunk.
+  static std::size_t const kFirstChunkSize = 64;
+
+ private:
+  struct Node {
+    // The index (plus one, so 0 means none) of the node below this
+    // one, or of the next free node.
+    std::atomic<std::uint32_t> next{0};
+
+    // The token, constructed here while the node is on the stack.
+    std::aligned_storage<sizeof(Token), alignof(Token)>::type token;
+  };
+
+  // A list head: a node's index plus one (0 for an empty list) in
+  // the low half, and the tag in the high half.
+  typedef std::uint64_t Head;
+
+  // Enough chunks for every node an index can name.
+  static int const kMaxChunks = 27;
+
+  static std::uint32_t link_of(Head head) {
+    return static_cast<std::uint32_t>(head);
+  }
+
+  // The head naming link, tagged one past head's tag.
+  static Head next_head(Head head, std::uint32_t link) {
+    return (((head >> 32) + 1) << 32) | link;
+  }
+
+  // The node a (nonzero) link names.
+  Node &node(std::uint32_t link) const;
+
+  // Pushes the node link names onto the list at head, or pops one off
+  // it and returns its link (0 if the list was empty).
+  void push_link(std::atomic<Head> *head, std::uint32_t link);
+  std::uint32_t pop_link(std::atomic<Head> *head);
+
+  // Returns the link of a node not in use, from the free list or,
+  // failing that, never used before.
+  std::uint32_t allocate_node();
+
+  std::atomic<Head> head_{0};
+  std::atomic<Head> free_{0};
+
+  // The number of nodes ever handed out by allocate_node other than
+  // from the free list.
+  std::atomic<std::uint32_t> used_{0};
+
+  // Chunk k holds kFirstChunkSize << k nodes and, once allocated,
+  // stays put until the stack is destroyed.
+  std::atomic<Node *> chunks_[kMaxChunks] = {};
+  std::mutex chunks_mutex_;
+};
+}  // namespace tokenizer
+
+#endif  // RACKET_BRACKET_STACK_CONCURRENT_TOKEN_STACK_H_
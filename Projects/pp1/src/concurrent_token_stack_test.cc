@@ -0,0 +1,101 @@
+// concurrent_token_stack_test.cc --- Test code for the
+// ConcurrentTokenStack class, alone and shared between threads.
+
+// concurrent_token_stack_test is Copyright (C) 2014 by CPSC 221 at the
+// University of British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#include <gmock/gmock.h>
+using ::testing::Eq;
+#include <gtest/gtest.h>
+using ::testing::Test;
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "./concurrent_token_stack.h"
+#include "./token.h"
+
+namespace tokenizer {
+class ConcurrentTokenStackTest : public Test {
+ protected:
+  ConcurrentTokenStackTest() { }
+
+  virtual ~ConcurrentTokenStackTest() { }
+
+  // A token whose type and data both name number.
+  static Token numbered_token(int number) {
+    return Token(number, std::to_string(number), 1, 1, 1, 1);
+  }
+
+  ConcurrentTokenStack stack_;
+};
+
+TEST_F(ConcurrentTokenStackTest, ActsAsTokenStack) {
+  EXPECT_THAT(stack_.empty(), Eq(true));
+
+  // Deep enough to take several chunks.
+  int const depth = 5 * ConcurrentTokenStack::kFirstChunkSize;
+  for (int i = 1; i <= depth; ++i) {
+    stack_.push(numbered_token(i));
+    EXPECT_THAT(stack_.top(), Eq(numbered_token(i)));
+  }
+  for (int i = depth; i >= 1; --i) {
+    EXPECT_THAT(stack_.empty(), Eq(false));
+    EXPECT_THAT(stack_.top(), Eq(numbered_token(i)));
+    stack_.pop();
+  }
+  EXPECT_THAT(stack_.empty(), Eq(true));
+}
+
+TEST_F(ConcurrentTokenStackTest, TryPop) {
+  Token token = numbered_token(0);
+  EXPECT_THAT(stack_.try_pop(&token), Eq(false));
+
+  stack_.push(numbered_token(1));
+  stack_.push(numbered_token(2));
+  EXPECT_THAT(stack_.try_pop(&token), Eq(true));
+  EXPECT_THAT(token, Eq(numbered_token(2)));
+  EXPECT_THAT(stack_.try_pop(&token), Eq(true));
+  EXPECT_THAT(token.data(), Eq("1"));
+  EXPECT_THAT(stack_.try_pop(&token), Eq(false));
+}
+
+TEST_F(ConcurrentTokenStackTest, SharedBetweenThreads) {
+  // Each thread pushes its own tokens and pops whatever it finds,
+  // over and over, so nodes are reused while other threads hold
+  // them.  Every token must come off exactly once, intact.
+  int const threads = 4, pushes = 20000;
+  std::vector<std::vector<int>> popped(threads);
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([this, t, &popped] {
+      Token token = numbered_token(0);
+      for (int i = 0; i < pushes; ++i) {
+        stack_.push(numbered_token(t * pushes + i + 1));
+        if (i % 3 != 0 && stack_.try_pop(&token)) {
+          if (token.data() == std::to_string(token.type()))
+            popped[t].push_back(token.type());
+        }
+      }
+    });
+  }
+  for (std::thread &worker : workers)
+    worker.join();
+
+  std::vector<int> times_popped(threads * pushes + 1, 0);
+  for (std::vector<int> const &numbers : popped) {
+    for (int number : numbers)
+      times_popped[number]++;
+  }
+  Token token = numbered_token(0);
+  while (stack_.try_pop(&token))
+    times_popped[token.type()]++;
+  for (int number = 1; number <= threads * pushes; ++number)
+    EXPECT_THAT(times_popped[number], Eq(1)) << "token " << number;
+}
+}  // namespace tokenizer
@@ -0,0 +1,251 @@
+// corpus_generator.cc --- Defines the CorpusGenerator and the parsing
+// of its options.
+
+// corpus_generator.cc is Copyright (C) 2014 by the University of
+// British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#include "./corpus_generator.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+#include <vector>
+
+namespace {
+// Source is written out in pieces about this big.
+std::size_t const kFlushSize = 1 << 16;
+
+// Lines are indented no further than this, however deep the nesting.
+std::size_t const kMaxIndent = 40;
+
+char const *const kWords[] = {
+  "define", "let", "lambda", "if", "cond", "else", "map", "foldl",
+  "list", "cons", "car", "cdr", "null?", "empty?", "string-append",
+  "vector-ref", "hash-ref", "x", "y", "n", "acc", "loop", "helper",
+  "tree", "node", "+", "-", "*", "<=", "equal?"
+};
+int const kNumWords = sizeof(kWords) / sizeof(kWords[0]);
+
+// What strings and comments are made of, brackets and all.
+char const kText[] = "abcdefghijklmnopqrstuvwxyz    ()[]{};,.!?'";
+
+// Parses a probability, or returns -1 if text isn't one.
+double parse_probability(std::string const &text) {
+  char *end;
+  double probability = std::strtod(text.c_str(), &end);
+  if (text.empty() || *end != '\0' || probability < 0 || probability > 1)
+    return -1;
+  return probability;
+}
+
+// Parses a positive count, or returns 0 if text isn't one.
+long parse_count(std::string const &text) {
+  char *end;
+  long count = std::strtol(text.c_str(), &end, 10);
+  if (text.empty() || *end != '\0' || count < 1)
+    return 0;
+  return count;
+}
+}  // namespace
+
+namespace tokenizer {
+bool parse_corpus_option(std::string const &arg, CorpusOptions *options) {
+  if (arg == "--crlf") {
+    options->crlf = true;
+    return true;
+  }
+  std::size_t equals = arg.find('=');
+  if (arg.compare(0, 2, "--") != 0 || equals == std::string::npos)
+    return false;
+  std::string name = arg.substr(2, equals - 2);
+  std::string value = arg.substr(equals + 1);
+
+  struct {
+    char const *name;
+    double *probability;
+  } const probabilities[] = {
+    {"nesting", &options->nesting},
+    {"identifiers", &options->identifiers},
+    {"strings", &options->strings},
+    {"escapes", &options->escapes},
+    {"comments", &options->comments},
+  };
+  for (auto const &option : probabilities) {
+    if (name == option.name) {
+      double probability = parse_probability(value);
+      if (probability < 0)
+        return false;
+      *option.probability = probability;
+      return true;
+    }
+  }
+
+  struct {
+    char const *name;
+    int *count;
+  } const counts[] = {
+    {"depth", &options->max_depth},
+    {"form-length", &options->form_length},
+    {"string-length", &options->string_length},
+  };
+  for (auto const &option : counts) {
+    if (name == option.name) {
+      long count = parse_count(value);
+      if (count < 1 || count > 1 << 30)
+        return false;
+      *option.count = static_cast<int>(count);
+      return true;
+    }
+  }
+
+  if (name == "seed") {
+    char *end;
+    options->seed = std::strtoull(value.c_str(), &end, 10);
+    return !value.empty() && *end == '\0';
+  }
+  return false;
+}
+
+std::uint64_t parse_corpus_size(std::string const &size) {
+  char *end;
+  std::uint64_t bytes = std::strtoull(size.c_str(), &end, 10);
+  if (end == size.c_str())
+    return 0;
+  std::string suffix = end;
+  if (suffix == "k" || suffix == "K")
+    bytes <<= 10;
+  else if (suffix == "m" || suffix == "M")
+    bytes <<= 20;
+  else if (suffix == "g" || suffix == "G")
+    bytes <<= 30;
+  else if (!suffix.empty())
+    return 0;
+  return bytes;
+}
+
+void CorpusGenerator::write(std::uint64_t size, std::ostream *out) {
+  // The forms open, innermost last.
+  struct Form {
+    char closer;
+    int items_left;
+    bool empty;
+  };
+  std::vector<Form> forms;
+  std::string text;
+  std::uint64_t written = 0;
+  int max_depth = std::max(options_.max_depth, 1);
+  int form_length = std::max(options_.form_length, 1);
+
+  while (written + text.size() < size || !forms.empty()) {
+    bool open_form;
+    if (forms.empty()) {
+      // Between top-level forms: a good place to write out what's
+      // done, and to leave a blank line.
+      if (text.size() >= kFlushSize) {
+        out->write(text.data(), text.size());
+        written += text.size();
+        text.clear();
+      }
+      if (written + text.size() > 0) {
+        append_line_break(0, &text);
+        text += options_.crlf ? "\r\n" : "\n";
+      }
+      open_form = true;
+    } else {
+      Form &form = forms.back();
+      if (form.items_left == 0 || written + text.size() >= size) {
+        text += form.closer;
+        forms.pop_back();
+        continue;
+      }
+      --form.items_left;
+      open_form = static_cast<int>(forms.size()) < max_depth &&
+          chance(options_.nesting);
+
+      // Forms usually start a line of their own; atoms rarely do.
+      if (!form.empty && chance(open_form ? 0.6 : 0.1))
+        append_line_break(forms.size(), &text);
+      else if (!form.empty)
+        text += ' ';
+      form.empty = false;
+    }
+
+    if (open_form) {
+      Form form;
+      if (chance(0.8)) {
+        text += '(';
+        form.closer = ')';
+      } else if (chance(0.75)) {
+        text += '[';
+        form.closer = ']';
+      } else {
+        text += '{';
+        form.closer = '}';
+      }
+      form.items_left = 1 + std::uniform_int_distribution<int>(
+          0, 2 * form_length - 2)(random_);
+      form.empty = true;
+      forms.push_back(form);
+    } else {
+      append_atom(&text);
+    }
+  }
+  out->write(text.data(), text.size());
+}
+
+std::string CorpusGenerator::generate(std::uint64_t size) {
+  std::ostringstream out;
+  write(size, &out);
+  return out.str();
+}
+
+void CorpusGenerator::append_line_break(std::size_t depth,
+                                        std::string *text) {
+  if (chance(options_.comments)) {
+    *text += " ;";
+    int length = std::uniform_int_distribution<int>(0, 60)(random_);
+    for (int i = 0; i < length; ++i) {
+      *text += kText[std::uniform_int_distribution<int>(
+          0, sizeof(kText) - 2)(random_)];
+    }
+  }
+  *text += options_.crlf ? "\r\n" : "\n";
+  text->append(std::min(2 * depth, kMaxIndent), ' ');
+}
+
+void CorpusGenerator::append_atom(std::string *text) {
+  if (chance(options_.strings)) {
+    append_string(text);
+  } else if (chance(options_.identifiers)) {
+    *text += kWords[std::uniform_int_distribution<int>(
+        0, kNumWords - 1)(random_)];
+  } else {
+    *text += std::to_string(
+        std::uniform_int_distribution<int>(0, 9999)(random_));
+  }
+}
+
+void CorpusGenerator::append_string(std::string *text) {
+  static char const *const kEscapes[] = {"\\\"", "\\\\", "\\n", "\\t"};
+  *text += '"';
+  int length = std::uniform_int_distribution<int>(
+      0, 2 * std::max(options_.string_length, 0))(random_);
+  for (int i = 0; i < length; ++i) {
+    if (chance(options_.escapes)) {
+      *text += kEscapes[std::uniform_int_distribution<int>(0, 3)(random_)];
+    } else {
+      *text += kText[std::uniform_int_distribution<int>(
+          0, sizeof(kText) - 2)(random_)];
+    }
+  }
+  *text += '"';
+}
+
+bool CorpusGenerator::chance(double probability) {
+  return std::uniform_real_distribution<double>(0, 1)(random_) < probability;
+}
+}  // namespace tokenizer
@@ -0,0 +1,97 @@
+// corpus_generator.h --- Declares the CorpusGenerator, which writes
+// as much Racket-like source as asked for, with the nesting, strings,
+// comments and line endings asked for.  Part of the RackaBrackaStack
+// project.
+
+// corpus_generator.h is Copyright (C) 2014 by the University of
+// British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#ifndef RACKET_BRACKET_STACK_CORPUS_GENERATOR_H_
+#define RACKET_BRACKET_STACK_CORPUS_GENERATOR_H_
+
+#include <cstdint>
+#include <ostream>
+#include <random>
+#include <string>
+
+namespace tokenizer {
+// What the generated source looks like.  Probabilities are from 0 to
+// 1.
+struct CorpusOptions {
+  // Brackets nest no deeper than this.
+  int max_depth = 16;
+
+  // The chance that an item in a form is a form itself (rather than
+  // an atom), while there's depth left.
+  double nesting = 0.3;
+
+  // The average number of items in a form.
+  int form_length = 4;
+
+  // The chance that an atom (that's not a string) is an identifier
+  // rather than a number.
+  double identifiers = 0.7;
+
+  // The chance that an atom is a string, their average length, and
+  // the chance that each character in one is an escape.
+  double strings = 0.1;
+  int string_length = 12;
+  double escapes = 0.05;
+
+  // The chance that a line ends in a comment.
+  double comments = 0.1;
+
+  // Whether lines end in "\r\n" rather than "\n".
+  bool crlf = false;
+
+  // The same seed (and options) always gives the same source.
+  std::uint64_t seed = 221;
+};
+
+// Sets the option that arg (e.g., "--depth=100" or "--crlf") names,
+// returning false if it names none.  The options are --depth,
+// --nesting, --form-length, --identifiers, --strings,
+// --string-length, --escapes, --comments, --crlf and --seed.
+bool parse_corpus_option(std::string const &arg, CorpusOptions *options);
+
+// Parses a size like "4096", "64k", "16M" or "1G" (in bytes), or
+// returns 0 if size isn't one.
+std::uint64_t parse_corpus_size(std::string const &size);
+
+// The source is a series of top-level forms, each balanced, laid out
+// over lines and indented as a person might.  Brackets also turn up
+// in strings and comments, where they don't count.
+class CorpusGenerator {
+ public:
+  explicit CorpusGenerator(CorpusOptions const &options)
+      : options_(options), random_(options.seed) { }
+
+  // Writes at least size characters of source to out: as few more as
+  // it takes to close the forms open when size is reached.
+  void write(std::uint64_t size, std::ostream *out);
+
+  // Returns what write would write.
+  std::string generate(std::uint64_t size);
+
+ private:
+  // Appends a newline (and a comment before it, perhaps) and indents
+  // the next line to depth.
+  void append_line_break(std::size_t depth, std::string *text);
+
+  // Appends an identifier, number or string.
+  void append_atom(std::string *text);
+  void append_string(std::string *text);
+
+  // Whether a chance of probability comes up.
+  bool chance(double probability);
+
+  CorpusOptions options_;
+  std::mt19937_64 random_;
+};
+}  // namespace tokenizer
+
+#endif  // RACKET_BRACKET_STACK_CORPUS_GENERATOR_H_
@@ -0,0 +1,149 @@
+// corpus_generator_test.cc --- Test code for the CorpusGenerator and
+// the parsing of its options.
+
+// corpus_generator_test is Copyright (C) 2014 by CPSC 221 at the
+// University of British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#include <gmock/gmock.h>
+using ::testing::Eq;
+using ::testing::Ge;
+using ::testing::Le;
+using ::testing::Lt;
+using ::testing::Ne;
+#include <gtest/gtest.h>
+using ::testing::Test;
+
+#include <algorithm>
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+#include "./balance_checker.h"
+#include "./corpus_generator.h"
+#include "./racket_tokenizer.h"
+
+namespace tokenizer {
+class CorpusGeneratorTest : public Test {
+ protected:
+  CorpusGeneratorTest() { }
+
+  virtual ~CorpusGeneratorTest() { }
+
+  static std::string generate(CorpusOptions const &options,
+                              std::uint64_t size) {
+    CorpusGenerator generator(options);
+    return generator.generate(size);
+  }
+
+  // The deepest the brackets in text nest, as a RacketTokenizer sees
+  // them (not counting quotation marks), or -1 if they don't balance.
+  static int nesting_depth(std::string const &text) {
+    std::stringstream stream(text);
+    RacketTokenizer tokenizer(stream, "corpus");
+    BalanceChecker checker(&tokenizer);
+    if (!checker.check_balance().is_eof())
+      return -1;
+
+    std::stringstream again(text);
+    RacketTokenizer depth_tokenizer(again, "corpus");
+    int depth = 0, max_depth = 0;
+    for (Token token = depth_tokenizer.next_token(); !token.is_eof();
+         token = depth_tokenizer.next_token()) {
+      if (token.type() == RacketTokenizer::kQuotationMark)
+        continue;
+      if (RacketTokenizer::is_opening_type(token.type()))
+        max_depth = std::max(max_depth, ++depth);
+      else if (RacketTokenizer::is_closing_type(token.type()))
+        --depth;
+    }
+    return max_depth;
+  }
+};
+
+TEST_F(CorpusGeneratorTest, SizeAndSeed) {
+  CorpusOptions options;
+  std::string text = generate(options, 20000);
+  EXPECT_THAT(text.size(), Ge(20000u));
+  EXPECT_THAT(text.size(), Lt(21000u));
+  EXPECT_THAT(generate(options, 20000), Eq(text));
+
+  options.seed++;
+  EXPECT_THAT(generate(options, 20000), Ne(text));
+  EXPECT_THAT(generate(options, 0), Eq(""));
+}
+
+TEST_F(CorpusGeneratorTest, BalancedWithinDepth) {
+  CorpusOptions options;
+  options.strings = 0.3;
+  options.escapes = 0.3;
+  options.comments = 0.3;
+  for (int max_depth : {1, 3, 16, 200}) {
+    options.max_depth = max_depth;
+    options.nesting = max_depth > 16 ? 0.9 : 0.3;
+    int depth = nesting_depth(generate(options, 50000));
+    EXPECT_THAT(depth, Ge(1)) << "max depth " << max_depth;
+    EXPECT_THAT(depth, Le(max_depth));
+  }
+  options.crlf = true;
+  EXPECT_THAT(nesting_depth(generate(options, 50000)), Ge(1));
+}
+
+TEST_F(CorpusGeneratorTest, LineEndings) {
+  CorpusOptions options;
+  options.comments = 0.5;
+  std::string text = generate(options, 20000);
+  EXPECT_THAT(text.find('\r'), Eq(std::string::npos));
+  EXPECT_THAT(text.find('\n'), Ne(std::string::npos));
+
+  options.crlf = true;
+  text = generate(options, 20000);
+  std::size_t newlines = std::count(text.begin(), text.end(), '\n');
+  EXPECT_THAT(newlines, Ge(1u));
+  EXPECT_THAT(text.find("\r\n"), Ne(std::string::npos));
+  for (std::size_t i = text.find('\n'); i != std::string::npos;
+       i = text.find('\n', i + 1))
+    EXPECT_THAT(text[i - 1], Eq('\r'));
+}
+
+TEST_F(CorpusGeneratorTest, NoStringsOrComments) {
+  CorpusOptions options;
+  options.strings = 0;
+  options.comments = 0;
+  std::string text = generate(options, 20000);
+  EXPECT_THAT(text.find_first_of("\";"), Eq(std::string::npos));
+
+  options.strings = 1;
+  options.string_length = 30;
+  text = generate(options, 20000);
+  EXPECT_THAT(std::count(text.begin(), text.end(), '"'), Ge(100));
+}
+
+TEST_F(CorpusGeneratorTest, ParseOptions) {
+  CorpusOptions options;
+  EXPECT_THAT(parse_corpus_option("--depth=100", &options), Eq(true));
+  EXPECT_THAT(options.max_depth, Eq(100));
+  EXPECT_THAT(parse_corpus_option("--strings=0.5", &options), Eq(true));
+  EXPECT_THAT(options.strings, Eq(0.5));
+  EXPECT_THAT(parse_corpus_option("--crlf", &options), Eq(true));
+  EXPECT_THAT(options.crlf, Eq(true));
+  EXPECT_THAT(parse_corpus_option("--seed=7", &options), Eq(true));
+  EXPECT_THAT(options.seed, Eq(7u));
+
+  EXPECT_THAT(parse_corpus_option("--strings=2", &options), Eq(false));
+  EXPECT_THAT(parse_corpus_option("--depth=0", &options), Eq(false));
+  EXPECT_THAT(parse_corpus_option("--depth=", &options), Eq(false));
+  EXPECT_THAT(parse_corpus_option("--colour=red", &options), Eq(false));
+  EXPECT_THAT(parse_corpus_option("depth=3", &options), Eq(false));
+
+  EXPECT_THAT(parse_corpus_size("4096"), Eq(4096u));
+  EXPECT_THAT(parse_corpus_size("64k"), Eq(64u << 10));
+  EXPECT_THAT(parse_corpus_size("16M"), Eq(16u << 20));
+  EXPECT_THAT(parse_corpus_size("1G"), Eq(1u << 30));
+  EXPECT_THAT(parse_corpus_size("many"), Eq(0u));
+  EXPECT_THAT(parse_corpus_size("12x"), Eq(0u));
+}
+}  // namespace tokenizer
@@ -0,0 +1,459 @@
+// delimiter_tokenizer.h --- Defines the DelimiterTokenizer template,
+// which makes a tokenizer for balance checking any language out of a
+// declarative spec of its brackets, strings and comments, with its
+// character table built at compile time.  Part of the
+// RackaBrackaStack project.
+
+// delimiter_tokenizer.h is Copyright (C) 2014 by the University of
+// British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#ifndef RACKET_BRACKET_STACK_DELIMITER_TOKENIZER_H_
+#define RACKET_BRACKET_STACK_DELIMITER_TOKENIZER_H_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <string>
+#include <vector>
+
+#include "./file_id.h"
+#include "./string_view.h"
+#include "./token.h"
+#include "./tokenizer.h"
+
+namespace tokenizer {
+// A spec is a type with these static constexpr members:
+//
+//   char kBrackets[]: pairs of opening and closing characters, e.g.
+//       "()[]{}".
+//   char kQuotes[]: characters that each open a string that only the
+//       same character closes, e.g. "\"'" (or "" for none).
+//   char kEscape: in a string, makes the next character just string
+//       data, e.g. '\\' (or '\0' for none).
+//   char const *kLineComments[]: what starts a comment running to the
+//       end of the line, e.g. {"//", nullptr} (or just {nullptr}).
+//   char const *kBlockComments[]: pairs of what starts and what ends
+//       a comment, e.g. {"/*", "*/", nullptr}.
+//
+// No character may be both a bracket and a quotation mark.  A comment
+// starter may begin with a bracket (as XML's "<!--" does); it's a
+// comment if the whole starter is there, else a bracket.
+//
+// Brackets and quotation marks make one token type each, numbered
+// from 1 in the order given, and nothing else makes tokens.  Comment
+// starters and ends and escapes are only recognized where the spec
+// says, so, e.g., "//" in a string is just string data.
+namespace delimiter_spec {
+// The length of the string s.
+constexpr std::size_t length(char const *s) {
+  return *s == '\0' ? 0 : 1 + length(s + 1);
+}
+
+// The index of c in s (before its terminating '\0'), or -1.
+constexpr int index_of(char const *s, char c, int i = 0) {
+  return s[i] == '\0' ? -1 : s[i] == c ? i : index_of(s, c, i + 1);
+}
+
+// Whether any string in the nullptr-terminated list (taking every
+// stride-th, from the first) starts with c.
+constexpr bool any_starts_with(char const *const *list, char c,
+                               int stride = 1) {
+  return *list != nullptr &&
+      ((*list)[0] == c || any_starts_with(list + stride, c, stride));
+}
+
+// The length of the longest string in the nullptr-terminated list.
+constexpr std::size_t longest(char const *const *list) {
+  return *list == nullptr ? 0 :
+      length(*list) > longest(list + 1) ? length(*list) : longest(list + 1);
+}
+
+// Whether any character is both in brackets and in quotes.
+constexpr bool overlap(char const *brackets, char const *quotes) {
+  return *brackets != '\0' &&
+      (index_of(quotes, *brackets) >= 0 || overlap(brackets + 1, quotes));
+}
+
+// The compile-time sequence 0, ..., N - 1.
+template <std::size_t... I> struct Indices { };
+template <std::size_t N, std::size_t... I>
+struct MakeIndices : MakeIndices<N - 1, N - 1, I...> { };
+template <std::size_t... I>
+struct MakeIndices<0, I...> {
+  typedef Indices<I...> type;
+};
+
+// What a character means outside strings and comments: the token
+// type it makes (0 for none) in the low bits, and flags.
+int const kTypeMask = 0x3F;
+int const kQuoteFlag = 0x40;
+int const kCommentFlag = 0x80;
+
+struct CodeTable {
+  unsigned char entries[256];
+};
+
+// The token type c makes in code, or 0 for none.
+template <typename Spec>
+constexpr int code_type(char c) {
+  return index_of(Spec::kBrackets, c) >= 0 ?
+      index_of(Spec::kBrackets, c) + 1 :
+      index_of(Spec::kQuotes, c) >= 0 ?
+      static_cast<int>(length(Spec::kBrackets)) +
+      index_of(Spec::kQuotes, c) + 1 :
+      0;
+}
+
+template <typename Spec>
+constexpr unsigned char code_entry(char c) {
+  return static_cast<unsigned char>(
+      code_type<Spec>(c) |
+      (c != '\0' && index_of(Spec::kQuotes, c) >= 0 ? kQuoteFlag : 0) |
+      (c != '\0' && (any_starts_with(Spec::kLineComments, c) ||
+                     any_starts_with(Spec::kBlockComments, c, 2)) ?
+       kCommentFlag : 0));
+}
+
+template <typename Spec, std::size_t... I>
+constexpr CodeTable make_code_table(Indices<I...>) {
+  return CodeTable{{code_entry<Spec>(static_cast<char>(I))...}};
+}
+
+// Every character, for tokens' data to view.
+struct CharacterTable {
+  char characters[256];
+};
+
+template <std::size_t... I>
+constexpr CharacterTable make_character_table(Indices<I...>) {
+  return CharacterTable{{static_cast<char>(I)...}};
+}
+
+extern CharacterTable const kCharacters;
+}  // namespace delimiter_spec
+
+// Produces a token for each bracket and quotation mark outside
+// comments (and each quotation mark ending a string), as
+// BracketTokenizer does for Racket and with the same care: it jumps
+// from one character that matters to the next, with one lookup in a
+// table per character in code, and memchr through strings and
+// comments.  It reads its input a block at a time, keeping the end of
+// a block when a comment's starter or end might straddle the next.
+template <typename Spec>
+class DelimiterTokenizer final : public Tokenizer {
+ public:
+  // Constructs a tokenizer that will report itself as reading a
+  // file with no name (empty string).
+  explicit DelimiterTokenizer(std::istream &in)
+      : DelimiterTokenizer(in, "") { }
+
+  // Constructs a tokenizer that will report itself as reading the
+  // given file and reads its input block_size (> 0) characters at a
+  // time.
+  DelimiterTokenizer(std::istream &in, std::string const &filename,
+                     std::size_t block_size = kDefaultBlockSize)
+      : in_(in), file_id_(intern_filename(filename)),
+        buffer_(block_size + kMaxLookahead),
+        pos_(buffer_.data()), end_(buffer_.data()),
+        scanned_(buffer_.data()) {
+    assert(block_size > 0);
+  }
+
+  DelimiterTokenizer(DelimiterTokenizer const &) = delete;
+  DelimiterTokenizer &operator=(DelimiterTokenizer const &) = delete;
+
+  virtual Token next_token();
+
+  virtual bool are_matching(Token const & opener, Token const & closer) const {
+    return are_matching_types(opener.type(), closer.type());
+  }
+
+  virtual bool is_opening(Token const & token) const {
+    return is_opening_type(token.type());
+  }
+
+  virtual bool is_closing(Token const & token) const {
+    return is_closing_type(token.type());
+  }
+
+  virtual bool classifies_by_type() const {
+    return true;
+  }
+
+  // The above, by token type.
+  static bool are_matching_types(int opener, int closer) {
+    return is_opening_type(opener) &&
+        (opener > kNumBracketTypes ? closer == opener : closer == opener + 1);
+  }
+  static bool is_opening_type(int type) {
+    return type > kNumBracketTypes ? type <= kNumTypes : type % 2 == 1;
+  }
+  static bool is_closing_type(int type) {
+    return type > kNumBracketTypes ? type <= kNumTypes :
+        type > 0 && type % 2 == 0;
+  }
+
+  static std::size_t const kDefaultBlockSize = 1 << 16;
+
+ private:
+  static int const kNumBracketTypes =
+      static_cast<int>(delimiter_spec::length(Spec::kBrackets));
+  static int const kNumTypes = kNumBracketTypes +
+      static_cast<int>(delimiter_spec::length(Spec::kQuotes));
+  static std::size_t const kMaxLookahead =
+      delimiter_spec::longest(Spec::kLineComments) >
+      delimiter_spec::longest(Spec::kBlockComments) ?
+      delimiter_spec::longest(Spec::kLineComments) :
+      delimiter_spec::longest(Spec::kBlockComments);
+
+  static_assert(kNumBracketTypes % 2 == 0,
+                "brackets must come in opening and closing pairs");
+  static_assert(kNumTypes <= delimiter_spec::kTypeMask,
+                "too many brackets and quotation marks");
+  static_assert(!delimiter_spec::overlap(Spec::kBrackets, Spec::kQuotes),
+                "no character may be both a bracket and a quotation mark");
+
+  static constexpr delimiter_spec::CodeTable kCodeTable =
+      delimiter_spec::make_code_table<Spec>(
+          typename delimiter_spec::MakeIndices<256>::type());
+
+  enum ScannerState {
+    kInCode,
+    kInString,
+    kInLineComment,
+    kInBlockComment
+  };
+
+  // If a comment starts at pos_, moves past its starter into it and
+  // returns true.
+  bool start_comment();
+
+  // Whether s is next in the input, from pos_.
+  bool looking_at(char const *s);
+
+  // Produces the token for the structural character at position (in
+  // the current block).
+  Token make_token(char const *position);
+
+  // Advances line_ and column_ from scanned_ to position (in the
+  // current block).
+  void advance_to(char const *position);
+
+  // Reads more input after what's left of the current block (from
+  // pos_), moving that to the start of the buffer.  Returns false at
+  // the end of the input.
+  bool refill_buffer();
+
+  std::istream &in_;
+  FileId file_id_;
+
+  // The current block of input: pos_ is the next character to scan,
+  // and end_ is just past the last character read.
+  std::vector<char> buffer_;
+  char const *pos_;
+  char const *end_;
+
+  ScannerState state_ = kInCode;
+  char quote_ = '\0';           // What ends the current string.
+  bool escaped_ = false;        // In a string, just after an escape.
+  // In a string, the first quote_ at or after pos_ in the current
+  // block, or end_ if there is none.  (nullptr, or anything before
+  // pos_, means it has yet to be found.)
+  char const *string_end_ = nullptr;
+  char const *comment_end_ = nullptr;  // What ends the block comment.
+
+  // The position (line, column and offset) of scanned_, up to which
+  // lines have been counted.
+  char const *scanned_;
+  int line_ = 1;
+  int column_ = 1;
+  std::uint64_t block_offset_ = 0;
+};
+
+template <typename Spec>
+constexpr delimiter_spec::CodeTable DelimiterTokenizer<Spec>::kCodeTable;
+template <typename Spec>
+std::size_t const DelimiterTokenizer<Spec>::kDefaultBlockSize;
+template <typename Spec>
+int const DelimiterTokenizer<Spec>::kNumBracketTypes;
+template <typename Spec>
+int const DelimiterTokenizer<Spec>::kNumTypes;
+template <typename Spec>
+std::size_t const DelimiterTokenizer<Spec>::kMaxLookahead;
+
+template <typename Spec>
+Token DelimiterTokenizer<Spec>::next_token() {
+  for (;;) {
+    if (pos_ == end_ && !refill_buffer()) {
+      // EOF sits just past the last character.
+      return Token(Token::kEofToken, StringView(), nullptr, nullptr,
+                   file_id_, line_, line_, column_, column_,
+                   block_offset_ + (end_ - buffer_.data()));
+    }
+
+    switch (state_) {
+      case kInCode: {
+        char const *position = pos_;
+        while (position != end_ &&
+               kCodeTable.entries[static_cast<unsigned char>(*position)] == 0)
+          ++position;
+        pos_ = position;
+        if (position == end_)
+          break;
+
+        int entry = kCodeTable.entries[static_cast<unsigned char>(*position)];
+        if ((entry & delimiter_spec::kCommentFlag) != 0 && start_comment())
+          break;
+        // (Looking for a comment may have moved the block.)
+        position = pos_++;
+        if ((entry & delimiter_spec::kQuoteFlag) != 0) {
+          state_ = kInString;
+          quote_ = *position;
+        }
+        if ((entry & delimiter_spec::kTypeMask) != 0)
+          return make_token(position);
+        break;
+      }
+      case kInString: {
+        if (escaped_) {
+          // Whatever follows an escape is just string data.
+          ++pos_;
+          escaped_ = false;
+          break;
+        }
+        // As in BracketTokenizer, find the block's next closing quote
+        // only once pos_ has passed the last one found, not after
+        // every escape.
+        if (string_end_ == nullptr || string_end_ < pos_) {
+          string_end_ = static_cast<char const *>(
+              std::memchr(pos_, quote_, end_ - pos_));
+          if (string_end_ == nullptr)
+            string_end_ = end_;
+        }
+        char const *escape = Spec::kEscape == '\0' ? nullptr :
+            static_cast<char const *>(
+                std::memchr(pos_, Spec::kEscape, string_end_ - pos_));
+        if (escape != nullptr) {
+          pos_ = escape + 1;
+          escaped_ = true;
+        } else if (string_end_ != end_) {
+          pos_ = string_end_ + 1;
+          state_ = kInCode;
+          return make_token(string_end_);
+        } else {
+          pos_ = end_;
+        }
+        break;
+      }
+      case kInLineComment: {
+        // The comment ends at the end of the line.
+        char const *newline = static_cast<char const *>(
+            std::memchr(pos_, '\n', end_ - pos_));
+        if (newline != nullptr) {
+          pos_ = newline + 1;
+          state_ = kInCode;
+        } else {
+          pos_ = end_;
+        }
+        break;
+      }
+      case kInBlockComment: {
+        char const *candidate = static_cast<char const *>(
+            std::memchr(pos_, comment_end_[0], end_ - pos_));
+        if (candidate == nullptr) {
+          pos_ = end_;
+          break;
+        }
+        pos_ = candidate;
+        if (looking_at(comment_end_)) {
+          pos_ += delimiter_spec::length(comment_end_);
+          state_ = kInCode;
+        } else {
+          ++pos_;
+        }
+        break;
+      }
+    }
+  }
+}
+
+template <typename Spec>
+bool DelimiterTokenizer<Spec>::start_comment() {
+  for (char const *const *starter = Spec::kLineComments; *starter != nullptr;
+       ++starter) {
+    if (looking_at(*starter)) {
+      pos_ += delimiter_spec::length(*starter);
+      state_ = kInLineComment;
+      return true;
+    }
+  }
+  for (char const *const *starter = Spec::kBlockComments;
+       *starter != nullptr; starter += 2) {
+    if (looking_at(*starter)) {
+      pos_ += delimiter_spec::length(*starter);
+      comment_end_ = starter[1];
+      state_ = kInBlockComment;
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename Spec>
+bool DelimiterTokenizer<Spec>::looking_at(char const *s) {
+  std::size_t length = delimiter_spec::length(s);
+  while (static_cast<std::size_t>(end_ - pos_) < length) {
+    if (!refill_buffer())
+      return false;
+  }
+  return std::memcmp(pos_, s, length) == 0;
+}
+
+template <typename Spec>
+Token DelimiterTokenizer<Spec>::make_token(char const *position) {
+  advance_to(position);
+  unsigned char c = static_cast<unsigned char>(*position);
+  return Token(kCodeTable.entries[c] & delimiter_spec::kTypeMask,
+               StringView(&delimiter_spec::kCharacters.characters[c], 1), nullptr,
+               nullptr, file_id_, line_, line_, column_, column_ + 1,
+               block_offset_ + (position - buffer_.data()));
+}
+
+template <typename Spec>
+void DelimiterTokenizer<Spec>::advance_to(char const *position) {
+  char const *newline;
+  while (scanned_ < position &&
+         (newline = static_cast<char const *>(
+             std::memchr(scanned_, '\n', position - scanned_))) != nullptr) {
+    line_++;
+    column_ = 1;
+    scanned_ = newline + 1;
+  }
+  column_ += position - scanned_;
+  scanned_ = position;
+}
+
+template <typename Spec>
+bool DelimiterTokenizer<Spec>::refill_buffer() {
+  // Count the lines up to pos_ before the block moves.
+  advance_to(pos_);
+  std::size_t kept = end_ - pos_;
+  assert(kept < kMaxLookahead || kept == 0);
+  block_offset_ += pos_ - buffer_.data();
+  std::memmove(buffer_.data(), pos_, kept);
+
+  in_.read(buffer_.data() + kept, buffer_.size() - kept);
+  pos_ = scanned_ = buffer_.data();
+  end_ = pos_ + kept + in_.gcount();
+  string_end_ = nullptr;
+  return in_.gcount() > 0;
+}
+}  // namespace tokenizer
+
+#endif  // RACKET_BRACKET_STACK_DELIMITER_TOKENIZER_H_
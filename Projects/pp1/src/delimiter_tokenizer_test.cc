@@ -0,0 +1,173 @@
+// delimiter_tokenizer_test.cc --- Test code for the DelimiterTokenizer
+// template and the language specs in language_tokenizers.h.
+
+// delimiter_tokenizer_test is Copyright (C) 2014 by CPSC 221 at the
+// University of British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#include <gmock/gmock.h>
+using ::testing::Eq;
+#include <gtest/gtest.h>
+using ::testing::Test;
+
+#include <random>
+#include <sstream>
+#include <string>
+
+#include "./balance_checker.h"
+#include "./basic_balance_checker.h"
+#include "./bracket_tokenizer.h"
+#include "./language_tokenizers.h"
+#include "./small_token_stack.h"
+#include "./tokenizer_test_util.h"
+
+namespace tokenizer {
+class DelimiterTokenizerTest : public Test {
+ protected:
+  DelimiterTokenizerTest() { }
+
+  virtual ~DelimiterTokenizerTest() { }
+
+  // Checks text's balance with a TokenizerT reading it block_size
+  // characters at a time.  Returns "" if it balances, else the
+  // offending token's data, line and column, as "]@2:5".
+  template <typename TokenizerT>
+  static std::string check(std::string const &text,
+                           std::size_t block_size = 1 << 16) {
+    std::stringstream stream(text);
+    TokenizerT tokenizer(stream, "file", block_size);
+    BasicBalanceChecker<TokenizerT, SmallTokenStack> checker(&tokenizer);
+    Token token = checker.check_balance();
+    if (token.is_eof())
+      return "";
+    return token.data() + "@" + std::to_string(token.start_line()) + ":" +
+        std::to_string(token.start_column());
+  }
+
+  // Checks that TokenizerT gives the same answer for text however
+  // many characters it reads at a time, and returns that answer.
+  template <typename TokenizerT>
+  static std::string check_all_block_sizes(std::string const &text) {
+    std::string expected = check<TokenizerT>(text);
+    for (std::size_t block_size = 1; block_size <= 12; ++block_size)
+      EXPECT_THAT(check<TokenizerT>(text, block_size), Eq(expected))
+          << "in: " << text << ", block size " << block_size;
+    return expected;
+  }
+};
+
+TEST_F(DelimiterTokenizerTest, EmptyFile) {
+  std::stringstream stream("");
+  JsonTokenizer tokenizer(stream);
+  EXPECT_TRUE(tokenizer.next_token().is_eof());
+  EXPECT_TRUE(tokenizer.next_token().is_eof());
+}
+
+TEST_F(DelimiterTokenizerTest, TypesFollowTheSpec) {
+  std::stringstream stream("a{[\"x]\"]}'");
+  CLikeTokenizer tokenizer(stream);
+  std::string data;
+  for (Token token = tokenizer.next_token(); !token.is_eof();
+       token = tokenizer.next_token())
+    data += token.data() + std::to_string(token.type());
+  // ()[]{} are 1 to 6, and " and ' are 7 and 8.
+  EXPECT_THAT(data, Eq("{5[3\"7\"7]4}6'8"));
+
+  EXPECT_TRUE(CLikeTokenizer::are_matching_types(1, 2));
+  EXPECT_TRUE(CLikeTokenizer::are_matching_types(7, 7));
+  EXPECT_FALSE(CLikeTokenizer::are_matching_types(2, 1));
+  EXPECT_FALSE(CLikeTokenizer::are_matching_types(7, 8));
+  EXPECT_TRUE(CLikeTokenizer::is_opening_type(8));
+  EXPECT_TRUE(CLikeTokenizer::is_closing_type(8));
+  EXPECT_FALSE(CLikeTokenizer::is_opening_type(9));
+  EXPECT_FALSE(CLikeTokenizer::is_closing_type(Token::kEofToken));
+  EXPECT_TRUE(XmlTokenizer::is_opening_type(1));
+  EXPECT_FALSE(XmlTokenizer::is_opening_type(3));
+}
+
+TEST_F(DelimiterTokenizerTest, SameTokensAsBracketTokenizer) {
+  std::default_random_engine random(221);
+  for (int i = 0; i < 300; ++i) {
+    std::string text = random_text(&random, 200);
+    std::stringstream bracket_stream(text), delimiter_stream(text);
+    BracketTokenizer brackets(bracket_stream, "file", 1 + random() % 16);
+    RacketDelimiterTokenizer delimiters(delimiter_stream, "file",
+                                        1 + random() % 16);
+    bool at_eof = false;
+    while (!at_eof) {
+      Token expected = brackets.next_token();
+      Token token = delimiters.next_token();
+      // (The two number their types differently.)
+      EXPECT_THAT(token.data(), Eq(expected.data())) << "in: " << text;
+      EXPECT_THAT(token.is_eof(), Eq(expected.is_eof()));
+      expect_same_position(token, expected, text);
+      at_eof = expected.is_eof() || token.is_eof();
+    }
+  }
+}
+
+TEST_F(DelimiterTokenizerTest, Json) {
+  EXPECT_THAT(check_all_block_sizes<JsonTokenizer>(
+      "{\"a\": [1, {\"b]\": \"\\\"}\"}], \"c\": {}}"), Eq(""));
+  EXPECT_THAT(check_all_block_sizes<JsonTokenizer>(
+      "{\"a\": [1, 2}\n"), Eq("}@1:12"));
+  EXPECT_THAT(check_all_block_sizes<JsonTokenizer>(
+      "[\n  {\"a\": \"(\"\n"), Eq("{@2:3"));
+  // Parentheses are just text in JSON.
+  EXPECT_THAT(check<JsonTokenizer>("[(]"), Eq(""));
+}
+
+TEST_F(DelimiterTokenizerTest, CLike) {
+  EXPECT_THAT(check_all_block_sizes<CLikeTokenizer>(
+      "int f(int x) {  // }\n"
+      "  /* { ( */ return x['}'] + \"/*\"[0] + '\\'';\n"
+      "}\n"), Eq(""));
+  EXPECT_THAT(check_all_block_sizes<CLikeTokenizer>(
+      "void g() { h(1, 2]; }"), Eq("]@1:18"));
+  EXPECT_THAT(check_all_block_sizes<CLikeTokenizer>(
+      "a[/* ] */ 1 /* ] */ ] / 2 /* ( */"), Eq(""));
+  EXPECT_THAT(check_all_block_sizes<CLikeTokenizer>(
+      "f(/* unterminated )"), Eq("(@1:2"));
+  EXPECT_THAT(check_all_block_sizes<CLikeTokenizer>("x = 'a"), Eq("'@1:5"));
+  // A lone slash starts no comment.
+  EXPECT_THAT(check_all_block_sizes<CLikeTokenizer>("(a / b)/"), Eq(""));
+}
+
+TEST_F(DelimiterTokenizerTest, Xml) {
+  EXPECT_THAT(check_all_block_sizes<XmlTokenizer>(
+      "<?xml version=\"1.0\"?>\n"
+      "<a href='x'><!-- <<b> --><![CDATA[ <>> ]]>it's</a>\n"), Eq(""));
+  EXPECT_THAT(check_all_block_sizes<XmlTokenizer>(
+      "<a><b</a>"), Eq("<@1:4"));
+  EXPECT_THAT(check_all_block_sizes<XmlTokenizer>(
+      "<a>\n<!-- -- > -->>"), Eq(">@2:14"));
+  EXPECT_THAT(check_all_block_sizes<XmlTokenizer>(
+      "<a <!-- never closed >"), Eq("<@1:1"));
+  // Almost a comment, and so a bracket.
+  EXPECT_THAT(check_all_block_sizes<XmlTokenizer>("<!- ->"), Eq(""));
+}
+
+// A 4 MB string of nothing but escapes is scanned in one pass over
+// each block, not one (looking for its end) per escape.
+TEST_F(DelimiterTokenizerTest, EscapeHeavyString) {
+  std::string escapes;
+  for (int i = 0; i < 2 * 1024 * 1024; ++i)
+    escapes += "\\n";
+  std::string const text = "[\"" + escapes + "\"}";
+  EXPECT_THAT(check<JsonTokenizer>(text),
+              Eq("}@1:" + std::to_string(escapes.size() + 4)));
+  EXPECT_THAT(check<CLikeTokenizer>("(\"" + escapes + "\")"), Eq(""));
+}
+
+TEST_F(DelimiterTokenizerTest, WorksWithBalanceChecker) {
+  std::stringstream stream("{\"a\": [1, 2}");
+  JsonTokenizer tokenizer(stream);
+  BalanceChecker checker(&tokenizer);
+  Token token = checker.check_balance();
+  EXPECT_THAT(token.data(), Eq("}"));
+  EXPECT_THAT(token.start_column(), Eq(12));
+}
+}  // namespace tokenizer
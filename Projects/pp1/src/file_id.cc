@@ -0,0 +1,57 @@
+// file_id.cc --- Defines the table of interned filenames behind
+// FileIds.
+
+// file_id.cc is Copyright (C) 2014 by the University of British
+// Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+
+#include "./file_id.h"
+
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+// The interned filenames, indexed by id.  (A deque never moves its
+// elements, so references to them stay valid as it grows.)
+struct FilenameTable {
+  FilenameTable() : filenames(1, "") { }
+
+  std::mutex mutex;
+  std::deque<std::string> filenames;
+  std::unordered_map<std::string, tokenizer::FileId> ids;
+};
+
+FilenameTable &filename_table() {
+  static FilenameTable table;
+  return table;
+}
+}  // namespace
+
+namespace tokenizer {
+FileId intern_filename(std::string const &filename) {
+  if (filename.empty())
+    return kNoFileId;
+
+  FilenameTable &table = filename_table();
+  std::lock_guard<std::mutex> lock(table.mutex);
+  auto found = table.ids.find(filename);
+  if (found != table.ids.end())
+    return found->second;
+
+  FileId id = static_cast<FileId>(table.filenames.size());
+  table.filenames.push_back(filename);
+  table.ids.insert(std::make_pair(filename, id));
+  return id;
+}
+
+std::string const &filename_of(FileId id) {
+  FilenameTable &table = filename_table();
+  std::lock_guard<std::mutex> lock(table.mutex);
+  return table.filenames[id];
+}
+}  // namespace tokenizer
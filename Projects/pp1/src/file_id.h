@@ -0,0 +1,35 @@
+// file_id.h --- Declares FileIds, small numbers standing for the
+// names of the files tokens come from, so that tokens need not each
+// carry a copy of their file's name.  Part of the RackaBrackaStack
+// project.
+
+// file_id.h is Copyright (C) 2014 by the University of British
+// Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#ifndef RACKET_BRACKET_STACK_FILE_ID_H_
+#define RACKET_BRACKET_STACK_FILE_ID_H_
+
+#include <cstdint>
+#include <string>
+
+namespace tokenizer {
+typedef std::uint32_t FileId;
+
+// The id of the empty filename (i.e., no file).
+FileId const kNoFileId = 0;
+
+// Returns the id of the given filename, the same one every time it
+// is asked for (from any thread).  Ids are never released.
+FileId intern_filename(std::string const &filename);
+
+// Returns the filename with the given id (which must have come from
+// intern_filename).  The reference stays valid for the life of the
+// program.
+std::string const &filename_of(FileId id);
+}  // namespace tokenizer
+
+#endif  // RACKET_BRACKET_STACK_FILE_ID_H_
@@ -0,0 +1,293 @@
+// incremental_balance_checker.cc --- Defines the
+// IncrementalBalanceChecker, which re-lexes only the blocks an edit
+// touches and recombines their summaries up a segment tree.
+
+// incremental_balance_checker.cc is Copyright (C) 2014 by the
+// University of British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+
+#include "./incremental_balance_checker.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "./racket_tokenizer.h"
+
+namespace tokenizer {
+typedef RacketTokenizer RT;
+
+std::size_t const IncrementalBalanceChecker::kDefaultBlockSize;
+
+IncrementalBalanceChecker::IncrementalBalanceChecker(
+    std::string const &text, std::string const &filename,
+    std::size_t block_size)
+    : file_id_(intern_filename(filename)),
+      block_size_(block_size > 0 ? block_size : 1),
+      blocks_(split(text)) {
+  std::vector<Node> leaves;
+  for (std::string const &block : blocks_)
+    leaves.push_back(summarize_block(block));
+  build(&leaves);
+}
+
+void IncrementalBalanceChecker::edit(std::size_t offset, std::size_t length,
+                                     std::string const &replacement) {
+  offset = std::min(offset, size());
+  length = std::min(length, size() - offset);
+
+  // The edited text runs from the start of the block the edit starts
+  // in through the end of the block it ends in, which ends just after
+  // a newline (or the text), as the block before the first does.
+  std::size_t first_start, last_start;
+  std::size_t first = find_block(offset, &first_start);
+  std::size_t last = find_block(offset + length, &last_start);
+  std::string edited = blocks_[first].substr(0, offset - first_start) +
+      replacement + blocks_[last].substr(offset + length - last_start);
+  std::vector<std::string> new_blocks = split(edited);
+
+  if (new_blocks.size() == last - first + 1) {
+    // The usual case: re-lex the edited blocks and recombine only
+    // their ancestors.
+    for (std::size_t i = 0; i < new_blocks.size(); ++i) {
+      blocks_[first + i].swap(new_blocks[i]);
+      std::size_t node = leaf_base_ + first + i;
+      tree_[node] = summarize_block(blocks_[first + i]);
+      for (node /= 2; node > 0; node /= 2)
+        update(node);
+    }
+    return;
+  }
+
+  // Otherwise, the blocks after the edit move; keep their summaries
+  // (whose offsets are relative to their blocks) but rebuild the
+  // tree above them.
+  std::vector<Node> leaves(tree_.begin() + leaf_base_,
+                           tree_.begin() + leaf_base_ + blocks_.size());
+  std::vector<Node> new_leaves;
+  for (std::string const &block : new_blocks)
+    new_leaves.push_back(summarize_block(block));
+  leaves.erase(leaves.begin() + first, leaves.begin() + last + 1);
+  leaves.insert(leaves.begin() + first, new_leaves.begin(), new_leaves.end());
+  blocks_.erase(blocks_.begin() + first, blocks_.begin() + last + 1);
+  blocks_.insert(blocks_.begin() + first, new_blocks.begin(),
+                 new_blocks.end());
+  build(&leaves);
+}
+
+Token IncrementalBalanceChecker::check_balance() const {
+  // The whole text starts outside of any string.  Anything it leaves
+  // unmatched is an imbalance: the first closer with nothing to
+  // match, else the first closer that doesn't match, else the
+  // innermost opener.
+  Summary const &summary = tree_[1].summaries[0];
+  Bracket const *bracket = nullptr;
+  if (!summary.closers.empty())
+    bracket = &summary.closers.front();
+  else if (summary.has_mismatch)
+    bracket = &summary.mismatch;
+  else if (!summary.openers.empty())
+    bracket = &summary.openers.back();
+
+  if (bracket == nullptr)
+    return make_token(size(), RT::kEof, StringView());
+  return make_token(bracket->offset, RT::structural_type(bracket->c),
+                    RT::structural_data(bracket->c));
+}
+
+std::string IncrementalBalanceChecker::text() const {
+  std::string text;
+  text.reserve(size());
+  for (std::string const &block : blocks_)
+    text += block;
+  return text;
+}
+
+IncrementalBalanceChecker::Node
+IncrementalBalanceChecker::summarize_block(std::string const &block) const {
+  Node node;
+  node.summaries[0] = summarize(block, false);
+  node.summaries[1] = summarize(block, true);
+  node.size = block.size();
+  node.newlines = std::count(block.begin(), block.end(), '\n');
+  return node;
+}
+
+IncrementalBalanceChecker::Summary
+IncrementalBalanceChecker::summarize(std::string const &text,
+                                     bool starts_in_string) {
+  // A RacketTokenizer always starts outside of any string; so, to
+  // start in one, it's given an opening quotation mark first.
+  std::string const quoted = starts_in_string ? "\"" + text : "";
+  std::string const &input = starts_in_string ? quoted : text;
+  std::size_t const skipped = starts_in_string ? 1 : 0;
+  RacketTokenizer tokenizer(input.data(), input.data() + input.size(), "");
+
+  // Nothing comes between a string's quotation marks; so, a quotation
+  // mark in a string closes it and must match the top of the stack.
+  Summary summary;
+  bool in_string = false;
+  for (Token token = tokenizer.next_token(); !token.is_eof();
+       token = tokenizer.next_token()) {
+    int type = token.type();
+    if (!RT::is_opening_type(type) && !RT::is_closing_type(type))
+      continue;
+    bool closing = type == RT::kQuotationMark ?
+        in_string : RT::is_closing_type(type);
+    if (type == RT::kQuotationMark)
+      in_string = !in_string;
+    if (token.offset() < skipped || summary.has_mismatch)
+      continue;
+
+    Bracket bracket;
+    bracket.offset = token.offset() - skipped;
+    bracket.c = input[token.offset()];
+    if (!closing) {
+      summary.openers.push_back(bracket);
+    } else if (summary.openers.empty()) {
+      summary.closers.push_back(bracket);
+    } else if (RT::are_matching_types(
+        RT::structural_type(summary.openers.back().c), type)) {
+      summary.openers.pop_back();
+    } else {
+      summary.has_mismatch = true;
+      summary.mismatch = bracket;
+      summary.openers.clear();
+    }
+  }
+  summary.ends_in_string = in_string;
+  return summary;
+}
+
+IncrementalBalanceChecker::Summary
+IncrementalBalanceChecker::combine(Summary const &first,
+                                   Summary const &second,
+                                   std::size_t offset) {
+  Summary summary = first;
+  summary.ends_in_string = second.ends_in_string;
+  if (first.has_mismatch)
+    return summary;
+
+  for (Bracket closer : second.closers) {
+    closer.offset += offset;
+    if (summary.openers.empty()) {
+      summary.closers.push_back(closer);
+    } else if (RT::are_matching_types(
+        RT::structural_type(summary.openers.back().c),
+        RT::structural_type(closer.c))) {
+      summary.openers.pop_back();
+    } else {
+      summary.has_mismatch = true;
+      summary.mismatch = closer;
+      summary.openers.clear();
+      return summary;
+    }
+  }
+
+  if (second.has_mismatch) {
+    summary.has_mismatch = true;
+    summary.mismatch = second.mismatch;
+    summary.mismatch.offset += offset;
+    summary.openers.clear();
+    return summary;
+  }
+  for (Bracket opener : second.openers) {
+    opener.offset += offset;
+    summary.openers.push_back(opener);
+  }
+  return summary;
+}
+
+void IncrementalBalanceChecker::update(std::size_t node) {
+  Node const &left = tree_[2 * node];
+  Node const &right = tree_[2 * node + 1];
+  for (int state = 0; state < 2; ++state) {
+    Summary const &first = left.summaries[state];
+    tree_[node].summaries[state] =
+        combine(first, right.summaries[first.ends_in_string], left.size);
+  }
+  tree_[node].size = left.size + right.size;
+  tree_[node].newlines = left.newlines + right.newlines;
+}
+
+void IncrementalBalanceChecker::build(std::vector<Node> *leaves) {
+  leaf_base_ = 1;
+  while (leaf_base_ < leaves->size())
+    leaf_base_ *= 2;
+
+  // Padding leaves are empty text, which ends in the state it starts
+  // in.
+  tree_.assign(2 * leaf_base_, Node());
+  for (std::size_t i = 0; i < leaf_base_; ++i) {
+    if (i < leaves->size())
+      tree_[leaf_base_ + i] = std::move((*leaves)[i]);
+    else
+      tree_[leaf_base_ + i].summaries[1].ends_in_string = true;
+  }
+  for (std::size_t node = leaf_base_ - 1; node > 0; --node)
+    update(node);
+}
+
+std::vector<std::string>
+IncrementalBalanceChecker::split(std::string const &text) const {
+  std::vector<std::string> blocks;
+  std::size_t start = 0;
+  while (start < text.size()) {
+    std::size_t newline = text.find('\n', start + block_size_ - 1);
+    std::size_t end = newline == std::string::npos ? text.size() : newline + 1;
+    blocks.push_back(text.substr(start, end - start));
+    start = end;
+  }
+  if (blocks.empty())
+    blocks.push_back("");
+  return blocks;
+}
+
+std::size_t IncrementalBalanceChecker::find_block(
+    std::size_t offset, std::size_t *block_start) const {
+  // Descend to the leaf whose text contains offset.
+  std::size_t node = 1;
+  *block_start = 0;
+  while (node < leaf_base_) {
+    std::size_t left_size = tree_[2 * node].size;
+    if (offset < *block_start + left_size ||
+        tree_[2 * node + 1].size == 0) {
+      node = 2 * node;
+    } else {
+      *block_start += left_size;
+      node = 2 * node + 1;
+    }
+  }
+  return std::min(node - leaf_base_, blocks_.size() - 1);
+}
+
+Token IncrementalBalanceChecker::make_token(std::size_t offset, int type,
+                                            StringView data) const {
+  // Lines end at the newlines in the blocks before this one and in
+  // this one before offset.
+  std::size_t block_start;
+  std::size_t block = find_block(offset, &block_start);
+  std::size_t line = 1;
+  for (std::size_t node = leaf_base_ + block; node > 1; node /= 2) {
+    if (node % 2 == 1)
+      line += tree_[node - 1].newlines;
+  }
+  std::string const &text = blocks_[block];
+  std::size_t local = offset - block_start;
+  std::size_t line_start = 0;   // Every block starts a line.
+  for (std::size_t i = 0; i < local; ++i) {
+    if (text[i] == '\n') {
+      line++;
+      line_start = i + 1;
+    }
+  }
+
+  int column = static_cast<int>(local - line_start) + 1;
+  return Token(type, data, nullptr, nullptr, file_id_,
+               static_cast<int>(line), static_cast<int>(line),
+               column, column + static_cast<int>(data.size()), offset);
+}
+}  // namespace tokenizer
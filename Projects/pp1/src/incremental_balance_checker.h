@@ -0,0 +1,137 @@
+// incremental_balance_checker.h --- Declares the
+// IncrementalBalanceChecker, which keeps the bracket balance of a
+// Racket program up to date as it is edited (e.g., in an editor).
+// Part of the RackaBrackaStack project.
+
+// incremental_balance_checker.h is Copyright (C) 2014 by the
+// University of British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#ifndef RACKET_BRACKET_STACK_INCREMENTAL_BALANCE_CHECKER_H_
+#define RACKET_BRACKET_STACK_INCREMENTAL_BALANCE_CHECKER_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "./file_id.h"
+#include "./token.h"
+
+namespace tokenizer {
+// Holds the text of a Racket program in blocks (each ending just
+// after a newline, so that none starts inside a comment) and a
+// segment tree of the blocks' bracket summaries.  A summary is what's
+// left of some text once the brackets matched within it are removed
+// (as in ParallelBalanceChecker): closers that must match earlier
+// openers, the first closer that can't, and openers left for later
+// text.  Summaries combine left to right; so, after an edit, only the
+// edited blocks are re-lexed (by a RacketTokenizer) and only the
+// summaries on their paths to the root are recombined.  The root's
+// summary gives the answer.
+//
+// Since a block may start inside a string, each summary is kept for
+// both starting states, along with the state it ends in.
+//
+// Combining summaries takes time proportional to the brackets left
+// unmatched in them, which is usually about the nesting depth.
+class IncrementalBalanceChecker {
+ public:
+  // Constructs a checker of text that will report tokens as coming
+  // from the given file, keeping blocks of about block_size
+  // characters (or one line, if that's longer).
+  explicit IncrementalBalanceChecker(std::string const &text,
+                                     std::string const &filename = "",
+                                     std::size_t block_size =
+                                     kDefaultBlockSize);
+
+  // Replaces the length characters at offset with replacement.
+  // (offset and length are clipped to the text.)
+  void edit(std::size_t offset, std::size_t length,
+            std::string const &replacement);
+
+  // Returns what BalanceChecker::check_balance would for the current
+  // text with a RacketTokenizer: the first closing token that does
+  // not match, else the innermost opening token never closed, else
+  // the EOF token.
+  Token check_balance() const;
+
+  // The current text (assembled from the blocks).
+  std::string text() const;
+
+  std::size_t size() const {
+    return tree_[1].size;
+  }
+
+  static std::size_t const kDefaultBlockSize = 4096;
+
+ private:
+  // A structural character left unmatched, by its offset from the
+  // start of the summarized text.
+  struct Bracket {
+    std::size_t offset;
+    char c;
+  };
+
+  // What's left of some text, starting in a known state, once
+  // brackets matched within it are removed.
+  struct Summary {
+    std::vector<Bracket> closers;
+    bool has_mismatch = false;
+    Bracket mismatch;
+    std::vector<Bracket> openers;   // Innermost last; only if no mismatch.
+    bool ends_in_string = false;
+  };
+
+  // A node of the segment tree: its text's summaries, starting out of
+  // a string (0) and in one (1), and its text's size and newlines.
+  struct Node {
+    Summary summaries[2];
+    std::size_t size = 0;
+    std::size_t newlines = 0;
+  };
+
+  // Summarizes block, re-lexing it with a RacketTokenizer.
+  Node summarize_block(std::string const &block) const;
+
+  // Summarizes text starting in (or out of) a string.
+  static Summary summarize(std::string const &text, bool starts_in_string);
+
+  // The summary of one text followed by another (whose offsets start
+  // offset characters later).
+  static Summary combine(Summary const &first, Summary const &second,
+                         std::size_t offset);
+
+  // Recombines node from its children.
+  void update(std::size_t node);
+
+  // Builds the tree over all the blocks, with the given leaves.
+  void build(std::vector<Node> *leaves);
+
+  // Splits text into blocks ending just after newlines.
+  std::vector<std::string> split(std::string const &text) const;
+
+  // Finds the block containing offset (the last block for the end of
+  // the text) and the offset at which it starts.
+  std::size_t find_block(std::size_t offset,
+                         std::size_t *block_start) const;
+
+  // Produces the token for the structural character c at offset (or
+  // the EOF token).
+  Token make_token(std::size_t offset, int type, StringView data) const;
+
+  FileId file_id_;
+  std::size_t block_size_;
+  std::vector<std::string> blocks_;
+
+  // The segment tree: node 1 is the root, node i's children are 2i
+  // and 2i + 1, and the blocks are the leaves from leaf_base_ on
+  // (with empty leaves padding out the rest).
+  std::vector<Node> tree_;
+  std::size_t leaf_base_ = 1;
+};
+}  // namespace tokenizer
+
+#endif  // RACKET_BRACKET_STACK_INCREMENTAL_BALANCE_CHECKER_H_
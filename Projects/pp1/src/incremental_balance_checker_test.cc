@@ -0,0 +1,107 @@
+// incremental_balance_checker_test.cc --- Test code for the
+// IncrementalBalanceChecker class.
+
+// incremental_balance_checker_test is Copyright (C) 2014 by CPSC 221
+// at the University of British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#include <gmock/gmock.h>
+using ::testing::Eq;
+#include <gtest/gtest.h>
+using ::testing::Test;
+
+#include <cstddef>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include "./balance_checker.h"
+#include "./incremental_balance_checker.h"
+#include "./racket_tokenizer.h"
+#include "./tokenizer_test_util.h"
+
+namespace tokenizer {
+class IncrementalBalanceCheckerTest : public Test {
+ protected:
+  IncrementalBalanceCheckerTest() { }
+
+  virtual ~IncrementalBalanceCheckerTest() { }
+
+  // Checks that checker holds text and finds what a BalanceChecker
+  // over a RacketTokenizer does in it.
+  void check_same_balance(IncrementalBalanceChecker const &checker,
+                          std::string const &text) {
+    ASSERT_THAT(checker.text(), Eq(text));
+    ASSERT_THAT(checker.size(), Eq(text.size()));
+
+    std::stringstream stream(text);
+    RacketTokenizer racket(stream, "file");
+    BalanceChecker racket_checker(&racket);
+    Token expected = racket_checker.check_balance();
+
+    expect_same_token(checker.check_balance(), expected, text);
+  }
+};
+
+TEST_F(IncrementalBalanceCheckerTest, SameBalance) {
+  std::string const texts[] = {
+    "", "(* ({+[8 7]} 9))", ";blue({))}\n(+[3 5])",
+    "(stringeq(\"foo\", \"bar)", "{ *[+(3 5) 9] ]", "\"cool(({\" {(12345)}",
+    "(\n(\n)\n)\n)\n", "(\n[\n)\n]\n", "\"a\n(\n\"\n)\n", ";(\n\")\n\\\"\n\""
+  };
+  for (std::string const &text : texts) {
+    for (std::size_t block_size = 1; block_size < 6; ++block_size) {
+      IncrementalBalanceChecker checker(text, "file", block_size);
+      check_same_balance(checker, text);
+    }
+  }
+}
+
+TEST_F(IncrementalBalanceCheckerTest, Edits) {
+  std::string text = "(define (f x)\n  [x])\n";
+  IncrementalBalanceChecker checker(text, "file", 4);
+  check_same_balance(checker, text);
+
+  // Opening a string swallows the rest of the program.
+  checker.edit(9, 0, "\"");
+  text.insert(9, "\"");
+  check_same_balance(checker, text);
+
+  // Closing it on a later line.
+  checker.edit(text.size() - 1, 0, "\"");
+  text.insert(text.size() - 1, "\"");
+  check_same_balance(checker, text);
+
+  // Joining lines and deleting everything.
+  checker.edit(13, 2, "");
+  text.erase(13, 2);
+  check_same_balance(checker, text);
+  checker.edit(0, text.size(), "");
+  text.clear();
+  check_same_balance(checker, text);
+  checker.edit(0, 0, "{\n}");
+  text = "{\n}";
+  check_same_balance(checker, text);
+}
+
+TEST_F(IncrementalBalanceCheckerTest, RandomEdits) {
+  std::default_random_engine random(221);
+  for (int trial = 0; trial < 20; ++trial) {
+    std::string text;
+    IncrementalBalanceChecker checker(text, "file", 1 + random() % 16);
+    for (int i = 0; i < 100; ++i) {
+      std::size_t offset = random() % (text.size() + 1);
+      std::size_t length = random() % 4 == 0 ?
+          random() % (text.size() - offset + 1) : 0;
+      std::string replacement = random_text(&random, 8);
+
+      checker.edit(offset, length, replacement);
+      text.replace(offset, length, replacement);
+      check_same_balance(checker, text);
+    }
+  }
+}
+}  // namespace tokenizer
@@ -0,0 +1,34 @@
+// language_tokenizers.cc --- Compiles the DelimiterTokenizers for the
+// languages in language_tokenizers.h, and defines what they and
+// DelimiterTokenizer need defined once.
+
+// language_tokenizers.cc is Copyright (C) 2014 by the University of
+// British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#include "./language_tokenizers.h"
+
+namespace tokenizer {
+namespace delimiter_spec {
+CharacterTable const kCharacters =
+    make_character_table(MakeIndices<256>::type());
+}  // namespace delimiter_spec
+
+// The tokenizers read their specs' comment lists as they go.
+constexpr char const *JsonSpec::kLineComments[];
+constexpr char const *JsonSpec::kBlockComments[];
+constexpr char const *CLikeSpec::kLineComments[];
+constexpr char const *CLikeSpec::kBlockComments[];
+constexpr char const *XmlSpec::kLineComments[];
+constexpr char const *XmlSpec::kBlockComments[];
+constexpr char const *RacketSpec::kLineComments[];
+constexpr char const *RacketSpec::kBlockComments[];
+
+template class DelimiterTokenizer<JsonSpec>;
+template class DelimiterTokenizer<CLikeSpec>;
+template class DelimiterTokenizer<XmlSpec>;
+template class DelimiterTokenizer<RacketSpec>;
+}  // namespace tokenizer
@@ -0,0 +1,76 @@
+// language_tokenizers.h --- Specs for DelimiterTokenizers for
+// checking the balance of languages other than Racket: JSON, C-like
+// languages and XML-ish markup.  Part of the RackaBrackaStack
+// project.
+
+// language_tokenizers.h is Copyright (C) 2014 by the University of
+// British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#ifndef RACKET_BRACKET_STACK_LANGUAGE_TOKENIZERS_H_
+#define RACKET_BRACKET_STACK_LANGUAGE_TOKENIZERS_H_
+
+#include "./delimiter_tokenizer.h"
+
+namespace tokenizer {
+// JSON: objects and arrays, and strings with backslash escapes.
+struct JsonSpec {
+  static constexpr char kBrackets[] = "{}[]";
+  static constexpr char kQuotes[] = "\"";
+  static constexpr char kEscape = '\\';
+  static constexpr char const *kLineComments[] = {nullptr};
+  static constexpr char const *kBlockComments[] = {nullptr};
+};
+
+// C, C++, Java, JavaScript and the like: all three kinds of brackets,
+// string and character literals, and both kinds of comments.  (Angle
+// brackets aren't checked; in these languages they're as often
+// operators as brackets.)
+struct CLikeSpec {
+  static constexpr char kBrackets[] = "()[]{}";
+  static constexpr char kQuotes[] = "\"'";
+  static constexpr char kEscape = '\\';
+  static constexpr char const *kLineComments[] = {"//", nullptr};
+  static constexpr char const *kBlockComments[] = {"/*", "*/", nullptr};
+};
+
+// XML-ish markup: checks that every tag's angle brackets balance,
+// skipping comments and CDATA sections.  It doesn't check that tags
+// nest, and there are no strings, so a ">" in text or in an attribute
+// value (where XML allows it) counts as a closing bracket.
+struct XmlSpec {
+  static constexpr char kBrackets[] = "<>";
+  static constexpr char kQuotes[] = "";
+  static constexpr char kEscape = '\0';
+  static constexpr char const *kLineComments[] = {nullptr};
+  static constexpr char const *kBlockComments[] = {
+    "<!--", "-->", "<![CDATA[", "]]>", nullptr
+  };
+};
+
+// Racket as BracketTokenizer sees it (producing the same tokens but
+// for their types), for measuring what the generality costs.
+struct RacketSpec {
+  static constexpr char kBrackets[] = "()[]{}";
+  static constexpr char kQuotes[] = "\"";
+  static constexpr char kEscape = '\\';
+  static constexpr char const *kLineComments[] = {";", nullptr};
+  static constexpr char const *kBlockComments[] = {nullptr};
+};
+
+typedef DelimiterTokenizer<JsonSpec> JsonTokenizer;
+typedef DelimiterTokenizer<CLikeSpec> CLikeTokenizer;
+typedef DelimiterTokenizer<XmlSpec> XmlTokenizer;
+typedef DelimiterTokenizer<RacketSpec> RacketDelimiterTokenizer;
+
+// These are compiled once, in language_tokenizers.cc.
+extern template class DelimiterTokenizer<JsonSpec>;
+extern template class DelimiterTokenizer<CLikeSpec>;
+extern template class DelimiterTokenizer<XmlSpec>;
+extern template class DelimiterTokenizer<RacketSpec>;
+}  // namespace tokenizer
+
+#endif  // RACKET_BRACKET_STACK_LANGUAGE_TOKENIZERS_H_
@@ -0,0 +1,69 @@
+// line_index.cc --- Defines the LineIndex class.
+
+// line_index.cc is Copyright (C) 2014 by the University of British
+// Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+
+#include "./line_index.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace tokenizer {
+void LineIndex::assign(char const *begin, char const *end,
+                       std::uint64_t offset, int line, int column) {
+  begin_ = begin;
+  end_ = end;
+  offset_ = offset;
+  line_ = line;
+  column_ = column;
+  built_ = false;
+  newlines_.clear();
+  newlines_.shrink_to_fit();
+}
+
+void LineIndex::find_position(std::uint64_t offset,
+                              int *line, int *column) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!built_) {
+    char const *position = begin_;
+    while (position != end_ &&
+           (position = static_cast<char const *>(
+               std::memchr(position, '\n', end_ - position))) != nullptr) {
+      newlines_.push_back(position - begin_);
+      ++position;
+    }
+    built_ = true;
+  }
+
+  // The newlines before offset end the lines before its line.
+  offset -= offset_;
+  std::vector<std::uint64_t>::const_iterator after =
+      std::lower_bound(newlines_.begin(), newlines_.end(), offset);
+  *line = line_ + static_cast<int>(after - newlines_.begin());
+  if (after == newlines_.begin())
+    *column = column_ + static_cast<int>(offset);
+  else
+    *column = 1 + static_cast<int>(offset - (after[-1] + 1));
+}
+
+void LineIndex::advance(char const *begin, char const *end,
+                        int *line, int *column) {
+  char const *line_start = begin;
+  char const *position = begin;
+  while (position != end &&
+         (position = static_cast<char const *>(
+             std::memchr(position, '\n', end - position))) != nullptr) {
+    ++*line;
+    line_start = ++position;
+  }
+  if (line_start == begin)
+    *column += static_cast<int>(end - begin);
+  else
+    *column = 1 + static_cast<int>(end - line_start);
+}
+}  // namespace tokenizer
@@ -0,0 +1,72 @@
+// line_index.h --- Declares the LineIndex class, which turns offsets
+// in a file into lines and columns, so that tokens need only record
+// their offsets.  Part of the RackaBrackaStack project.
+
+// line_index.h is Copyright (C) 2014 by the University of British
+// Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#ifndef RACKET_BRACKET_STACK_LINE_INDEX_H_
+#define RACKET_BRACKET_STACK_LINE_INDEX_H_
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace tokenizer {
+// The offsets of the newlines in some text of a file, from which any
+// offset's line and column (1-based, counting a tab or \r as one
+// column, as RacketTokenizer always has) follow by binary search.
+//
+// The text may be a whole file in memory or just one block of a
+// stream, given the line and column it starts at.  Its newlines are
+// found the first time a position is asked for, so text whose
+// tokens' positions are never needed (the usual case) is never
+// indexed, and a stream keeps nothing per newline of blocks it has
+// moved past.
+//
+// A LineIndex may be shared between threads.
+class LineIndex {
+ public:
+  // Constructs an index of [begin, end), which must outlive it: the
+  // text of its file from offset on, starting at line and column.
+  LineIndex(char const *begin, char const *end, std::uint64_t offset = 0,
+            int line = 1, int column = 1) {
+    assign(begin, end, offset, line, column);
+  }
+
+  LineIndex(LineIndex const &) = delete;
+  LineIndex &operator=(LineIndex const &) = delete;
+
+  // Makes this an index of [begin, end), as the constructor does.
+  // Not to be called while anyone else uses the index.
+  void assign(char const *begin, char const *end, std::uint64_t offset,
+              int line, int column);
+
+  // Finds the line and column of the character at offset (or, at the
+  // end of the text, of where the next character would be).
+  //
+  // precondition: offset is in the text, or at its end.
+  void find_position(std::uint64_t offset, int *line, int *column) const;
+
+  // Advances *line and *column, the position of begin, to that of end.
+  static void advance(char const *begin, char const *end,
+                      int *line, int *column);
+
+ private:
+  char const *begin_;
+  char const *end_;
+  std::uint64_t offset_;
+  int line_;
+  int column_;
+
+  mutable std::mutex mutex_;
+  mutable bool built_;
+  mutable std::vector<std::uint64_t> newlines_;   // Offsets from begin_.
+};
+}  // namespace tokenizer
+
+#endif  // RACKET_BRACKET_STACK_LINE_INDEX_H_
@@ -0,0 +1,99 @@
+// line_index_test.cc --- Test code for the LineIndex class and for
+// tokens whose positions are found in one.
+
+// line_index_test is Copyright (C) 2014 by CPSC 221 at the
+// University of British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#include <gmock/gmock.h>
+using ::testing::Eq;
+#include <gtest/gtest.h>
+using ::testing::Test;
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "./line_index.h"
+#include "./token.h"
+
+namespace tokenizer {
+class LineIndexTest : public Test {
+ protected:
+  LineIndexTest() { }
+
+  virtual ~LineIndexTest() { }
+
+  // Checks that offset is at line and column in index.
+  void check_position(LineIndex const &index, std::uint64_t offset,
+                      int line, int column) {
+    int found_line = 0, found_column = 0;
+    index.find_position(offset, &found_line, &found_column);
+    EXPECT_THAT(found_line, Eq(line)) << "at offset " << offset;
+    EXPECT_THAT(found_column, Eq(column)) << "at offset " << offset;
+  }
+
+  std::string const text_ = "ab\n\ncd\r\n\te";
+};
+
+TEST_F(LineIndexTest, InMemory) {
+  LineIndex index(text_.data(), text_.data() + text_.size());
+  check_position(index, 0, 1, 1);
+  check_position(index, 2, 1, 3);     // The newline ends its line.
+  check_position(index, 3, 2, 1);
+  check_position(index, 4, 3, 1);
+  check_position(index, 6, 3, 3);     // A \r is one column.
+  check_position(index, 9, 4, 2);     // So is a tab.
+  check_position(index, 10, 4, 3);    // The end of the input.
+
+  LineIndex empty(nullptr, nullptr);
+  check_position(empty, 0, 1, 1);
+}
+
+TEST_F(LineIndexTest, OneBlock) {
+  // The text from offset 3 on, which starts at line 1, column 4.
+  LineIndex index(text_.data() + 3, text_.data() + text_.size(), 3, 1, 4);
+  check_position(index, 3, 1, 4);
+  check_position(index, 4, 2, 1);
+  check_position(index, 6, 2, 3);
+  check_position(index, 10, 3, 3);
+
+  // Reused for a block on a line of its own.
+  index.assign(text_.data() + 4, text_.data() + 6, 4, 3, 1);
+  check_position(index, 5, 3, 2);
+}
+
+TEST_F(LineIndexTest, Advance) {
+  int line = 1, column = 1;
+  LineIndex::advance(text_.data(), text_.data() + 6, &line, &column);
+  EXPECT_THAT(line, Eq(3));
+  EXPECT_THAT(column, Eq(3));
+  LineIndex::advance(text_.data() + 6, text_.data() + 6, &line, &column);
+  EXPECT_THAT(column, Eq(3));
+  LineIndex::advance(text_.data() + 8, text_.data() + 10, &line, &column);
+  EXPECT_THAT(line, Eq(3));
+  EXPECT_THAT(column, Eq(5));
+}
+
+TEST_F(LineIndexTest, TokenPositions) {
+  std::shared_ptr<LineIndex> index =
+      std::make_shared<LineIndex>(text_.data(), text_.data() + text_.size());
+  Token cd(1, StringView(text_.data() + 4, 4), index, nullptr,
+           intern_filename("file"), 4, index.get());
+  EXPECT_THAT(cd.start_line(), Eq(3));
+  EXPECT_THAT(cd.start_column(), Eq(1));
+  EXPECT_THAT(cd.end_line(), Eq(4));
+  EXPECT_THAT(cd.end_column(), Eq(1));
+  EXPECT_THAT(cd.offset(), Eq(4u));
+
+  // The token keeps the index alive.
+  std::weak_ptr<LineIndex> weak_index = index;
+  index.reset();
+  EXPECT_FALSE(weak_index.expired());
+  EXPECT_THAT(cd.start_line(), Eq(3));
+}
+}  // namespace tokenizer
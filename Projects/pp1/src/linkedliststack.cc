@@ -5,16 +5,30 @@
  */
 
 #include <cassert>
+#include <new>
 #include "./linkedliststack.h"
 
 namespace tokenizer {
 
-LinkedListStack::LinkedListStack() : head(nullptr) {}
+std::size_t const NodePool::kFirstSlabSize;
+
+void NodePool::add_slab() {
+  std::size_t size = kFirstSlabSize << slabs_.size();
+  slabs_.emplace_back(new Slot[size]);
+  unused_ = slabs_.back().get();
+  slab_end_ = unused_ + size;
+  ++stats_.slabs;
+  stats_.capacity += size;
+}
+
+LinkedListStack::LinkedListStack(bool pooled)
+    : pool(pooled), head(nullptr) {}
 
 LinkedListStack::~LinkedListStack() {
   while (head != nullptr) {
     Node * next = head->next;
-    delete head;
+    head->~Node();
+    pool.deallocate(head);
     head = next;
   }
 }
@@ -26,12 +40,14 @@ bool LinkedListStack::empty() const {
 void LinkedListStack::pop() {
   assert(!empty());
   Node * newHead = head->next;   // sets the new head of the stack to next node
-  delete head;
+  head->~Node();
+  pool.deallocate(head);
   head = newHead;
 }
 
 void LinkedListStack::push(const Token value) {
-  Node * front = new Node(value, head);  // creates a new Node pointing to head
+  // creates a new Node pointing to head
+  Node * front = new (pool.allocate()) Node(value, head);
   head = front;   // update head of array
 }
 
@@ -7,6 +7,12 @@
 #ifndef _LINKEDLISTSTACK_H_
 #define _LINKEDLISTSTACK_H_
 
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
 #include "./token_stack.h"
 #include "./token.h"
 
@@ -18,9 +24,98 @@ struct Node {
   Node(Token const k, Node * n) : key(k), next(n) {}
 };
 
+// What a NodePool has done so far.
+struct NodePoolStats {
+  std::size_t slabs = 0;        // allocated from the heap
+  std::size_t capacity = 0;     // nodes all the slabs hold
+  std::size_t in_use = 0;       // nodes handed out and not returned
+  std::size_t peak_in_use = 0;
+  std::size_t allocations = 0;  // nodes ever handed out
+  std::size_t reuses = 0;       // of those, ones returned earlier
+};
+
+// Hands out memory for Nodes from slabs it allocates (each twice the
+// size of the last), taking it back onto a free list to hand out
+// again.  So a stack that goes up and down allocates only as often
+// as it gets deeper than it has ever been, and then only a slab at a
+// time.  Slabs are freed when the pool is.
+//
+// An unpooled NodePool instead gets each Node from new and hands it
+// straight back to delete, as LinkedListStack did before it had a
+// pool; it still keeps its stats (but never has slabs or reuses).
+class NodePool {
+ public:
+  explicit NodePool(bool pooled = true) : pooled_(pooled) {}
+  ~NodePool() {}
+
+  NodePool(NodePool const &) = delete;
+  NodePool & operator=(NodePool const &) = delete;
+
+  // Returns room for one Node, which the caller constructs.
+  void * allocate() {
+    ++stats_.allocations;
+    if (++stats_.in_use > stats_.peak_in_use)
+      stats_.peak_in_use = stats_.in_use;
+    if (!pooled_)
+      return ::operator new(sizeof(Node));
+    if (free_ != nullptr) {
+      ++stats_.reuses;
+      Slot * slot = free_;
+      free_ = slot->next_free;
+      return slot;
+    }
+    if (unused_ == slab_end_)
+      add_slab();
+    return unused_++;
+  }
+
+  // Takes back room from allocate, once the caller has destroyed the
+  // Node in it.
+  void deallocate(void * node) {
+    --stats_.in_use;
+    if (!pooled_) {
+      ::operator delete(node);
+      return;
+    }
+    Slot * slot = static_cast<Slot *>(node);
+    slot->next_free = free_;
+    free_ = slot;
+  }
+
+  NodePoolStats const & stats() const {
+    return stats_;
+  }
+
+  // The number of nodes in the first slab.
+  static std::size_t const kFirstSlabSize = 64;
+
+ private:
+  // Room for a Node or, while it's free, a link to the next free slot.
+  union Slot {
+    Slot * next_free;
+    std::aligned_storage<sizeof(Node), alignof(Node)>::type node;
+  };
+
+  // Allocates a slab twice the size of the last one and starts
+  // handing it out.
+  void add_slab();
+
+  bool const pooled_;
+  std::vector<std::unique_ptr<Slot[]>> slabs_;
+  Slot * free_ = nullptr;
+
+  // The part of the newest slab never handed out.
+  Slot * unused_ = nullptr;
+  Slot * slab_end_ = nullptr;
+
+  NodePoolStats stats_;
+};
+
 class LinkedListStack : public TokenStack {
  public:
-  LinkedListStack();
+  // Given pooled false, the stack's nodes bypass its pool and come
+  // from new and delete, one at a time (to compare the two).
+  explicit LinkedListStack(bool pooled = true);
   virtual ~LinkedListStack();
 
   // checks if the stack is empty
@@ -36,7 +131,14 @@ class LinkedListStack : public TokenStack {
 
   // returns the top (head) of the stack
   virtual Token const top() const;
+
+  // what the stack's pool of nodes has done
+  NodePoolStats const & pool_stats() const {
+    return pool.stats();
+  }
  private:
+  // nodes come from (and go back to) here rather than new and delete
+  NodePool pool;
   Node * head;
 };
 
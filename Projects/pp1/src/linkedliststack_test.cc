@@ -9,6 +9,8 @@ using ::testing::Eq;
 #include <gtest/gtest.h>
 using ::testing::Test;
 
+#include <cstddef>
+
 #include "./token.h"
 #include "./token_stack.h"
 #include "./linkedliststack.h"
@@ -139,4 +141,47 @@ TEST_F(LinkedListStackTest, ManyPushManyPop) {
 TEST_F(LinkedListStackTest, ComplexUpDownUpDown) {
   test_up_down_up_down();
 }
+TEST_F(LinkedListStackTest, PoolReusesNodes) {
+  LinkedListStack pooled;
+  std::size_t const depth = NodePool::kFirstSlabSize + 1;
+  for (int round = 0; round < 3; ++round) {
+    for (std::size_t i = 0; i < depth; ++i)
+      pooled.push(token1_);
+    for (std::size_t i = 0; i < depth; ++i)
+      pooled.pop();
+  }
+  pooled.push(token2_);
+  EXPECT_THAT(pooled.top(), Eq(token2_));
+
+  // Two slabs covered the deepest the stack went; every later push
+  // reused a node.
+  NodePoolStats const &stats = pooled.pool_stats();
+  EXPECT_THAT(stats.slabs, Eq(2u));
+  EXPECT_THAT(stats.capacity, Eq(3 * NodePool::kFirstSlabSize));
+  EXPECT_THAT(stats.in_use, Eq(1u));
+  EXPECT_THAT(stats.peak_in_use, Eq(depth));
+  EXPECT_THAT(stats.allocations, Eq(3 * depth + 1));
+  EXPECT_THAT(stats.reuses, Eq(2 * depth + 1));
+}
+TEST_F(LinkedListStackTest, UnpooledBypassesPool) {
+  LinkedListStack unpooled(false);
+  std::size_t const depth = NodePool::kFirstSlabSize + 1;
+  for (int round = 0; round < 3; ++round) {
+    for (std::size_t i = 0; i < depth; ++i)
+      unpooled.push(token1_);
+    for (std::size_t i = 0; i < depth; ++i)
+      unpooled.pop();
+  }
+  unpooled.push(token2_);
+  EXPECT_THAT(unpooled.top(), Eq(token2_));
+
+  // Every push got a node of its own from new; none came from a slab.
+  NodePoolStats const &stats = unpooled.pool_stats();
+  EXPECT_THAT(stats.slabs, Eq(0u));
+  EXPECT_THAT(stats.capacity, Eq(0u));
+  EXPECT_THAT(stats.in_use, Eq(1u));
+  EXPECT_THAT(stats.peak_in_use, Eq(depth));
+  EXPECT_THAT(stats.allocations, Eq(3 * depth + 1));
+  EXPECT_THAT(stats.reuses, Eq(0u));
+}
 }  // namespace tokenizer
@@ -0,0 +1,59 @@
+// make_corpus.cc --- Writes a synthetic Racket corpus of any size to
+// standard output, for trying racka_bracka and the benchmarks on.
+
+// make_corpus.cc is Copyright (C) 2014 by the University of British
+// Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include "./corpus_generator.h"
+
+namespace {
+void print_usage(char const *program) {
+  std::cerr << "Usage: " << program << " <size> [<option>...]" << std::endl;
+  std::cerr << "\tWrites size bytes (or 64k, 16M, 1G, ...) of balanced "
+            << "Racket-like source" << std::endl
+            << "\tto standard output.  The options (defaults in "
+            << "parentheses) are:" << std::endl
+            << "\t  --depth=N          deepest nesting (16)" << std::endl
+            << "\t  --nesting=P        chance an item is a form (0.3)"
+            << std::endl
+            << "\t  --form-length=N    average items in a form (4)"
+            << std::endl
+            << "\t  --identifiers=P    chance an atom is an identifier, "
+            << "not a number (0.7)" << std::endl
+            << "\t  --strings=P        chance an atom is a string (0.1)"
+            << std::endl
+            << "\t  --string-length=N  average string length (12)"
+            << std::endl
+            << "\t  --escapes=P        chance a string character is an "
+            << "escape (0.05)" << std::endl
+            << "\t  --comments=P       chance a line ends in a comment "
+            << "(0.1)" << std::endl
+            << "\t  --crlf             end lines in \\r\\n" << std::endl
+            << "\t  --seed=N           random seed (221)" << std::endl;
+}
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  std::uint64_t size = argc > 1 ? tokenizer::parse_corpus_size(argv[1]) : 0;
+  tokenizer::CorpusOptions options;
+  bool options_ok = true;
+  for (int i = 2; i < argc; ++i)
+    options_ok = options_ok && tokenizer::parse_corpus_option(argv[i],
+                                                              &options);
+  if (size == 0 || !options_ok) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  tokenizer::CorpusGenerator generator(options);
+  generator.write(size, &std::cout);
+  return std::cout ? 0 : 1;
+}
@@ -0,0 +1,70 @@
+// mapped_file.cc --- Defines MappedFile, a read-only memory mapping
+// of a whole file.
+
+// mapped_file.cc is Copyright (C) 2014 by the University of British
+// Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+
+#include "./mapped_file.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define RACKET_BRACKET_STACK_HAVE_MMAP 1
+#endif
+
+namespace tokenizer {
+#ifdef RACKET_BRACKET_STACK_HAVE_MMAP
+bool MappedFile::map(std::string const &filename) {
+  unmap();
+
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  struct stat status;
+  if (fstat(fd, &status) != 0 || !S_ISREG(status.st_mode)) {
+    close(fd);
+    return false;
+  }
+
+  // mmap refuses empty mappings, but an empty file is easy.
+  size_ = static_cast<std::size_t>(status.st_size);
+  if (size_ > 0) {
+    void *data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+      close(fd);
+      size_ = 0;
+      return false;
+    }
+    madvise(data, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<char const *>(data);
+  }
+
+  // The mapping stays valid after the descriptor is closed.
+  close(fd);
+  mapped_ = true;
+  return true;
+}
+
+void MappedFile::unmap() {
+  if (data_ != nullptr)
+    munmap(const_cast<char *>(data_), size_);
+  mapped_ = false;
+  data_ = nullptr;
+  size_ = 0;
+}
+#else
+bool MappedFile::map(std::string const &) {
+  return false;
+}
+
+void MappedFile::unmap() { }
+#endif
+}  // namespace tokenizer
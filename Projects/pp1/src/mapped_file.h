@@ -0,0 +1,64 @@
+// mapped_file.h --- Declares MappedFile, a read-only memory mapping of
+// a whole file, so that tokenizers can scan very large inputs in
+// place rather than streaming them.  Part of the RackaBrackaStack
+// project.
+
+// mapped_file.h is Copyright (C) 2014 by the University of British
+// Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#ifndef RACKET_BRACKET_STACK_MAPPED_FILE_H_
+#define RACKET_BRACKET_STACK_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <string>
+
+namespace tokenizer {
+// Only regular files can be mapped; pipes, terminals and the like
+// (including, typically, standard input) cannot, and callers should
+// fall back to reading those as streams.  On platforms without
+// mmap, nothing can be mapped.
+class MappedFile {
+ public:
+  MappedFile() { }
+  ~MappedFile() { unmap(); }
+
+  MappedFile(MappedFile const &) = delete;
+  MappedFile &operator=(MappedFile const &) = delete;
+
+  // Maps the named file, replacing any current mapping, and advises
+  // the system that it will be read sequentially.  Returns false
+  // (leaving nothing mapped) if the file cannot be opened, is not a
+  // regular file, or cannot be mapped.
+  bool map(std::string const &filename);
+
+  // Releases the current mapping, if any.
+  void unmap();
+
+  bool is_mapped() const {
+    return mapped_;
+  }
+
+  // The file's contents (valid while mapped).  An empty file maps to
+  // an empty range.
+  char const *begin() const {
+    return data_;
+  }
+  char const *end() const {
+    return data_ + size_;
+  }
+  std::size_t size() const {
+    return size_;
+  }
+
+ private:
+  bool mapped_ = false;
+  char const *data_ = nullptr;
+  std::size_t size_ = 0;
+};
+}  // namespace tokenizer
+
+#endif  // RACKET_BRACKET_STACK_MAPPED_FILE_H_
@@ -0,0 +1,90 @@
+// mapped_file_test.cc --- Test code for the MappedFile class and for
+// tokenizing a mapped file in place.
+
+// mapped_file_test is Copyright (C) 2014 by CPSC 221 at the
+// University of British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#include <gmock/gmock.h>
+using ::testing::Eq;
+#include <gtest/gtest.h>
+using ::testing::Test;
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "./mapped_file.h"
+#include "./racket_tokenizer.h"
+
+namespace tokenizer {
+class MappedFileTest : public Test {
+ protected:
+  MappedFileTest() {
+    std::ofstream out(filename_, std::ios::binary);
+    out << text_;
+  }
+
+  virtual ~MappedFileTest() {
+    std::remove(filename_.c_str());
+  }
+
+  std::string const filename_ = "mapped_file_test.rkt";
+  std::string const text_ = "(define (f x) ;; cmt\r\n  {\"s\\\"\" [x]})";
+};
+
+TEST_F(MappedFileTest, MapsContents) {
+  MappedFile file;
+  ASSERT_TRUE(file.map(filename_));
+  EXPECT_TRUE(file.is_mapped());
+  EXPECT_THAT(std::string(file.begin(), file.end()), Eq(text_));
+
+  file.unmap();
+  EXPECT_FALSE(file.is_mapped());
+  EXPECT_THAT(file.size(), Eq(0u));
+}
+
+TEST_F(MappedFileTest, EmptyFile) {
+  std::string const empty_filename = "mapped_file_test_empty.rkt";
+  { std::ofstream out(empty_filename); }
+
+  MappedFile file;
+  EXPECT_TRUE(file.map(empty_filename));
+  EXPECT_THAT(file.size(), Eq(0u));
+  std::remove(empty_filename.c_str());
+}
+
+TEST_F(MappedFileTest, CannotMap) {
+  MappedFile file;
+  EXPECT_FALSE(file.map("mapped_file_test_missing.rkt"));
+  EXPECT_FALSE(file.is_mapped());
+  // Directories are not regular files.
+  EXPECT_FALSE(file.map("."));
+}
+
+TEST_F(MappedFileTest, TokenizesInPlace) {
+  MappedFile file;
+  ASSERT_TRUE(file.map(filename_));
+  RacketTokenizer mapped(file.begin(), file.end(), filename_);
+
+  std::stringstream stream(text_);
+  RacketTokenizer streamed(stream, filename_);
+
+  bool at_eof = false;
+  while (!at_eof) {
+    Token token = streamed.next_token();
+    Token mapped_token = mapped.next_token();
+    EXPECT_THAT(mapped_token, Eq(token));
+    EXPECT_THAT(mapped_token.filename(), Eq(filename_));
+    EXPECT_THAT(mapped_token.start_line(), Eq(token.start_line()));
+    EXPECT_THAT(mapped_token.start_column(), Eq(token.start_column()));
+    EXPECT_THAT(mapped_token.end_line(), Eq(token.end_line()));
+    EXPECT_THAT(mapped_token.end_column(), Eq(token.end_column()));
+    at_eof = token.is_eof();
+  }
+}
+}  // namespace tokenizer
@@ -25,6 +25,8 @@ MyStack::~MyStack() {
   // TODO(you): don't forget to delete anything allocated with new ...[...]
   // using delete [] ...
 
+  while (!empty())
+    pop();
   delete [] array_;
 }
 
@@ -36,6 +38,7 @@ bool MyStack::empty() const {
 void MyStack::pop() {
   assert(!empty());
   --top_;
+  delete array_[top_];
 }
 
 void MyStack::push(Token const value) {
@@ -43,7 +46,9 @@ void MyStack::push(Token const value) {
     double_capacity();
 
   // TODO(you): finish this
-  array_[top_] = &value;
+  //
+  // value goes away when push returns; so, the stack keeps a copy.
+  array_[top_] = new Token(value);
   ++top_;
 }
 
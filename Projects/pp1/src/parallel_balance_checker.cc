@@ -0,0 +1,166 @@
+// parallel_balance_checker.cc --- Defines the ParallelBalanceChecker,
+// which summarizes chunks of its input in parallel and combines the
+// summaries.
+
+// parallel_balance_checker.cc is Copyright (C) 2014 by the
+// University of British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+
+#include "./parallel_balance_checker.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+#include "./racket_tokenizer.h"
+#include "./structural_index.h"
+
+namespace tokenizer {
+typedef RacketTokenizer RT;
+
+std::size_t const ParallelBalanceChecker::kMinChunkSize;
+
+Token ParallelBalanceChecker::check_balance() {
+  std::size_t size = end_ - begin_;
+  std::size_t num_chunks =
+      std::max<std::size_t>(1, std::min<std::size_t>(4 * jobs_,
+                                                     size / min_chunk_size_));
+  std::vector<ChunkSummary> chunks = split(num_chunks);
+
+  // Summarize every chunk, guessing that none starts in a string.
+  std::atomic<std::size_t> next(0);
+  auto work = [&]() {
+    for (std::size_t i = next++; i < chunks.size(); i = next++)
+      summarize(false, &chunks[i]);
+  };
+  unsigned num_threads = std::min<std::size_t>(jobs_, chunks.size());
+  std::vector<std::thread> threads;
+  for (unsigned i = 1; i < num_threads; ++i)
+    threads.push_back(std::thread(work));
+  work();
+  for (std::thread &thread : threads)
+    thread.join();
+
+  // Combine the summaries in order, as check_balance would work
+  // through the tokens, re-summarizing any chunk that was guessed
+  // wrong.
+  std::vector<std::size_t> openers;
+  bool in_string = false;
+  for (ChunkSummary &chunk : chunks) {
+    if (chunk.starts_in_string != in_string)
+      summarize(in_string, &chunk);
+    in_string = chunk.ends_in_string;
+
+    for (std::size_t closer : chunk.unmatched_closers) {
+      if (openers.empty() ||
+          !RT::are_matching_types(RT::structural_type(begin_[openers.back()]),
+                                  RT::structural_type(begin_[closer])))
+        return make_token(closer);
+      openers.pop_back();
+    }
+    if (chunk.has_mismatch)
+      return make_token(chunk.mismatch);
+    openers.insert(openers.end(), chunk.unmatched_openers.begin(),
+                   chunk.unmatched_openers.end());
+  }
+
+  if (!openers.empty())
+    return make_token(openers.back());
+  return make_eof_token();
+}
+
+void ParallelBalanceChecker::summarize(bool starts_in_string,
+                                       ChunkSummary *summary) const {
+  summary->starts_in_string = starts_in_string;
+  summary->unmatched_closers.clear();
+  summary->unmatched_openers.clear();
+  summary->has_mismatch = false;
+
+  StructuralIndexer indexer(summary->begin, summary->end, starts_in_string);
+  std::vector<std::size_t> offsets;
+  std::size_t base = summary->begin - begin_;
+  std::vector<std::size_t> &openers = summary->unmatched_openers;
+
+  // Nothing comes between a string's quotation marks; so, a quotation
+  // mark in a string closes it and must match the top of the stack.
+  bool in_string = starts_in_string;
+  while (indexer.index_next(RT::kDefaultBlockSize, &offsets)) {
+    for (std::size_t offset : offsets) {
+      offset += base;
+      RT::TokenType type = RT::structural_type(begin_[offset]);
+      bool closing = type == RT::kQuotationMark ?
+          in_string : RT::is_closing_type(type);
+      if (type == RT::kQuotationMark)
+        in_string = !in_string;
+
+      if (!closing) {
+        openers.push_back(offset);
+      } else if (openers.empty()) {
+        summary->unmatched_closers.push_back(offset);
+      } else if (RT::are_matching_types(
+          RT::structural_type(begin_[openers.back()]), type)) {
+        openers.pop_back();
+      } else {
+        summary->has_mismatch = true;
+        summary->mismatch = offset;
+        summary->ends_in_string = in_string;
+        return;
+      }
+    }
+    offsets.clear();
+  }
+  summary->ends_in_string = indexer.in_string();
+}
+
+std::vector<ParallelBalanceChecker::ChunkSummary>
+ParallelBalanceChecker::split(std::size_t num_chunks) const {
+  std::vector<ChunkSummary> chunks;
+  std::size_t size = end_ - begin_;
+  char const *chunk_begin = begin_;
+  for (std::size_t i = 1; i <= num_chunks && chunk_begin != end_; ++i) {
+    char const *chunk_end = i == num_chunks ?
+        end_ : std::max(chunk_begin, begin_ + size / num_chunks * i);
+    if (chunk_end != end_) {
+      char const *newline = static_cast<char const *>(
+          std::memchr(chunk_end, '\n', end_ - chunk_end));
+      chunk_end = newline != nullptr ? newline + 1 : end_;
+    }
+
+    ChunkSummary chunk;
+    chunk.begin = chunk_begin;
+    chunk.end = chunk_end;
+    chunks.push_back(chunk);
+    chunk_begin = chunk_end;
+  }
+  return chunks;
+}
+
+Token ParallelBalanceChecker::make_token(std::size_t offset) const {
+  char const *position = begin_ + offset;
+  int line = 1 + std::count(begin_, position, '\n');
+  char const *line_start = position;
+  while (line_start != begin_ && line_start[-1] != '\n')
+    --line_start;
+  int column = position - line_start + 1;
+
+  char c = *position;
+  return Token(RT::structural_type(c), RT::structural_data(c),
+               nullptr, nullptr, file_id_,
+               line, line, column, column + 1, offset);
+}
+
+Token ParallelBalanceChecker::make_eof_token() const {
+  int line = 1 + std::count(begin_, end_, '\n');
+  char const *line_start = end_;
+  while (line_start != begin_ && line_start[-1] != '\n')
+    --line_start;
+  int column = end_ - line_start + 1;
+  return Token(RT::kEof, StringView(), nullptr, nullptr, file_id_,
+               line, line, column, column, end_ - begin_);
+}
+}  // namespace tokenizer
@@ -0,0 +1,100 @@
+// parallel_balance_checker.h --- Declares the ParallelBalanceChecker,
+// which checks the brackets of Racket source in memory by splitting
+// it into chunks, summarizing each chunk on its own thread, and
+// combining the summaries.  Part of the RackaBrackaStack project.
+
+// parallel_balance_checker.h is Copyright (C) 2014 by the University
+// of British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#ifndef RACKET_BRACKET_STACK_PARALLEL_BALANCE_CHECKER_H_
+#define RACKET_BRACKET_STACK_PARALLEL_BALANCE_CHECKER_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "./file_id.h"
+#include "./token.h"
+
+namespace tokenizer {
+// Gives the same answer as a BalanceChecker over a RacketTokenizer
+// (or a StructuralTokenizer) for the same input, in the same form.
+//
+// Bracket matching combines chunk by chunk: once the brackets that
+// match within a chunk are removed, what's left is some closers
+// (that must match openers from earlier chunks) followed by some
+// openers (left for later chunks).  So each chunk is summarized
+// independently, in parallel, and the summaries are then combined
+// in order, which takes time proportional to what's left unmatched.
+//
+// A chunk can't know whether it starts inside a string without
+// lexing everything before it.  Chunks start just after a newline,
+// so none starts inside a comment (or right after an escape), and
+// each is summarized on the (usually right) guess that it doesn't
+// start inside a string either.  The combining pass knows each
+// chunk's true starting state and re-summarizes the rare chunk
+// whose guess was wrong.
+class ParallelBalanceChecker {
+ public:
+  // Constructs a checker for [begin, end), which must outlive it,
+  // that will report tokens as coming from the given file and use up
+  // to jobs threads on chunks of at least min_chunk_size characters
+  // (give or take a line).
+  ParallelBalanceChecker(char const *begin, char const *end,
+                         std::string const &filename, unsigned jobs,
+                         std::size_t min_chunk_size = kMinChunkSize)
+      : begin_(begin), end_(end), file_id_(intern_filename(filename)),
+        jobs_(jobs > 0 ? jobs : 1),
+        min_chunk_size_(min_chunk_size > 0 ? min_chunk_size : 1) { }
+
+  // Returns what BalanceChecker::check_balance would: the first
+  // closing token that does not match, else the innermost opening
+  // token never closed, else the EOF token.
+  Token check_balance();
+
+  // Chunks smaller than this aren't worth a thread.
+  static std::size_t const kMinChunkSize = 1 << 20;
+
+ private:
+  // What's left of a chunk once brackets matched within it are
+  // removed (as offsets of structural characters from begin_).
+  struct ChunkSummary {
+    char const *begin;
+    char const *end;
+    bool starts_in_string = false;
+    bool ends_in_string = false;
+    std::vector<std::size_t> unmatched_closers;
+    std::vector<std::size_t> unmatched_openers;   // Innermost last.
+
+    // A closer not matching an opener from the same chunk (after
+    // which the chunk was not summarized further), if found.
+    bool has_mismatch = false;
+    std::size_t mismatch = 0;
+  };
+
+  // Summarizes the chunk in summary, given whether it starts in a
+  // string.
+  void summarize(bool starts_in_string, ChunkSummary *summary) const;
+
+  // Splits the input into chunks starting just after newlines.
+  std::vector<ChunkSummary> split(std::size_t num_chunks) const;
+
+  // Produces the token for the structural character at offset.
+  Token make_token(std::size_t offset) const;
+
+  // Produces the EOF token.
+  Token make_eof_token() const;
+
+  char const *begin_;
+  char const *end_;
+  FileId file_id_;
+  unsigned jobs_;
+  std::size_t min_chunk_size_;
+};
+}  // namespace tokenizer
+
+#endif  // RACKET_BRACKET_STACK_PARALLEL_BALANCE_CHECKER_H_
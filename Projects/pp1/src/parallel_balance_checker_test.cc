@@ -0,0 +1,100 @@
+// parallel_balance_checker_test.cc --- Test code for the
+// ParallelBalanceChecker class.
+
+// parallel_balance_checker_test is Copyright (C) 2014 by CPSC 221 at
+// the University of British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#include <gmock/gmock.h>
+using ::testing::Eq;
+#include <gtest/gtest.h>
+using ::testing::Test;
+
+#include <cstddef>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include "./balance_checker.h"
+#include "./parallel_balance_checker.h"
+#include "./racket_tokenizer.h"
+#include "./tokenizer_test_util.h"
+
+namespace tokenizer {
+class ParallelBalanceCheckerTest : public Test {
+ protected:
+  ParallelBalanceCheckerTest() { }
+
+  virtual ~ParallelBalanceCheckerTest() { }
+
+  // Checks that a ParallelBalanceChecker with the given jobs and
+  // chunk size finds what a BalanceChecker over a RacketTokenizer
+  // does in text.
+  void check_same_balance(std::string const &text, unsigned jobs,
+                          std::size_t min_chunk_size) {
+    std::stringstream stream(text);
+    RacketTokenizer racket(stream, "file");
+    BalanceChecker checker(&racket);
+    Token expected = checker.check_balance();
+
+    ParallelBalanceChecker parallel(text.data(), text.data() + text.size(),
+                                    "file", jobs, min_chunk_size);
+    expect_same_token(parallel.check_balance(), expected, text);
+  }
+};
+
+TEST_F(ParallelBalanceCheckerTest, SameBalance) {
+  std::string const texts[] = {
+    "", "(* ({+[8 7]} 9))", ";blue({))}\n(+[3 5])",
+    "(stringeq(\"foo\", \"bar)", "{ *[+(3 5) 9] ]", "\"cool(({\" {(12345)}",
+    "(\n(\n)\n)\n)\n", "(\n[\n)\n]\n", "\"a\n(\n\"\n)\n", ";(\n\")\n\\\"\n\""
+  };
+  for (std::string const &text : texts) {
+    for (std::size_t chunk_size = 1; chunk_size < 8; ++chunk_size)
+      check_same_balance(text, 4, chunk_size);
+    check_same_balance(text, 1, ParallelBalanceChecker::kMinChunkSize);
+  }
+}
+
+TEST_F(ParallelBalanceCheckerTest, StringsAcrossChunks) {
+  // Every line but the first starts inside the string; so, every
+  // chunk after the first is guessed wrong.
+  std::string text = "(\"";
+  for (int i = 0; i < 100; ++i)
+    text += ")]}\n";
+  check_same_balance(text + "\")", 8, 1);
+  check_same_balance(text + "\"]", 8, 1);
+  check_same_balance(text, 8, 1);
+}
+
+TEST_F(ParallelBalanceCheckerTest, SameBalanceRandom) {
+  // Mostly balanced text (so that errors aren't all found in the
+  // first chunk) with some noise.
+  std::default_random_engine random(221);
+  std::string const openers = "([{", closers = ")]}";
+  std::string const noise = kRandomTextAlphabet;
+  for (int i = 0; i < 300; ++i) {
+    std::string text, stack;
+    std::size_t length = random() % 2000;
+    while (text.size() < length) {
+      int choice = random() % 10;
+      if (choice < 3) {
+        char opener = openers[random() % openers.size()];
+        text += opener;
+        stack += closers[openers.find(opener)];
+      } else if (choice < 6 && !stack.empty()) {
+        text += stack.back();
+        stack.pop_back();
+      } else if (choice < 9) {
+        text += "x\n";
+      } else if (random() % 20 == 0) {
+        text += noise[random() % noise.size()];
+      }
+    }
+    check_same_balance(text, 1 + random() % 8, 1 + random() % 64);
+  }
+}
+}  // namespace tokenizer
@@ -0,0 +1,153 @@
+// pipelined_balance_checker.cc --- Defines the PipelinedBalanceChecker
+// class, which tokenizes a Racket program on one thread while checking
+// its balance on another.
+
+// pipelined_balance_checker.cc is Copyright (C) 2014 by the University
+// of British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#include "./pipelined_balance_checker.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "./basic_balance_checker.h"
+#include "./bracket_tokenizer.h"
+#include "./racket_tokenizer.h"
+#include "./small_token_stack.h"
+#include "./spsc_ring.h"
+#include "./token_record.h"
+
+namespace tokenizer {
+namespace {
+// A token as it passes through the ring: its record, and the line and
+// column the record leaves out (there being no LineIndex of the input
+// for the checker to work them out from).  A structural token's data
+// goes by its type.
+struct PipelinedToken {
+  TokenRecord record;
+  std::int32_t line;
+  std::int32_t column;
+};
+
+typedef SpscRing<PipelinedToken> TokenRing;
+
+// Tokens cross the ring in batches of (up to) this many.
+std::size_t const kBatchSize = 64;
+
+// The checker's end of the ring, as a tokenizer.
+class RingTokenizer final : public Tokenizer {
+ public:
+  explicit RingTokenizer(TokenRing *ring) : ring_(ring) { }
+
+  virtual Token next_token() {
+    while (next_ == end_) {
+      end_ = ring_->pop(batch_, kBatchSize);
+      next_ = 0;
+      if (end_ == 0)
+        std::this_thread::yield();
+    }
+    PipelinedToken const &token = batch_[next_++];
+    TokenRecord const &record = token.record;
+    StringView data;
+    if (!record.is_eof())
+      data = RacketTokenizer::structural_type_data(record.type);
+    return Token(record.type, data, nullptr, nullptr, record.file_id,
+                 token.line, token.line, token.column,
+                 token.column + static_cast<int>(record.length),
+                 record.offset);
+  }
+
+  virtual bool are_matching(Token const & opener, Token const & closer) const {
+    return RacketTokenizer::are_matching_types(opener.type(), closer.type());
+  }
+
+  virtual bool is_opening(Token const & token) const {
+    return RacketTokenizer::is_opening_type(token.type());
+  }
+
+  virtual bool is_closing(Token const & token) const {
+    return RacketTokenizer::is_closing_type(token.type());
+  }
+
+ private:
+  TokenRing *ring_;
+  PipelinedToken batch_[kBatchSize];
+  std::size_t next_ = 0;
+  std::size_t end_ = 0;
+};
+
+// Pushes all count tokens onto ring, waiting for room as need be,
+// unless the ring is closed first.  Returns whether they all went.
+bool push_all(PipelinedToken const *tokens, std::size_t count,
+              TokenRing *ring) {
+  while (!ring->closed()) {
+    std::size_t pushed = ring->push(tokens, count);
+    tokens += pushed;
+    count -= pushed;
+    if (count == 0)
+      return true;
+    std::this_thread::yield();
+  }
+  return false;
+}
+
+// Closes the ring and waits for the producer when the checker is done
+// with it, however it leaves: the producer would otherwise wait on a
+// full ring forever, and a joinable thread's destructor terminates.
+class ProducerGuard {
+ public:
+  ProducerGuard(TokenRing *ring, std::thread *producer)
+      : ring_(ring), producer_(producer) { }
+  ProducerGuard(ProducerGuard const &) = delete;
+  ProducerGuard &operator=(ProducerGuard const &) = delete;
+
+  ~ProducerGuard() {
+    ring_->close();
+    producer_->join();
+  }
+
+ private:
+  TokenRing *ring_;
+  std::thread *producer_;
+};
+}  // namespace
+
+std::size_t const PipelinedBalanceChecker::kDefaultRingCapacity;
+
+Token PipelinedBalanceChecker::check_balance() {
+  TokenRing ring(std::max(ring_capacity_, kBatchSize));
+
+  std::thread producer([this, &ring]() {
+    BracketTokenizer tokenizer(in_, filename_);
+    PipelinedToken batch[kBatchSize];
+    std::size_t count = 0;
+    for (;;) {
+      Token token = tokenizer.next_token();
+      bool at_eof = token.is_eof();
+      PipelinedToken &pipelined = batch[count++];
+      pipelined.record = token.record();
+      pipelined.line = token.start_line();
+      pipelined.column = token.start_column();
+      // A checker that has stopped closes the ring; so it's only
+      // looked at between batches (before each is pushed).
+      if (count == kBatchSize || at_eof) {
+        if (!push_all(batch, count, &ring))
+          break;
+        tokens_produced_ += count;
+        count = 0;
+      }
+      if (at_eof)
+        break;
+    }
+  });
+
+  ProducerGuard guard(&ring, &producer);
+  RingTokenizer tokenizer(&ring);
+  BasicBalanceChecker<RingTokenizer, SmallTokenStack> checker(&tokenizer);
+  return checker.check_balance();
+}
+}  // namespace tokenizer
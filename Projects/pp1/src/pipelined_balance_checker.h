@@ -0,0 +1,75 @@
+// pipelined_balance_checker.h --- Declares the
+// PipelinedBalanceChecker class, which tokenizes a Racket program on
+// one thread while checking its balance on another.  Part of the
+// RackaBrackaStack project.
+
+// pipelined_balance_checker.h is Copyright (C) 2014 by the University
+// of British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#ifndef RACKET_BRACKET_STACK_PIPELINED_BALANCE_CHECKER_H_
+#define RACKET_BRACKET_STACK_PIPELINED_BALANCE_CHECKER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+
+#include "./token.h"
+
+namespace tokenizer {
+// Gives the same answer as a BalanceChecker over a RacketTokenizer
+// (or a BracketTokenizer) for the same stream, in the same form.
+//
+// A producer thread reads and tokenizes the stream with a
+// BracketTokenizer and pushes compact records of the tokens (type,
+// character and position) onto an SpscRing, a batch at a time, while
+// the calling thread pops them and checks them with a
+// BasicBalanceChecker.  So reading and tokenizing overlap with
+// checking.  The ring is bounded: a producer that gets ring_capacity
+// tokens ahead waits for the checker to catch up.  And once the
+// checker finds an imbalance it closes the ring, and the producer
+// stops reading.
+//
+// Waiting (on either side) yields the processor rather than blocking,
+// so a pipeline pays off with a core for each thread.
+class PipelinedBalanceChecker {
+ public:
+  // Constructs a checker for in, which must outlive it, that will
+  // report tokens as coming from the given file and let the
+  // tokenizer get up to about ring_capacity (> 0) tokens ahead.
+  PipelinedBalanceChecker(std::istream &in, std::string const &filename,
+                          std::size_t ring_capacity = kDefaultRingCapacity)
+      : in_(in), filename_(filename), ring_capacity_(ring_capacity) { }
+
+  PipelinedBalanceChecker(PipelinedBalanceChecker const &) = delete;
+  PipelinedBalanceChecker &operator=(PipelinedBalanceChecker const &) =
+      delete;
+
+  // Returns what BalanceChecker::check_balance would: the first
+  // closing token that does not match, else the innermost opening
+  // token never closed, else the EOF token.  (Reads the stream only
+  // once; call it once.)
+  Token check_balance();
+
+  // How many tokens, EOF included, the producer passed to the
+  // checker before it stopped (all of them, unless there was an
+  // imbalance).
+  std::uint64_t tokens_produced() const {
+    return tokens_produced_;
+  }
+
+  static std::size_t const kDefaultRingCapacity = 1 << 14;
+
+ private:
+  std::istream &in_;
+  std::string filename_;
+  std::size_t ring_capacity_;
+  std::uint64_t tokens_produced_ = 0;
+};
+}  // namespace tokenizer
+
+#endif  // RACKET_BRACKET_STACK_PIPELINED_BALANCE_CHECKER_H_
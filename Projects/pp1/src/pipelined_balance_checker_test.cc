@@ -0,0 +1,86 @@
+// pipelined_balance_checker_test.cc --- Test code for the
+// PipelinedBalanceChecker class.
+
+// pipelined_balance_checker_test is Copyright (C) 2014 by CPSC 221 at
+// the University of British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#include <gmock/gmock.h>
+using ::testing::Eq;
+using ::testing::Lt;
+#include <gtest/gtest.h>
+using ::testing::Test;
+
+#include <random>
+#include <sstream>
+#include <string>
+
+#include "./balance_checker.h"
+#include "./pipelined_balance_checker.h"
+#include "./racket_tokenizer.h"
+#include "./tokenizer_test_util.h"
+
+namespace tokenizer {
+class PipelinedBalanceCheckerTest : public Test {
+ protected:
+  PipelinedBalanceCheckerTest() { }
+
+  virtual ~PipelinedBalanceCheckerTest() { }
+
+  // Checks that a PipelinedBalanceChecker with the given ring gives
+  // the answer a BalanceChecker over a RacketTokenizer does for text.
+  void check_same_answer(std::string const &text,
+                         std::size_t ring_capacity) {
+    std::stringstream racket_stream(text), pipelined_stream(text);
+    RacketTokenizer racket(racket_stream, "file");
+    BalanceChecker racket_checker(&racket);
+    Token expected = racket_checker.check_balance();
+
+    PipelinedBalanceChecker checker(pipelined_stream, "file", ring_capacity);
+    expect_same_token(checker.check_balance(), expected, text);
+  }
+};
+
+TEST_F(PipelinedBalanceCheckerTest, EmptyFile) {
+  std::stringstream stream("");
+  PipelinedBalanceChecker checker(stream, "file");
+  EXPECT_TRUE(checker.check_balance().is_eof());
+  EXPECT_THAT(checker.tokens_produced(), Eq(1u));
+}
+
+TEST_F(PipelinedBalanceCheckerTest, SameAnswerAsBalanceChecker) {
+  std::string const texts[] = {
+    "(* ({+[8 7]} 9))", ";blue({))}\n(+[3 5])", "(stringeq(\"foo\", \"bar)",
+    "{ *[+(3 5) 9] ]", "\"cool(({\" {(12345)}", "(/(+ (3 5)) 6 ",
+    "(define (f x) ;; cmt\r\n  {\"s\\\"\" [x]})\n"
+  };
+  for (std::string const &text : texts) {
+    check_same_answer(text, 1);
+    check_same_answer(text, PipelinedBalanceChecker::kDefaultRingCapacity);
+  }
+
+  // Long enough to fill small rings many times over.
+  std::default_random_engine random(221);
+  for (int i = 0; i < 50; ++i) {
+    std::string text = random_text(&random, 5000);
+    check_same_answer(text, 1 << (random() % 10));
+  }
+  std::string deep = std::string(20000, '(') + std::string(20000, ')');
+  check_same_answer(deep, 64);
+  check_same_answer(deep + "]", 64);
+}
+
+TEST_F(PipelinedBalanceCheckerTest, StopsAtAnImbalance) {
+  // Once the checker sees the ], the tokenizer should stop short of
+  // the rest.
+  std::string text = "(]" + std::string(1 << 20, '(');
+  std::stringstream stream(text);
+  PipelinedBalanceChecker checker(stream, "file", 128);
+  Token token = checker.check_balance();
+  EXPECT_THAT(token.data(), Eq("]"));
+  EXPECT_THAT(checker.tokens_produced(), Lt(1u << 16));
+}
+}  // namespace tokenizer
@@ -10,44 +10,96 @@
 // International License. To view a copy of this license, visit
 // http://creativecommons.org/licenses/by/4.0/.
 
+#include <cstdlib>
 #include <string>
-#include <fstream>
 #include <iostream>     // std::cout
+#include <thread>
+#include <vector>
 
-#include "./racket_tokenizer.h"
-#include "./balance_checker.h"
+#include "./batch_checker.h"
+#include "./mapped_file.h"
+#include "./parallel_balance_checker.h"
 #include "./token.h"
-#include "./tokenizer.h"
+
+namespace {
+void print_usage(char const *program) {
+  std::cerr << "Usage: " << program << " [--mmap] [--pipeline] [--jobs=N] <path>..."
+            << std::endl;
+  std::cerr << "\tReads in the Racket programs named "
+            << "and reports any unbalanced brackets." << std::endl;
+  std::cerr << "\tA directory names every .rkt file beneath it, and a "
+            << "filename of -" << std::endl
+            << "\treads standard input.  Results are printed in the "
+            << "order given; the" << std::endl
+            << "\texit status is 1 if any program is unbalanced, 2 if "
+            << "any can't be read." << std::endl;
+  std::cerr << "\tWith --mmap, a regular file is mapped into memory and "
+            << "only its" << std::endl
+            << "\tbrackets and quotation marks are tokenized (anything "
+            << "else is still" << std::endl
+            << "\tstreamed)." << std::endl;
+  std::cerr << "\tWith --pipeline, a streamed file is tokenized on one "
+            << "thread while its" << std::endl
+            << "\tbalance is checked on another." << std::endl;
+  std::cerr << "\tWith --jobs=N, up to N threads check files at once "
+            << "(by default, one" << std::endl
+            << "\tper core).  A single file given --jobs=N is mapped and "
+            << "checked in" << std::endl
+            << "\tchunks on up to N threads." << std::endl;
+}
+}  // namespace
 
 int main(int argc, char* argv[]) {
-  if (argc != 2) {
-    std::cerr << "Usage: " << argv[0] << " <filename>" << std::endl;
-    std::cerr << "\tReads in Racket program <filename> "
-              << "and reports any unbalanced brackets." << std::endl;
-    std::cerr << "\tPlease provide exactly one filename as an argument!"
-              << std::endl;
+  // Options come before the paths.
+  bool use_mmap = false;
+  bool pipelined = false;
+  unsigned jobs = 0;
+  int first_path = 1;
+  for (; first_path < argc - 1; ++first_path) {
+    std::string option = argv[first_path];
+    if (option == "--mmap") {
+      use_mmap = true;
+    } else if (option == "--pipeline") {
+      pipelined = true;
+    } else if (option.compare(0, 7, "--jobs=") == 0 &&
+               std::atoi(option.c_str() + 7) > 0) {
+      jobs = std::atoi(option.c_str() + 7);
+    } else {
+      break;
+    }
+  }
+  std::vector<std::string> paths(argv + first_path, argv + argc);
+  if (paths.empty() || paths[0].compare(0, 2, "--") == 0) {
+    print_usage(argv[0]);
     return -1;
   }
+  std::vector<std::string> file_names = tokenizer::expand_paths(paths);
 
-  // Open the file passed as an argument.
-  std::string file_name = argv[1];
-  std::ifstream file_stream;
-  file_stream.open(file_name, std::ifstream::in);
-
-  // Build a tokenizer over the file and a balance checker over the
-  // tokenizer.
-  tokenizer::RacketTokenizer tokenizer(file_stream, file_name);
-  tokenizer::BalanceChecker bchecker(&tokenizer);
-
-  // TODO(you): use the balance checker to determine if anything needs to
-  // be printed and, if so, to print out the problem.
-
-  const tokenizer::Token token = bchecker.check_balance();
-  if (!token.is_eof()) {
-    std::cout << token.filename() << ":"
-        << token.end_line() << ":" << token.start_column() << ":  "
-        << "\'" << token.data() << "\' is causing an imbalance" << std::endl;
+  // One file given --jobs is mapped, if possible, and checked in
+  // parallel chunks.
+  tokenizer::MappedFile mapped_file;
+  if (paths.size() == 1 && file_names.size() == 1 && jobs > 0 &&
+      file_names[0] != "-" && mapped_file.map(file_names[0])) {
+    tokenizer::ParallelBalanceChecker bchecker(mapped_file.begin(),
+                                               mapped_file.end(),
+                                               file_names[0], jobs);
+    tokenizer::Token token = bchecker.check_balance();
+    std::cout << tokenizer::imbalance_report(token);
+    return token.is_eof() ? 0 : 1;
   }
 
-  return 0;
+  // Otherwise, check every file (only the brackets and quotation marks
+  // matter), spread over a pool of threads.
+  if (jobs == 0)
+    jobs = std::thread::hardware_concurrency();
+  bool all_opened = true;
+  bool all_balanced = true;
+  for (tokenizer::FileCheckResult const &result :
+           tokenizer::check_files(file_names, jobs, use_mmap,
+                                  pipelined)) {
+    (result.opened ? std::cout : std::cerr) << result.report;
+    all_opened = all_opened && result.opened;
+    all_balanced = all_balanced && result.balanced;
+  }
+  return !all_opened ? 2 : all_balanced ? 0 : 1;
 }
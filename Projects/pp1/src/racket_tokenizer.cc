@@ -12,154 +12,351 @@
 
 #include "./racket_tokenizer.h"
 
+#include <cstring>
 #include <istream>
+#include <memory>
+#include <string>
 
 namespace tokenizer {
 typedef RacketTokenizer RT;
 
+namespace {
+// The structural characters, in the order of their token types.
+char const kStructuralCharacters[] = "()[]{}\"";
+}  // namespace
+
 // Repeatedly consume a character and peek at another in order to
 // update the state until the next token is ready to be produced.
-Token RT::next_token() {
-  int next_line, next_column;
-  TokenizerState next_state;
-  bool emit_token;
-  TokenType token_type;
-  char consumed_char, peek_char;
-  bool is_eof;
-  bool move_cr_special_case = false;
+inline int RT::scan_token(bool *move_cr_special_case) {
+  TransitionTable const &table = transition_table();
+  Transition transition;
 
   do {
-    // Setting a default value so this will be initialized in the
-    // kInit/kAtEof states.  In those states, the consumed character
-    // doesn't matter, since we do not consume characters before
-    // starting or after hitting EOF.
-    consumed_char = '\0';
-    if (state_ == kInit) {
-      next_line = 1;
-      next_column = 1;
-    } else if (state_ == kAtEof) {
-      is_eof = true;
-    } else {
-      in_.get(consumed_char);
-      data_.push_back(consumed_char);
-
-      calculate_next_position(consumed_char, line_, column_,
-                              &next_line, &next_column);
-      line_ = next_line;
-      column_ = next_column;
+    // We do not consume characters before starting or after hitting
+    // EOF.
+    CharClass peek_class = kEofChar;
+    if (state_ != kAtEof) {
+      if (state_ != kInit) {
+        // There is always a character here: we only leave kInit (or
+        // any other state besides kAtEof) after peeking at it.
+        ++pos_;
+      }
+      if (fill_buffer())
+        peek_class = static_cast<CharClass>(
+            table.char_class[static_cast<unsigned char>(*pos_)]);
     }
-    peek_char = in_.peek();
-    is_eof = in_.eof();
 
-    calculate_next_state(consumed_char, peek_char, is_eof,
-                         &next_state, &emit_token, &token_type);
+    transition = table.transitions[state_][peek_class];
 
     // Keep track of the special case.
-    move_cr_special_case =
+    *move_cr_special_case =
         state_ == kAtCommentCR &&
-        next_state == kAtWhitespace;
+        transition.next_state == kAtWhitespace;
+
+    state_ = static_cast<TokenizerState>(transition.next_state);
+  } while (!transition.emit_token);
+  return transition.token_type;
+}
 
-    state_ = next_state;
-  } while (!emit_token);
+Token RT::next_token() {
+  bool move_cr_special_case;
+  int type = scan_token(&move_cr_special_case);
 
   // Handle the \r on a comment special case by stripping it from
-  // this token's data (and its column count).
+  // this token's data.  It's the last
+  // character consumed: in this block, unless the peek at the \n
+  // moved on to a new one.
+  char const *data_end = pos_;
+  std::uint64_t end_offset = block_offset_ + (pos_ - block_begin_);
+  bool cr_in_block = false;
   if (move_cr_special_case) {
-    assert(data_.size() > 0 && data_.back() == '\r');
-    data_.pop_back();
-    column_--;
+    cr_in_block = data_start_ != pos_;
+    if (cr_in_block) {
+      data_end--;
+    } else {
+      assert(data_.size() > 0 && data_.back() == '\r');
+      data_.pop_back();
+    }
+    assert(*data_end == '\r' || !cr_in_block);
+    end_offset--;
   }
 
-  // Produce the token to emit.
-  Token token(token_type, data_, filename_,
-              start_line_, line_,
-              start_column_, column_);
+  // Produce the token to emit, as a view of the block when it's all
+  // there.
+  StringView data(data_start_, data_end - data_start_);
+  std::shared_ptr<Block> owner = block_;
+  if (!data_.empty()) {
+    data_.append(data_start_, data_end);
+    owner = std::make_shared<Block>(0);
+    owner->chars.assign(data_.begin(), data_.end());
+    owner->offset = start_offset_;
+    data = StringView(owner->chars.data(), owner->chars.size());
+    owner->line_index.assign(data.begin(), data.end(), start_offset_,
+                             start_line_, start_column_);
+  }
+  Token token(type, data, owner, nullptr, file_id_, start_offset_,
+              &owner->line_index);
 
   // Prepare for the next token.
-  data_ = "";
-  start_line_ = line_;
-  start_column_ = column_;
+  data_.clear();
+  data_start_ = data_end;
+  start_offset_ = end_offset;
 
-  // Handle the special case by adding the \r to this token's data
-  // and patching the column count.
-  if (move_cr_special_case) {
-    data_.push_back('\r');
-    column_++;
-  }
+  // Handle the special case by adding the \r to the next token's
+  // data.
+  if (move_cr_special_case && !cr_in_block)
+    move_cr_to_data();
 
   return token;
 }
 
-void RT::calculate_next_position(char c, int line_in, int column_in,
-                                 int *line_out, int *column_out) {
-  switch (c) {
-    case '\n':
-      (*line_out) = line_in + 1;
-      (*column_out) = 1;
-      break;
-    default:
-      (*line_out) = line_in;
-      (*column_out) = column_in + 1;
+// As next_token, but recording each token's extent rather than
+// gathering its data.
+std::size_t RT::next_tokens(TokenRecord *buffer, std::size_t max) {
+  batch_blocks_.clear();
+  in_next_tokens_ = true;
+  std::size_t count = 0;
+  while (count < max) {
+    bool move_cr_special_case;
+    int type = scan_token(&move_cr_special_case);
+
+    char const *data_end = pos_;
+    std::uint64_t end_offset = block_offset_ + (pos_ - block_begin_);
+    bool cr_in_block = false;
+    if (move_cr_special_case) {
+      cr_in_block = data_start_ != pos_;
+      if (cr_in_block)
+        data_end--;
+      end_offset--;
+    }
+
+    TokenRecord &record = buffer[count++];
+    record.offset = start_offset_;
+    record.length = static_cast<std::uint32_t>(end_offset - start_offset_);
+    record.file_id = file_id_;
+    record.type = type;
+
+    data_.clear();
+    data_start_ = data_end;
+    start_offset_ = end_offset;
+    if (move_cr_special_case && !cr_in_block)
+      move_cr_to_data();
+    if (type == kEof)
       break;
   }
+  in_next_tokens_ = false;
+  return count;
 }
 
-RT::TokenType RT::characteristic_type(char c, bool is_eof) {
-  if (is_eof) {
-    return kEof;
+Token RT::token_for(TokenRecord const &record, std::size_t) const {
+  StringView data;
+  if (is_opening_type(record.type) || is_closing_type(record.type)) {
+    data = structural_type_data(record.type);
+  } else if (record.offset >= block_offset_ &&
+             record.offset + record.length <=
+             block_offset_ + (end_ - block_begin_)) {
+    data = StringView(block_begin_ + (record.offset - block_offset_),
+                      record.length);
   }
+  std::shared_ptr<Block> const *block = block_of(record);
+  if (block == nullptr) {
+    return Token(record.type, data, nullptr, nullptr, record.file_id,
+                 record.offset, nullptr);
+  }
+  return Token(record.type, data, *block, nullptr, record.file_id,
+               record.offset, &(*block)->line_index);
+}
 
+std::shared_ptr<RT::Block> const *RT::block_of(
+    TokenRecord const &record) const {
+  if (record.offset >= block_offset_)
+    return &block_;
+  for (std::shared_ptr<Block> const &block : batch_blocks_) {
+    if (record.offset >= block->offset &&
+        record.offset - block->offset < block->chars.size())
+      return &block;
+  }
+  return nullptr;
+}
+
+RT::TokenType RT::structural_type(char c) {
   switch (c) {
     case '(':
       return kOpenParen;
+    case ')':
+      return kCloseParen;
     case '[':
       return kOpenBracket;
+    case ']':
+      return kCloseBracket;
     case '{':
       return kOpenBrace;
+    case '}':
+      return kCloseBrace;
+    default:
+      assert(c == '"');
+      return kQuotationMark;
+  }
+}
+
+StringView RT::structural_data(char c) {
+  char const *data = std::strchr(kStructuralCharacters, c);
+  assert(data != nullptr && c != '\0');
+  return StringView(data, 1);
+}
+
+StringView RT::structural_type_data(int type) {
+  assert(is_opening_type(type) || is_closing_type(type));
+  return StringView(&kStructuralCharacters[type - kOpenParen], 1);
+}
+
+RT::TransitionTable const &RT::transition_table() {
+  static TransitionTable const table = [] {
+    TransitionTable table;
+    for (int c = 0; c < 256; ++c)
+      table.char_class[c] = characteristic_class(static_cast<char>(c));
+    for (int state = 0; state < kNumStates; ++state) {
+      for (int peek_class = 0; peek_class < kNumCharClasses; ++peek_class) {
+        table.transitions[state][peek_class] =
+            calculate_transition(static_cast<TokenizerState>(state),
+                                 static_cast<CharClass>(peek_class));
+      }
+    }
+    return table;
+  }();
+  return table;
+}
+
+void RT::refill_buffer() {
+  // (Over memory, there's no more input, and the memory stays.)
+  if (in_ == nullptr)
+    return;
+  // Save the partial token before its characters are overwritten.
+  flush_data();
+
+  // Work out where the next block starts (and where the token under
+  // construction does, if it's in this block) before this one goes.
+  // next_tokens keeps it if its tokens might start in it.
+  bool token_in_block = start_offset_ >= block_offset_;
+  char const *token_start = token_in_block ?
+      block_begin_ + (start_offset_ - block_offset_) : block_begin_;
+  LineIndex::advance(block_begin_, token_start, &block_line_, &block_column_);
+  if (token_in_block) {
+    start_line_ = block_line_;
+    start_column_ = block_column_;
+  }
+  LineIndex::advance(token_start, end_, &block_line_, &block_column_);
+  if (in_next_tokens_ && end_ != block_begin_ &&
+      (token_in_block || end_[-1] == '\r'))
+    batch_blocks_.push_back(block_);
+
+  block_offset_ += end_ - block_begin_;
+  if (block_.use_count() > 1)
+    block_ = std::make_shared<Block>(block_size_);
+  in_->read(block_->chars.data(), block_size_);
+  block_begin_ = block_->chars.data();
+  pos_ = block_begin_;
+  end_ = pos_ + in_->gcount();
+  data_start_ = pos_;
+  block_->offset = block_offset_;
+  block_->line_index.assign(pos_, end_, block_offset_, block_line_,
+                            block_column_);
+}
+
+RT::CharClass RT::characteristic_class(char c) {
+  switch (c) {
+    case '(':
+      return kOpenParenChar;
+    case '[':
+      return kOpenBracketChar;
+    case '{':
+      return kOpenBraceChar;
     case ')':
-      return kCloseParen;
+      return kCloseParenChar;
     case ']':
-      return kCloseBracket;
+      return kCloseBracketChar;
     case '}':
-      return kCloseBrace;
+      return kCloseBraceChar;
     case '"':
-      return kQuotationMark;
-    case ' ':
-    case '\t':
+      return kQuoteChar;
+    case '\\':
+      return kBackslashChar;
+    case ';':
+      return kSemicolonChar;
     case '\n':
+      return kNewlineChar;
     case '\r':
+      return kReturnChar;
+    case ' ':
+    case '\t':
+      return kBlankChar;
+    default:
+      return kOtherChar;
+  }
+}
+
+RT::TokenType RT::state_token_type(TokenizerState state) {
+  switch (state) {
+    case kAtOpenParen:
+      return kOpenParen;
+    case kAtCloseParen:
+      return kCloseParen;
+    case kAtOpenBracket:
+      return kOpenBracket;
+    case kAtCloseBracket:
+      return kCloseBracket;
+    case kAtOpenBrace:
+      return kOpenBrace;
+    case kAtCloseBrace:
+      return kCloseBrace;
+    case kAtStartQuote:
+    case kAtEndQuote:
+      return kQuotationMark;
+    case kAtStringData:
+    case kAtEscapedStringData:
+      return kStringData;
+    case kAtWhitespace:
       return kWhitespace;
-    case ';':
+    case kAtComment:
+    case kAtCommentCR:
       return kComment;
+    case kAtEof:
+      return kEof;
+    case kInit:
+    case kAtToken:
     default:
+      // (No tokens are emitted from kInit.)
       return kToken;
   }
 }
 
-RT::TokenizerState
-RT::characteristic_next_state(TokenType characteristic_token) {
-  switch (characteristic_token) {
-    case kOpenParen:
-    case kOpenBracket:
-    case kOpenBrace:
-    case kCloseParen:
-    case kCloseBracket:
-    case kCloseBrace:
-      return kAtBraces;
-    case kQuotationMark:
+RT::TokenizerState RT::characteristic_next_state(CharClass peek_class) {
+  switch (peek_class) {
+    case kOpenParenChar:
+      return kAtOpenParen;
+    case kCloseParenChar:
+      return kAtCloseParen;
+    case kOpenBracketChar:
+      return kAtOpenBracket;
+    case kCloseBracketChar:
+      return kAtCloseBracket;
+    case kOpenBraceChar:
+      return kAtOpenBrace;
+    case kCloseBraceChar:
+      return kAtCloseBrace;
+    case kQuoteChar:
       return kAtStartQuote;
-    case kWhitespace:
+    case kNewlineChar:
+    case kReturnChar:
+    case kBlankChar:
       return kAtWhitespace;
-    case kComment:
+    case kSemicolonChar:
       return kAtComment;
-    case kToken:
+    case kBackslashChar:
+    case kOtherChar:
       return kAtToken;
-    case kEof:
+    case kEofChar:
       return kAtEof;
-    case kStringData:
-      // Not really a meaningful case, since string data has no
-      // characteristic state it goes to.
-      return kAtStringData;
     default:
       // Should be no other possibility.
       assert(false);
@@ -169,135 +366,111 @@ RT::characteristic_next_state(TokenType characteristic_token) {
 
 // This implements a DFA's transition function (think: CPSC 121).  We
 // drew the DFA but did not include in the distribution.. sorry!
-void RT::calculate_next_state(char consumed_char, char peek_char,
-                              bool peek_is_eof,
-                              RT::TokenizerState *next_state,
-                              bool *emit_token,
-                              RT::TokenType *token_type) {
-  TokenType peek_characteristic_token =
-      characteristic_type(peek_char, peek_is_eof);
-  TokenType consume_characteristic_token =
-      characteristic_type(consumed_char, false);
-
-  (*next_state) = characteristic_next_state(peek_characteristic_token);
-  (*emit_token) = true;
-  (*token_type) = consume_characteristic_token;
-
-  switch (state_) {
+RT::Transition RT::calculate_transition(TokenizerState state,
+                                        CharClass peek_class) {
+  TokenizerState next_state = characteristic_next_state(peek_class);
+  bool emit_token = true;
+
+  switch (state) {
     case kInit:
       // No tokens emitted from this state.
-      (*emit_token) = false;
+      emit_token = false;
       break;
-    case kAtBraces:
+    case kAtOpenParen:
+    case kAtCloseParen:
+    case kAtOpenBracket:
+    case kAtCloseBracket:
+    case kAtOpenBrace:
+    case kAtCloseBrace:
       // Defaults all correct.
       break;
     case kAtStartQuote:
-      if (peek_is_eof) {
-        (*next_state) = kAtEof;
-      } else {
-        switch (peek_char) {
-          case '"':
-            (*next_state) = kAtEndQuote;
-            break;
-          case '\\':
-            (*next_state) = kAtEscapedStringData;
-            break;
-          default:
-            (*next_state) = kAtStringData;
-            break;
-        }
+      switch (peek_class) {
+        case kEofChar:
+          next_state = kAtEof;
+          break;
+        case kQuoteChar:
+          next_state = kAtEndQuote;
+          break;
+        case kBackslashChar:
+          next_state = kAtEscapedStringData;
+          break;
+        default:
+          next_state = kAtStringData;
+          break;
       }
       break;
     case kAtStringData:
-      (*token_type) = kStringData;
-      if (peek_is_eof) {
-        (*next_state) = kAtEof;
-      } else {
-        switch (peek_char) {
-          case '"':
-            (*next_state) = kAtEndQuote;
-            break;
-          case '\\':
-            (*emit_token) = false;
-            (*next_state) = kAtEscapedStringData;
-            break;
-          default:
-            (*emit_token) = false;
-            (*next_state) = kAtStringData;
-        }
+      switch (peek_class) {
+        case kEofChar:
+          next_state = kAtEof;
+          break;
+        case kQuoteChar:
+          next_state = kAtEndQuote;
+          break;
+        case kBackslashChar:
+          emit_token = false;
+          next_state = kAtEscapedStringData;
+          break;
+        default:
+          emit_token = false;
+          next_state = kAtStringData;
+          break;
       }
       break;
     case kAtEscapedStringData:
-      (*token_type) = kStringData;
-      if (peek_is_eof) {
-        (*next_state) = kAtEof;
+      if (peek_class == kEofChar) {
+        next_state = kAtEof;
       } else {
-        (*emit_token) = false;
-        (*next_state) = kAtStringData;
+        emit_token = false;
+        next_state = kAtStringData;
       }
       break;
     case kAtEndQuote:
-      // Defaults all correct.  COULD be merged with kAtBraces, but
+      // Defaults all correct.  COULD be merged with the braces, but
       // although that's technically correct, it feels wrong.
       break;
     case kAtWhitespace:
       // Do not emit a token if we're just seeing more whitespace.
-      if (peek_characteristic_token == kWhitespace)
-        (*emit_token) = false;
+      if (next_state == kAtWhitespace)
+        emit_token = false;
       break;
     case kAtComment:
-      (*token_type) = kComment;
-      if (peek_is_eof) {
-        (*next_state) = kAtEof;
-      } else {
-        switch (peek_char) {
-          case '\n':
-            (*next_state) = kAtWhitespace;
-            break;
-          case '\r':
-            (*emit_token) = false;
-            (*next_state) = kAtCommentCR;
-            break;
-          default:
-            (*emit_token) = false;
-            (*next_state) = kAtComment;
-            break;
-        }
-      }
-      break;
     case kAtCommentCR:
-      (*token_type) = kComment;
-      if (peek_is_eof) {
-        (*next_state) = kAtEof;
-      } else {
-        switch (peek_char) {
-          case '\n':
-            (*next_state) = kAtWhitespace;
-            break;
-          case '\r':
-            (*emit_token) = false;
-            (*next_state) = kAtCommentCR;
-            break;
-          default:
-            (*emit_token) = false;
-            (*next_state) = kAtComment;
-            break;
-        }
+      switch (peek_class) {
+        case kEofChar:
+          next_state = kAtEof;
+          break;
+        case kNewlineChar:
+          next_state = kAtWhitespace;
+          break;
+        case kReturnChar:
+          emit_token = false;
+          next_state = kAtCommentCR;
+          break;
+        default:
+          emit_token = false;
+          next_state = kAtComment;
+          break;
       }
       break;
     case kAtToken:
-      (*token_type) = kToken;
-      // Do not emit a token if we're just seeing more whitespace.
-      if (peek_characteristic_token == kToken)
-        (*emit_token) = false;
+      // Do not emit a token if we're just seeing more of the token.
+      if (next_state == kAtToken)
+        emit_token = false;
       break;
     case kAtEof:
-      (*token_type) = kEof;
       break;
     default:
       // No other possibility should exist.
       assert(false);
       break;
   }
+
+  Transition transition;
+  transition.next_state = static_cast<unsigned char>(next_state);
+  transition.emit_token = emit_token;
+  transition.token_type = static_cast<unsigned char>(state_token_type(state));
+  return transition;
 }
 }  // namespace tokenizer
@@ -12,12 +12,20 @@
 #ifndef RACKET_BRACKET_STACK_RACKET_TOKENIZER_H_
 #define RACKET_BRACKET_STACK_RACKET_TOKENIZER_H_
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <istream>
+#include <memory>
+#include <vector>
 
 #include <cassert>
 
+#include "./file_id.h"
+#include "./line_index.h"
+#include "./string_view.h"
 #include "./token.h"
+#include "./token_record.h"
 #include "./tokenizer.h"
 
 namespace tokenizer {
@@ -49,7 +57,7 @@ namespace tokenizer {
 // configurable to have tabs be single characters or to have a fixed
 // tabbing width and have them proceed to the next tab stop (or even
 // to take in a fixed list of tab stops).
-class RacketTokenizer : public Tokenizer {
+class RacketTokenizer final : public Tokenizer {
  public:
   enum TokenType {
     kEof = 0,       // EOF type == 0 is required by the Token type.
@@ -73,7 +81,43 @@ class RacketTokenizer : public Tokenizer {
   // Constructs a tokenizer that will report itself as reading the
   // given file.
   explicit RacketTokenizer(std::istream &in, std::string const &filename)
-      : in_(in), filename_(filename) { }
+      : RacketTokenizer(in, filename, kDefaultBlockSize) { }
+
+  // Constructs a tokenizer that will report itself as reading the
+  // given file and that reads its input block_size (> 0) characters
+  // at a time.
+  //
+  // Note: the tokenizer reads ahead of the tokens it has produced by
+  // up to a block; so, the stream's position says nothing about how
+  // far tokenizing has gotten.
+  RacketTokenizer(std::istream &in, std::string const &filename,
+                  std::size_t block_size)
+      : in_(&in), file_id_(intern_filename(filename)),
+        block_size_(block_size),
+        block_(std::make_shared<Block>(block_size)),
+        block_begin_(block_->chars.data()),
+        pos_(block_begin_), end_(block_begin_), data_start_(block_begin_) {
+    assert(block_size > 0);
+  }
+
+  // Constructs a tokenizer over the characters [begin, end) already
+  // in memory (e.g., a mapped file), which must outlive it, that will
+  // report itself as reading the given file.  The whole range is one
+  // block; the tokenizer never reads any stream.  Its tokens' data
+  // are views of the range, so it must outlive them, too.
+  RacketTokenizer(char const *begin, char const *end,
+                  std::string const &filename)
+      : in_(nullptr), file_id_(intern_filename(filename)), block_size_(0),
+        block_(std::make_shared<Block>(0)),
+        block_begin_(begin), pos_(begin), end_(end), data_start_(begin) {
+    block_->line_index.assign(begin, end, 0, 1, 1);
+  }
+
+  RacketTokenizer(RacketTokenizer const &) = delete;
+  RacketTokenizer &operator=(RacketTokenizer const &) = delete;
+
+  // How much input a tokenizer reads at a time unless told otherwise.
+  static std::size_t const kDefaultBlockSize = 64 * 1024;
 
   // Consume just enough input to produce the next token and return
   // that token.  Note: ALL tokenizers must be capable of producing
@@ -92,15 +136,39 @@ class RacketTokenizer : public Tokenizer {
   //
   // Note: RacketTokenizers do NOT add a source tokenizer to their
   // tokens; so all Tokens have the nullptr as their source.
+  //
+  // Note: a token's data is usually a view of the block of input it
+  // was read in, which the token keeps alive; only tokens split
+  // between two blocks get a copy of their own.  Tokens record only
+  // their offsets; their lines and columns are counted out in that
+  // block (from the line and column it starts at) if they're asked
+  // for.
   virtual Token next_token();
 
+  // Yes: next_tokens and token_for are this tokenizer's own.
+  virtual bool batches_natively() const {
+    return true;
+  }
+
+  // Produces the next tokens, as next_token would, but only their
+  // records: none of their data is gathered, so nothing is copied or
+  // shared per token.  (Calls to the two may be mixed.)
+  virtual std::size_t next_tokens(TokenRecord *buffer, std::size_t max);
+
+  // Gives back any token of the latest call to next_tokens whole,
+  // from its record alone (index doesn't matter).  The data of a
+  // token other than a bracket or quotation mark is only there while
+  // it's in the current block (it's empty after that).  (The blocks
+  // the latest call's tokens start in are kept for their lines and
+  // columns; a token from an earlier call whose block is gone has
+  // none.)
+  virtual Token token_for(TokenRecord const &record,
+                          std::size_t index) const;
+
   // Checks whether the two tokens are a matching pair, i.e., an
   // opening token and a closing token that closes it.
   virtual bool are_matching(Token const & opener, Token const & closer) const {
-    return (opener.type() == kOpenParen && closer.type() == kCloseParen) ||
-        (opener.type() == kOpenBracket && closer.type() == kCloseBracket) ||
-        (opener.type() == kOpenBrace && closer.type() == kCloseBrace) ||
-        (opener.type() == kQuotationMark && closer.type() == kQuotationMark);
+    return are_matching_types(opener.type(), closer.type());
   }
 
   // Checks whether this is an open token (one that opens a matching
@@ -111,10 +179,7 @@ class RacketTokenizer : public Tokenizer {
   // closes the most recent ".  As it turns out, it is also the case
   // that no other opener/closer can occur before the next ".)
   virtual bool is_opening(Token const & token) const {
-    return token.type() == kOpenParen ||
-        token.type() == kOpenBracket ||
-        token.type() == kOpenBrace ||
-        token.type() == kQuotationMark;
+    return is_opening_type(token.type());
   }
 
   // Checks whether this is a closing token (one that closes a
@@ -122,16 +187,54 @@ class RacketTokenizer : public Tokenizer {
   // closing.  (An entire string is treated as a single token, and
   // nothing else would be both opener and closer besides ".)
   virtual bool is_closing(Token const & token) const {
-    return token.type() == kCloseParen ||
-        token.type() == kCloseBracket ||
-        token.type() == kCloseBrace ||
-        token.type() == kQuotationMark;
+    return is_closing_type(token.type());
+  }
+
+  // Yes: all of the above go by type.
+  virtual bool classifies_by_type() const {
+    return true;
   }
 
+  // The above, by token type, for other tokenizers that produce
+  // RacketTokenizer's types.
+  static bool are_matching_types(int opener, int closer) {
+    return (opener == kOpenParen && closer == kCloseParen) ||
+        (opener == kOpenBracket && closer == kCloseBracket) ||
+        (opener == kOpenBrace && closer == kCloseBrace) ||
+        (opener == kQuotationMark && closer == kQuotationMark);
+  }
+  static bool is_opening_type(int type) {
+    return type == kOpenParen ||
+        type == kOpenBracket ||
+        type == kOpenBrace ||
+        type == kQuotationMark;
+  }
+  static bool is_closing_type(int type) {
+    return type == kCloseParen ||
+        type == kCloseBracket ||
+        type == kCloseBrace ||
+        type == kQuotationMark;
+  }
+
+  // The type of token a structural character (a bracket or quotation
+  // mark) makes, and that token's data, as a view of a static string,
+  // for other tokenizers that produce only those tokens.  (And the
+  // data of a structural token, from its type.)
+  static TokenType structural_type(char c);
+  static StringView structural_data(char c);
+  static StringView structural_type_data(int type);
+
  private:
+  // The braces each get a state of their own so that every state
+  // determines the type of the token it emits.
   enum TokenizerState {
     kInit,
-    kAtBraces,
+    kAtOpenParen,
+    kAtCloseParen,
+    kAtOpenBracket,
+    kAtCloseBracket,
+    kAtOpenBrace,
+    kAtCloseBrace,
     kAtStartQuote,
     kAtStringData,
     kAtEscapedStringData,
@@ -140,58 +243,159 @@ class RacketTokenizer : public Tokenizer {
     kAtComment,
     kAtCommentCR,  // In a comment, got a \r character.
     kAtToken,
-    kAtEof
+    kAtEof,
+    kNumStates
+  };
+
+  // The classes of input characters the DFA distinguishes, plus the
+  // end of the input.
+  enum CharClass {
+    kOpenParenChar,
+    kCloseParenChar,
+    kOpenBracketChar,
+    kCloseBracketChar,
+    kOpenBraceChar,
+    kCloseBraceChar,
+    kQuoteChar,
+    kBackslashChar,
+    kSemicolonChar,
+    kNewlineChar,
+    kReturnChar,
+    kBlankChar,    // Space or tab.
+    kOtherChar,
+    kEofChar,
+    kNumCharClasses
   };
 
-  // Find the next position (line/column) in the file based on the
-  // given character.
-  void calculate_next_position(char c, int line_in, int column_in,
-                               int *line_out, int *column_out);
+  // One entry of the DFA's transition function: the state to move
+  // to, whether to emit a token (before consuming the peeked-at
+  // character), and, if so, its type.
+  struct Transition {
+    unsigned char next_state;
+    bool emit_token;
+    unsigned char token_type;
+  };
+
+  // The DFA, compiled into tables: each input byte's class and the
+  // transition for every state and class of peeked-at character.
+  struct TransitionTable {
+    unsigned char char_class[256];
+    Transition transitions[kNumStates][kNumCharClasses];
+  };
 
-  // Give the "usual" token type associated with this
-  // character. What's not usual? String contents, for example,
-  // where a "(" and many other things are just more data.
-  TokenType characteristic_type(char c, bool is_eof);
+  // The transition table, built (once) from calculate_transition.
+  static TransitionTable const &transition_table();
 
-  // Give the "usual" token state associated with this type (i.e.,
-  // what we'd usually transition to for this type). What's not
-  // usual? String contents, for example, where a "(" and many other
-  // things are just more data.
-  TokenizerState characteristic_next_state(TokenType characteristic_token);
+  // Give the class of this character.
+  static CharClass characteristic_class(char c);
+
+  // Give the type of the tokens emitted from this state.
+  static TokenType state_token_type(TokenizerState state);
+
+  // Give the "usual" token state associated with this class of
+  // character (i.e., what we'd usually transition to when peeking at
+  // it). What's not usual? String contents, for example, where a "("
+  // and many other things are just more data.
+  static TokenizerState characteristic_next_state(CharClass peek_class);
 
   // Determines how to transition to the next state given the
-  // character we are currently consuming (the one that led to the
-  // last transition), the character we're peeking at (the one that
-  // is about to be consumed, if we need more characters to
-  // construct a token), and a flag to indicate whether that
-  // peeked-at character is actually the end-of-file.
-  //
-  // The transition indicates what the next state should be, whether
-  // or not to emit a token (before consuming the peeked-at
-  // character), what the token type should be (if so), and a corner
-  // case check to see whether we need to move the consumed
-  // character off of the data for the current token to emit and
-  // onto the data for the next token.
+  // current state and the class of the character we're peeking at
+  // (the one that is about to be consumed, if we need more
+  // characters to construct a token), which may be the end of the
+  // input.  This is the DFA's transition function, written out case
+  // by case; next_token uses the table compiled from it.
   //
   // WARNING: this does not handle the special case where it's hard
   // to tell whether a \r belongs with a preceding comment or a
   // succeeding \n.  That can be handled elsewhere by checking if
   // the current state is kAtCommentCR and the next state is
   // kWhitespace.  If so, the "\r" must be moved.
-  void calculate_next_state(char consumed_char, char peek_char,
-                            bool peek_is_eof,
-                            TokenizerState *next_state,
-                            bool *emit_token,
-                            TokenType *token_type);
-
-  std::istream & in_;
-  std::string filename_;
+  static Transition calculate_transition(TokenizerState state,
+                                         CharClass peek_class);
+
+  // Runs the DFA until it emits a token, and returns the token's
+  // type.  Leaves pos_ just past the token's last character but for,
+  // in the special case (*move_cr_special_case), the \r it moves to
+  // the next token.
+  int scan_token(bool *move_cr_special_case);
+
+  // Moves the characters consumed since data_start_ onto data_
+  // (before the block they're in is replaced).
+  void flush_data() {
+    data_.append(data_start_, pos_);
+    data_start_ = pos_;
+  }
+
+  // Ensures there is a character to peek at unless the input is
+  // exhausted.  Returns false at the end of the input.  This is the
+  // only place the tokenizer reads from in_.
+  bool fill_buffer() {
+    if (pos_ == end_)
+      refill_buffer();
+    return pos_ != end_;
+  }
+
+  // Reads the next block of input into the (empty) buffer, or a new
+  // one if tokens still refer to it.
+  void refill_buffer();
+
+  // In the special case, starts the next token's data with the \r
+  // that ended the last block.
+  void move_cr_to_data() {
+    data_.push_back('\r');
+    start_line_ = block_line_;
+    start_column_ = block_column_ - 1;
+  }
+
+  // A block of input and the index of its lines, for the tokens
+  // viewing it.  (Over memory, the one block is empty; the tokens view
+  // the memory, which its index covers.)
+  struct Block {
+    explicit Block(std::size_t size)
+        : chars(size), line_index(nullptr, nullptr) { }
+
+    std::vector<char> chars;
+    std::uint64_t offset = 0;     // Where in the input chars start.
+    LineIndex line_index;
+  };
+
+  // The block the record's token starts in, if it's still around
+  // (see token_for), else nullptr.
+  std::shared_ptr<Block> const *block_of(TokenRecord const &record) const;
+
+  // The stream to read blocks from or, for a tokenizer over memory,
+  // nullptr.
+  std::istream *in_;
+  FileId file_id_;
+
+  // The current block of input (shared with the tokens viewing it):
+  // pos_ is the next character to consume and end_ is just past the
+  // last character read.  The token under construction starts with
+  // data_ (which is only non-empty if it began in an earlier block)
+  // and continues from data_start_ to pos_.
+  std::size_t block_size_;
+  std::shared_ptr<Block> block_;
+  char const *block_begin_;
+  char const *pos_;
+  char const *end_;
+  char const *data_start_;
+
   TokenizerState state_ = kInit;
   std::string data_ = "";
+  // Where in the input the current block and token start, and the
+  // lines and columns they start at (the token's, only once it has
+  // outlived the block it started in).
+  std::uint64_t block_offset_ = 0;
+  std::uint64_t start_offset_ = 0;
+  int block_line_ = 1;
+  int block_column_ = 1;
   int start_line_ = 1;
   int start_column_ = 1;
-  int line_ = 1;
-  int column_ = 1;
+
+  // The blocks before the current one that the latest call to
+  // next_tokens had tokens start in (kept while it runs).
+  bool in_next_tokens_ = false;
+  std::vector<std::shared_ptr<Block> > batch_blocks_;
 };
 }  // namespace tokenizer
 
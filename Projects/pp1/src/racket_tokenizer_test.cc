@@ -18,7 +18,10 @@ using ::testing::NotNull;
 #include <gtest/gtest.h>
 using ::testing::Test;
 
+#include <cstdint>
 #include <sstream>
+#include <string>
+#include <vector>
 
 #include "./racket_tokenizer.h"
 
@@ -640,4 +643,110 @@ TEST_F(RacketTokenizerTest, RichTest) {
   check_token(&tokenizer_rich_example_,
               Token(RacketTokenizer::kEof, "", 4, 4, 10, 10));
 }
+TEST_F(RacketTokenizerTest, BlockBoundaries) {
+  // Tokens (including the \r moved off a comment) must not depend on
+  // where the blocks of input happen to split them.
+  std::string const text =
+      "(define (f x) ;; cmt\r\n  {\"str\\\"ing\\\\\" [x]})\r;\r\r \"\\";
+  std::stringstream whole_stream(text);
+  RacketTokenizer whole(whole_stream);
+  std::vector<Token> tokens;
+  do {
+    tokens.push_back(whole.next_token());
+  } while (!tokens.back().is_eof());
+
+  // Each token starts where the last one ended.
+  std::uint64_t offset = 0;
+  for (Token const &token : tokens) {
+    EXPECT_THAT(token.offset(), Eq(offset));
+    EXPECT_THAT(text.substr(offset, token.data_view().size()),
+                Eq(token.data()));
+    offset += token.data_view().size();
+  }
+  EXPECT_THAT(offset, Eq(text.size()));
+
+  for (std::size_t block_size = 1; block_size <= 8; ++block_size) {
+    std::stringstream stream(text);
+    RacketTokenizer tokenizer(stream, "", block_size);
+    for (Token const &expected : tokens) {
+      Token token = tokenizer.next_token();
+      EXPECT_THAT(token, Eq(expected));
+      EXPECT_THAT(token.record(), Eq(expected.record()));
+      EXPECT_THAT(token.start_line(), Eq(expected.start_line()));
+      EXPECT_THAT(token.start_column(), Eq(expected.start_column()));
+      EXPECT_THAT(token.end_line(), Eq(expected.end_line()));
+      EXPECT_THAT(token.end_column(), Eq(expected.end_column()));
+    }
+    check_token(&tokenizer, tokens.back());
+  }
+}
+TEST_F(RacketTokenizerTest, NextTokensMatchesNextToken) {
+  std::string const text =
+      "(define (f x) ;; cmt\r\n  {\"str\\\"ing\\\\\" [x]})\r;\r\r \"\\";
+  std::stringstream whole_stream(text);
+  RacketTokenizer whole(whole_stream);
+  std::vector<Token> tokens;
+  do {
+    tokens.push_back(whole.next_token());
+  } while (!tokens.back().is_eof());
+
+  for (std::size_t block_size = 1; block_size <= 8; ++block_size) {
+    for (std::size_t max = 1; max <= 5; max += 2) {
+      // A call to next_token now and then, too.  (Each batch's tokens
+      // are given back whole before the next call, as they must be
+      // to have their lines and columns.)
+      std::stringstream stream(text);
+      RacketTokenizer tokenizer(stream, "", block_size);
+      std::vector<TokenRecord> records;
+      std::vector<Token> batch_tokens;
+      while (records.empty() || !records.back().is_eof()) {
+        if (records.size() % 7 == 3) {
+          batch_tokens.push_back(tokenizer.next_token());
+          records.push_back(batch_tokens.back().record());
+          continue;
+        }
+        TokenRecord batch[5];
+        std::size_t count = tokenizer.next_tokens(batch, max);
+        EXPECT_TRUE(count == max || batch[count - 1].is_eof());
+        records.insert(records.end(), batch, batch + count);
+        for (std::size_t i = 0; i < count; ++i)
+          batch_tokens.push_back(tokenizer.token_for(batch[i], i));
+      }
+
+      ASSERT_THAT(records.size(), Eq(tokens.size()));
+      for (std::size_t i = 0; i < tokens.size(); ++i) {
+        EXPECT_THAT(records[i], Eq(tokens[i].record()));
+        Token const &token = batch_tokens[i];
+        EXPECT_THAT(token.start_line(), Eq(tokens[i].start_line()));
+        EXPECT_THAT(token.start_column(), Eq(tokens[i].start_column()));
+        if (!RacketTokenizer::is_opening_type(records[i].type) &&
+            !RacketTokenizer::is_closing_type(records[i].type) &&
+            !records[i].is_eof())
+          continue;
+        EXPECT_THAT(token, Eq(tokens[i]));
+        EXPECT_THAT(token.start_line(), Eq(tokens[i].start_line()));
+        EXPECT_THAT(token.start_column(), Eq(tokens[i].start_column()));
+        EXPECT_THAT(token.end_column(), Eq(tokens[i].end_column()));
+      }
+    }
+  }
+}
+
+TEST_F(RacketTokenizerTest, TokensOutliveTokenizer) {
+  // Tokens view the block they were read in (when they fit in one)
+  // and keep it alive after the tokenizer and later blocks are gone.
+  std::vector<Token> tokens;
+  {
+    std::stringstream stream("(hello \"a long string\")");
+    RacketTokenizer tokenizer(stream, "file", 4);
+    do {
+      tokens.push_back(tokenizer.next_token());
+    } while (!tokens.back().is_eof());
+  }
+  ASSERT_THAT(tokens.size(), Eq(8u));
+  EXPECT_THAT(tokens[1].data(), Eq("hello"));
+  EXPECT_THAT(tokens[4].data(), Eq("a long string"));
+  EXPECT_THAT(tokens[6].data(), Eq(")"));
+  EXPECT_THAT(tokens[6].filename(), Eq("file"));
+}
 }  // namespace tokenizer
@@ -0,0 +1,38 @@
+// small_token_stack.cc --- Defines the parts of the SmallTokenStack
+// off the push/pop path: growing onto the heap and cleaning up.
+
+// small_token_stack.cc is Copyright (C) 2014 by the University of
+// British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#include "./small_token_stack.h"
+
+#include <utility>
+
+namespace tokenizer {
+std::size_t const SmallTokenStack::kInlineCapacity;
+
+SmallTokenStack::~SmallTokenStack() {
+  while (!empty())
+    pop();
+  if (on_heap())
+    ::operator delete(tokens_);
+}
+
+void SmallTokenStack::grow() {
+  std::size_t new_capacity = 2 * capacity_;
+  Token *new_tokens = static_cast<Token *>(
+      ::operator new(new_capacity * sizeof(Token)));
+  for (std::size_t i = 0; i < size_; ++i) {
+    new (new_tokens + i) Token(std::move(tokens_[i]));
+    tokens_[i].~Token();
+  }
+  if (on_heap())
+    ::operator delete(tokens_);
+  tokens_ = new_tokens;
+  capacity_ = new_capacity;
+}
+}  // namespace tokenizer
@@ -0,0 +1,103 @@
+// small_token_stack.h --- A TokenStack that keeps its tokens by value
+// in one contiguous array, inside the stack itself until it's deeper
+// than most programs ever nest.  Part of the RackaBrackaStack project.
+
+// small_token_stack.h is Copyright (C) 2014 by the University of
+// British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#ifndef RACKET_BRACKET_STACK_SMALL_TOKEN_STACK_H_
+#define RACKET_BRACKET_STACK_SMALL_TOKEN_STACK_H_
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+#include "./token_stack.h"
+#include "./token.h"
+
+namespace tokenizer {
+// The first kInlineCapacity tokens live in a buffer that is part of
+// the stack object, so checking a typically nested file allocates
+// nothing for its stack.  Past that, the tokens move to an array on
+// the heap that doubles whenever it fills (and is kept, rather than
+// shrunk, as the stack empties).
+//
+// Tokens are stored whole, not as TokenRecords: top() must give back
+// a Token whose data (and lines and columns) are still there to ask
+// for, and a Token is what keeps them alive.
+class SmallTokenStack final : public TokenStack {
+ public:
+  SmallTokenStack() { }
+  virtual ~SmallTokenStack();
+
+  SmallTokenStack(SmallTokenStack const &) = delete;
+  SmallTokenStack &operator=(SmallTokenStack const &) = delete;
+
+  virtual bool empty() const {
+    return size_ == 0;
+  }
+
+  // precondition: empty() == false.
+  virtual void pop() {
+    assert(!empty());
+    tokens_[--size_].~Token();
+  }
+
+  virtual void push(Token const value) {
+    if (size_ == capacity_)
+      grow();
+    new (tokens_ + size_) Token(value);
+    ++size_;
+  }
+
+  // precondition: empty() == false.
+  virtual Token const top() const {
+    assert(!empty());
+    return tokens_[size_ - 1];
+  }
+
+  // The number of tokens on the stack.
+  std::size_t size() const {
+    return size_;
+  }
+
+  // The number of tokens the stack holds before it must grow.
+  std::size_t capacity() const {
+    return capacity_;
+  }
+
+  // Whether the tokens have outgrown the inline buffer.
+  bool on_heap() const {
+    return tokens_ != inline_tokens();
+  }
+
+  // Deep enough for nearly any real program's brackets.
+  static std::size_t const kInlineCapacity = 32;
+
+ private:
+  // Moves the tokens to a heap array of twice the capacity.
+  void grow();
+
+  Token *inline_tokens() const {
+    return reinterpret_cast<Token *>(
+        const_cast<InlineSlot *>(inline_buffer_));
+  }
+
+  // Raw, suitably aligned room for one Token; slots below size_ hold
+  // constructed Tokens.
+  typedef std::aligned_storage<sizeof(Token), alignof(Token)>::type
+      InlineSlot;
+  InlineSlot inline_buffer_[kInlineCapacity];
+
+  Token *tokens_ = inline_tokens();
+  std::size_t size_ = 0;
+  std::size_t capacity_ = kInlineCapacity;
+};
+}  // namespace tokenizer
+
+#endif  // RACKET_BRACKET_STACK_SMALL_TOKEN_STACK_H_
@@ -0,0 +1,119 @@
+// spsc_ring.h --- Defines the SpscRing template: a bounded queue
+// between exactly one producer thread and one consumer thread that
+// neither locks nor waits.  Part of the RackaBrackaStack project.
+
+// spsc_ring.h is Copyright (C) 2014 by the University of British
+// Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#ifndef RACKET_BRACKET_STACK_SPSC_RING_H_
+#define RACKET_BRACKET_STACK_SPSC_RING_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace tokenizer {
+// One thread (the producer) may push while another (the consumer)
+// pops; either may close the ring and check whether it's closed.
+// Neither blocks: push takes what fits and pop what's there, and
+// waiting (for room, or for items) is up to the caller.
+//
+// The ring is an array indexed by two ever-increasing counts, head_
+// (items popped, written only by the consumer) and tail_ (items
+// pushed, written only by the producer), kept on separate cache
+// lines.  Each side keeps its own copy of the other's count and only
+// rereads the real one when its copy says there isn't room (or there
+// aren't items) enough, so a push or pop of a whole batch touches the
+// other side's cache line at most once.
+template <typename T>
+class SpscRing {
+ public:
+  static_assert(std::is_trivially_copyable<T>::value,
+                "SpscRing items must copy as plain bytes");
+
+  // Constructs an empty ring with room for capacity (> 0) items,
+  // rounded up to a power of two.
+  explicit SpscRing(std::size_t capacity)
+      : slots_(round_up(capacity)), mask_(slots_.size() - 1) {
+    assert(capacity > 0);
+  }
+
+  SpscRing(SpscRing const &) = delete;
+  SpscRing &operator=(SpscRing const &) = delete;
+
+  // Producer only: pushes as many of the count items as there's room
+  // for, in order, and returns how many that was.
+  std::size_t push(T const *items, std::size_t count) {
+    std::size_t tail = tail_.load(std::memory_order_relaxed);
+    if (slots_.size() - (tail - head_cache_) < count)
+      head_cache_ = head_.load(std::memory_order_acquire);
+    std::size_t pushed = std::min(count, slots_.size() - (tail - head_cache_));
+    for (std::size_t i = 0; i < pushed; ++i)
+      slots_[(tail + i) & mask_] = items[i];
+    tail_.store(tail + pushed, std::memory_order_release);
+    return pushed;
+  }
+
+  // Consumer only: pops up to max items, oldest first, into items
+  // and returns how many that was.
+  std::size_t pop(T *items, std::size_t max) {
+    std::size_t head = head_.load(std::memory_order_relaxed);
+    if (tail_cache_ - head < max)
+      tail_cache_ = tail_.load(std::memory_order_acquire);
+    std::size_t popped = std::min(max, tail_cache_ - head);
+    for (std::size_t i = 0; i < popped; ++i)
+      items[i] = slots_[(head + i) & mask_];
+    head_.store(head + popped, std::memory_order_release);
+    return popped;
+  }
+
+  // Tells the other side to stop: the producer that nothing more will
+  // be popped, or the consumer that nothing more will be pushed.
+  void close() {
+    closed_.store(true, std::memory_order_release);
+  }
+
+  bool closed() const {
+    return closed_.load(std::memory_order_acquire);
+  }
+
+  std::size_t capacity() const {
+    return slots_.size();
+  }
+
+ private:
+  static std::size_t const kCacheLineSize = 64;
+
+  static std::size_t round_up(std::size_t capacity) {
+    std::size_t size = 1;
+    while (size < capacity)
+      size <<= 1;
+    return size;
+  }
+
+  // Read-only once constructed, but for closed_.
+  std::vector<T> slots_;
+  std::size_t mask_;
+  std::atomic<bool> closed_{false};
+  char padding_[kCacheLineSize];
+
+  // The consumer's.
+  std::atomic<std::size_t> head_{0};
+  std::size_t tail_cache_ = 0;
+  char consumer_padding_[kCacheLineSize];
+
+  // The producer's.
+  std::atomic<std::size_t> tail_{0};
+  std::size_t head_cache_ = 0;
+  char producer_padding_[kCacheLineSize];
+};
+}  // namespace tokenizer
+
+#endif  // RACKET_BRACKET_STACK_SPSC_RING_H_
@@ -0,0 +1,96 @@
+// spsc_ring_test.cc --- Test code for the SpscRing template.
+
+// spsc_ring_test is Copyright (C) 2014 by CPSC 221 at the University
+// of British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#include <gmock/gmock.h>
+using ::testing::Eq;
+#include <gtest/gtest.h>
+using ::testing::Test;
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "./spsc_ring.h"
+
+namespace tokenizer {
+class SpscRingTest : public Test {
+ protected:
+  SpscRingTest() { }
+
+  virtual ~SpscRingTest() { }
+};
+
+TEST_F(SpscRingTest, CapacityIsAPowerOfTwo) {
+  EXPECT_THAT(SpscRing<int>(1).capacity(), Eq(1u));
+  EXPECT_THAT(SpscRing<int>(5).capacity(), Eq(8u));
+  EXPECT_THAT(SpscRing<int>(64).capacity(), Eq(64u));
+}
+
+TEST_F(SpscRingTest, PushesWhatFitsAndPopsInOrder) {
+  SpscRing<int> ring(4);
+  int items[] = {1, 2, 3, 4, 5, 6};
+  int popped[6];
+  EXPECT_THAT(ring.pop(popped, 6), Eq(0u));
+  EXPECT_THAT(ring.push(items, 3), Eq(3u));
+  EXPECT_THAT(ring.push(items + 3, 3), Eq(1u));
+  EXPECT_THAT(ring.push(items + 4, 2), Eq(0u));
+
+  EXPECT_THAT(ring.pop(popped, 2), Eq(2u));
+  EXPECT_THAT(popped[0], Eq(1));
+  EXPECT_THAT(popped[1], Eq(2));
+  // Round the end of the array and back.
+  EXPECT_THAT(ring.push(items + 4, 2), Eq(2u));
+  EXPECT_THAT(ring.pop(popped, 6), Eq(4u));
+  EXPECT_THAT(std::vector<int>(popped, popped + 4),
+              Eq(std::vector<int>({3, 4, 5, 6})));
+  EXPECT_THAT(ring.pop(popped, 6), Eq(0u));
+}
+
+TEST_F(SpscRingTest, Close) {
+  SpscRing<int> ring(4);
+  EXPECT_FALSE(ring.closed());
+  ring.close();
+  EXPECT_TRUE(ring.closed());
+}
+
+TEST_F(SpscRingTest, TwoThreads) {
+  // Odd batch sizes on a small ring, so that each side often finds
+  // the ring full or empty.
+  std::size_t const kItems = 200000;
+  SpscRing<std::size_t> ring(16);
+  std::thread producer([&ring, kItems]() {
+    std::size_t batch[7];
+    for (std::size_t next = 0; next < kItems; ) {
+      std::size_t count = 0;
+      for (; count < 7 && next + count < kItems; ++count)
+        batch[count] = next + count;
+      std::size_t pushed = 0;
+      while (pushed < count) {
+        pushed += ring.push(batch + pushed, count - pushed);
+        std::this_thread::yield();
+      }
+      next += count;
+    }
+  });
+
+  std::size_t expected = 0;
+  bool in_order = true;
+  std::size_t batch[5];
+  while (expected < kItems) {
+    std::size_t popped = ring.pop(batch, 5);
+    for (std::size_t i = 0; i < popped; ++i)
+      in_order = in_order && batch[i] == expected++;
+    if (popped == 0)
+      std::this_thread::yield();
+  }
+  producer.join();
+  EXPECT_TRUE(in_order);
+  EXPECT_THAT(ring.pop(batch, 5), Eq(0u));
+}
+}  // namespace tokenizer
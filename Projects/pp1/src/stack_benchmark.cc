@@ -0,0 +1,319 @@
+// stack_benchmark.cc --- Times each TokenStack on the pushes, tops and
+// pops a BalanceChecker makes, for the nesting of real Racket files
+// and of synthetic profiles, and reports the nanoseconds and heap
+// allocations per operation and how much the peak memory (both heap
+// and, where the system says, resident set) grew.
+
+// stack_benchmark.cc is Copyright (C) 2014 by the University of
+// British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#include <cstdlib>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/wait.h>
+#include <unistd.h>
+#define RACKET_BRACKET_STACK_HAVE_FORK 1
+#endif
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "./builtin_stack.h"
+#include "./concurrent_token_stack.h"
+#include "./linkedliststack.h"
+#include "./my_stack.h"
+#include "./racket_tokenizer.h"
+#include "./small_token_stack.h"
+#include "./token.h"
+#include "./token_stack.h"
+
+// Every heap allocation in the program goes through here, to be
+// counted and measured.  (The array forms call these.)  Each block
+// starts with its size, in room enough to keep what follows aligned.
+namespace {
+std::uint64_t allocations = 0;
+std::size_t heap_bytes = 0, peak_heap_bytes = 0;
+std::size_t const kSizeRoom = 16;
+}  // namespace
+
+void *operator new(std::size_t size) {
+  ++allocations;
+  char *memory = static_cast<char *>(std::malloc(size + kSizeRoom));
+  if (memory == nullptr)
+    throw std::bad_alloc();
+  *reinterpret_cast<std::size_t *>(memory) = size;
+  heap_bytes += size;
+  if (heap_bytes > peak_heap_bytes)
+    peak_heap_bytes = heap_bytes;
+  return memory + kSizeRoom;
+}
+
+void operator delete(void *memory) noexcept {
+  if (memory == nullptr)
+    return;
+  char *block = static_cast<char *>(memory) - kSizeRoom;
+  heap_bytes -= *reinterpret_cast<std::size_t *>(block);
+  std::free(block);
+}
+
+namespace {
+// What a BalanceChecker does to its stack while checking some input:
+// for each entry of ops, a push (of the next of pushes, in turn) or
+// a top and a pop.  Every trace leaves the stack as it found it, so
+// it can be run over and over.
+struct Trace {
+  std::string name;
+  std::vector<bool> ops;  // true to push
+  std::vector<tokenizer::Token> pushes;
+};
+
+// A token like the tokenizers' own: a view of data it shares.
+tokenizer::Token synthetic_token() {
+  static std::shared_ptr<std::string const> const data =
+      std::make_shared<std::string const>("(");
+  return tokenizer::Token(1, tokenizer::StringView(*data), data, nullptr,
+                          tokenizer::intern_filename("synthetic"),
+                          1, 1, 1, 2);
+}
+
+// Adds the pops that bring a trace back down to an empty stack.
+void unwind(std::size_t depth, Trace *trace) {
+  trace->ops.insert(trace->ops.end(), depth, false);
+}
+
+// The trace of checking a Racket file, as determine_action decides:
+// a token that closes and matches the top pops it; otherwise, one that
+// opens (a " too) is pushed.  (A closer that doesn't match, where the
+// checker would stop, is skipped.)
+Trace file_trace(std::string const &filename) {
+  typedef tokenizer::RacketTokenizer RacketTokenizer;
+  Trace trace;
+  trace.name = filename;
+  std::ifstream in(filename);
+  RacketTokenizer tokenizer(in, filename);
+  std::vector<int> open_types;
+  for (tokenizer::Token token = tokenizer.next_token(); !token.is_eof();
+       token = tokenizer.next_token()) {
+    int type = token.type();
+    if (RacketTokenizer::is_closing_type(type) && !open_types.empty() &&
+        RacketTokenizer::are_matching_types(open_types.back(), type)) {
+      trace.ops.push_back(false);
+      open_types.pop_back();
+    } else if (RacketTokenizer::is_opening_type(type)) {
+      trace.ops.push_back(true);
+      trace.pushes.push_back(token);
+      open_types.push_back(type);
+    }
+  }
+  unwind(open_types.size(), &trace);
+  return trace;
+}
+
+// Code as people write it: a random walk whose depth settles around
+// mean_depth (pushing is likelier the shallower it is).
+Trace typical_trace(std::size_t mean_depth, std::size_t length) {
+  Trace trace;
+  trace.name = "random walk, mean depth " + std::to_string(mean_depth);
+  trace.pushes.push_back(synthetic_token());
+  std::default_random_engine random(221);
+  std::size_t depth = 0;
+  for (std::size_t i = 0; i < length; ++i) {
+    bool push = std::uniform_int_distribution<std::size_t>(
+        0, mean_depth + depth - 1)(random) < mean_depth;
+    trace.ops.push_back(push);
+    if (push)
+      depth++;
+    else
+      depth--;
+  }
+  unwind(depth, &trace);
+  return trace;
+}
+
+// Generated code: repeatedly nesting depth deep and back out.
+Trace sawtooth_trace(std::size_t depth) {
+  Trace trace;
+  trace.name = "nest to depth " + std::to_string(depth) + " and back";
+  trace.pushes.push_back(synthetic_token());
+  trace.ops.assign(depth, true);
+  unwind(depth, &trace);
+  return trace;
+}
+
+struct Result {
+  double ns_per_op;
+  double allocations_per_op;
+  std::size_t peak_heap_growth;  // in bytes
+  long peak_rss_growth_kb;       // or -1 if unknown
+};
+
+// The given field ("VmRSS:" for the resident set now, "VmHWM:" for
+// its peak) of Linux's /proc/self/status, in kilobytes, or -1 if
+// there's no such thing.
+long proc_status_kb(std::string const &field) {
+  std::ifstream status("/proc/self/status");
+  std::string name;
+  long kb;
+  while (status >> name) {
+    if (name == field && status >> kb)
+      return kb;
+    status.ignore(1 << 10, '\n');
+  }
+  return -1;
+}
+
+// Starts the resident set's peak over from where it is now, if the
+// system allows it, returning whether it did.
+bool reset_peak_rss() {
+  std::ofstream clear_refs("/proc/self/clear_refs");
+  return static_cast<bool>(clear_refs << "5" << std::flush);
+}
+
+// Runs trace over and over on stack, at least ops operations' worth.
+Result run_trace(Trace const &trace, tokenizer::TokenStack *stack,
+                 std::uint64_t ops) {
+  typedef std::chrono::steady_clock Clock;
+  std::uint64_t rounds = (ops + trace.ops.size() - 1) / trace.ops.size();
+  long start_rss_kb = reset_peak_rss() ? proc_status_kb("VmRSS:") : -1;
+  std::size_t start_heap_bytes = heap_bytes;
+  peak_heap_bytes = heap_bytes;
+  std::uint64_t start_allocations = allocations;
+  std::uint64_t checksum = 0;
+  Clock::time_point start = Clock::now();
+  for (std::uint64_t round = 0; round < rounds; ++round) {
+    std::size_t next_push = 0;
+    for (bool push : trace.ops) {
+      if (push) {
+        stack->push(trace.pushes[next_push]);
+        if (++next_push == trace.pushes.size())
+          next_push = 0;
+      } else {
+        checksum += stack->top().type();
+        stack->pop();
+      }
+    }
+  }
+  std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+  if (checksum == 0 && !trace.pushes.empty())
+    std::cerr << "Error: tokens came back wrong." << std::endl;
+
+  double total_ops = static_cast<double>(rounds) * trace.ops.size();
+  Result result;
+  result.ns_per_op = elapsed.count() / total_ops;
+  result.allocations_per_op = (allocations - start_allocations) / total_ops;
+  result.peak_heap_growth = peak_heap_bytes - start_heap_bytes;
+  long peak_rss_kb = proc_status_kb("VmHWM:");
+  result.peak_rss_growth_kb =
+      start_rss_kb < 0 || peak_rss_kb < 0 ? -1 : peak_rss_kb - start_rss_kb;
+  return result;
+}
+
+template <typename StackT>
+tokenizer::TokenStack *make_stack() {
+  return new StackT;
+}
+
+// LinkedListStack as it was before its NodePool: a new and a delete
+// per node, for comparison with the pooled one.
+tokenizer::TokenStack *make_unpooled_linked_list_stack() {
+  return new tokenizer::LinkedListStack(false);
+}
+
+// Every TokenStack to time.  Add new ones here.
+struct StackType {
+  char const *name;
+  tokenizer::TokenStack *(*make)();
+} const kStackTypes[] = {
+  {"BuiltinStack", make_stack<tokenizer::BuiltinStack>},
+  {"MyStack", make_stack<tokenizer::MyStack>},
+  {"LinkedListStack", make_stack<tokenizer::LinkedListStack>},
+  {"LinkedListStack/new", make_unpooled_linked_list_stack},
+  {"SmallTokenStack", make_stack<tokenizer::SmallTokenStack>},
+  {"ConcurrentTokenStack", make_stack<tokenizer::ConcurrentTokenStack>},
+};
+
+// Times a new stack of the given type on trace and prints the
+// results.  Where it can, it does so in a child process, so that
+// one stack's memory doesn't mask the next one's.
+void report(Trace const &trace, StackType const &type, std::uint64_t ops) {
+#ifdef RACKET_BRACKET_STACK_HAVE_FORK
+  std::cout << std::flush;
+  pid_t child = fork();
+  if (child > 0) {
+    int status;
+    waitpid(child, &status, 0);
+    return;
+  }
+#endif
+
+  std::unique_ptr<tokenizer::TokenStack> stack(type.make());
+  Result result = run_trace(trace, stack.get(), ops);
+  std::cout << "  " << std::left << std::setw(22) << type.name << std::right
+            << std::fixed << std::setprecision(2)
+            << std::setw(8) << result.ns_per_op << " ns/op"
+            << std::setprecision(4)
+            << std::setw(10) << result.allocations_per_op << " allocs/op"
+            << "   peak heap +" << (result.peak_heap_growth + 1023) / 1024
+            << " KB";
+  if (result.peak_rss_growth_kb >= 0)
+    std::cout << ", peak RSS +" << result.peak_rss_growth_kb << " KB";
+  std::cout << std::endl;
+
+#ifdef RACKET_BRACKET_STACK_HAVE_FORK
+  if (child == 0)
+    std::_Exit(0);
+#endif
+}
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <ops> [<filename>...]"
+              << std::endl;
+    std::cerr << "\tRuns about that many stack operations on each kind "
+              << "of TokenStack as" << std::endl
+              << "\tchecking each Racket file named would, then as "
+              << "checking synthetic" << std::endl
+              << "\tnesting would." << std::endl;
+    return 1;
+  }
+  long long ops = std::atoll(argv[1]);
+  if (ops < 1) {
+    std::cerr << "Error: ops must be positive." << std::endl;
+    return 1;
+  }
+
+  std::vector<Trace> traces;
+  for (int i = 2; i < argc; ++i) {
+    traces.push_back(file_trace(argv[i]));
+    if (traces.back().ops.empty()) {
+      std::cerr << "Warning: no brackets to check in " << argv[i]
+                << std::endl;
+      traces.pop_back();
+    }
+  }
+  traces.push_back(sawtooth_trace(1));
+  traces.push_back(typical_trace(8, 1 << 20));
+  traces.push_back(typical_trace(64, 1 << 20));
+  traces.push_back(sawtooth_trace(10000));
+
+  for (Trace const &trace : traces) {
+    std::cout << trace.name << " (" << trace.ops.size() << " ops):"
+              << std::endl;
+    for (StackType const &type : kStackTypes)
+      report(trace, type, ops);
+  }
+  return 0;
+}
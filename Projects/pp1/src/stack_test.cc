@@ -17,10 +17,14 @@ using ::testing::Eq;
 #include <gtest/gtest.h>
 using ::testing::Test;
 
+#include <cstddef>
+#include <string>
+
 #include "./token.h"
 #include "./token_stack.h"
 #include "./my_stack.h"
 #include "./builtin_stack.h"
+#include "./small_token_stack.h"
 
 namespace tokenizer {
 class StackTest : public Test {
@@ -28,6 +32,7 @@ class StackTest : public Test {
   StackTest() {
     stacks[0] = new BuiltinStack;
     stacks[1] = new MyStack;
+    stacks[2] = new SmallTokenStack;
   }
 
   virtual ~StackTest() {
@@ -36,6 +41,9 @@ class StackTest : public Test {
 
     delete stacks[1];
     stacks[1] = nullptr;
+
+    delete stacks[2];
+    stacks[2] = nullptr;
   }
 
   // We're including the tests inside the StackTest class so that we
@@ -143,10 +151,10 @@ class StackTest : public Test {
     }
   }
 
-  TokenStack *stacks[2];
+  TokenStack *stacks[3];
 
   // TODO(you): To test YOUR stack, change this to 2.
-  int num_token_stacks = 2;
+  int num_token_stacks = 3;
 
   Token token1_{1, "foo", 1, 1, 1, 1},
     token2_{2, "bar", 1, 1, 1, 1},
@@ -164,4 +172,21 @@ TEST_F(StackTest, ManyPushManyPop) {
 TEST_F(StackTest, ComplexUpDownUpDown) {
   test_up_down_up_down();
 }
+TEST_F(StackTest, SmallTokenStackGrowsOntoHeap) {
+  SmallTokenStack stack;
+  std::size_t const depth = 3 * SmallTokenStack::kInlineCapacity + 1;
+  for (std::size_t i = 0; i < depth; ++i) {
+    EXPECT_THAT(stack.on_heap(), Eq(i > SmallTokenStack::kInlineCapacity));
+    stack.push(Token(static_cast<int>(i), std::to_string(i), 1, 1, 1, 1));
+  }
+  EXPECT_THAT(stack.size(), Eq(depth));
+  EXPECT_THAT(stack.capacity(), Eq(4 * SmallTokenStack::kInlineCapacity));
+
+  // Every token (and its data) survived the moves.
+  for (std::size_t i = depth; i-- > 0;) {
+    EXPECT_THAT(stack.top().data(), Eq(std::to_string(i)));
+    stack.pop();
+  }
+  EXPECT_THAT(stack.empty(), Eq(true));
+}
 }  // namespace tokenizer
@@ -0,0 +1,72 @@
+// string_view.h --- Simple class for a read-only view of characters
+// owned by someone else (e.g., a Token's data within a tokenizer's
+// input).  Part of the RackaBrackaStack project.
+
+// string_view.h is Copyright (C) 2014 by the University of British
+// Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#ifndef RACKET_BRACKET_STACK_STRING_VIEW_H_
+#define RACKET_BRACKET_STACK_STRING_VIEW_H_
+
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+#include <string>
+
+namespace tokenizer {
+// A pointer to and count of characters; copying a view never copies
+// the characters.  The characters must outlive the view.
+class StringView {
+ public:
+  StringView() : data_(nullptr), size_(0) { }
+  StringView(char const *data, std::size_t size)
+      : data_(data), size_(size) { }
+
+  // Views all of str (which must outlive the view).
+  StringView(std::string const &str)  // NOLINT(runtime/explicit)
+      : data_(str.data()), size_(str.size()) { }
+
+  char const *data() const {
+    return data_;
+  }
+  std::size_t size() const {
+    return size_;
+  }
+  bool empty() const {
+    return size_ == 0;
+  }
+  char const *begin() const {
+    return data_;
+  }
+  char const *end() const {
+    return data_ + size_;
+  }
+
+  // Copies the characters viewed.
+  std::string to_string() const {
+    return std::string(data_, size_);
+  }
+
+ private:
+  char const *data_;
+  std::size_t size_;
+};
+
+inline bool operator==(StringView const &lhs, StringView const &rhs) {
+  return lhs.size() == rhs.size() &&
+      (lhs.size() == 0 ||
+       std::memcmp(lhs.data(), rhs.data(), lhs.size()) == 0);
+}
+inline bool operator!=(StringView const &lhs, StringView const &rhs) {
+  return !(lhs == rhs);
+}
+inline std::ostream& operator<<(std::ostream &os, StringView const &view) {
+  return os.write(view.data(), view.size());
+}
+}  // namespace tokenizer
+
+#endif  // RACKET_BRACKET_STACK_STRING_VIEW_H_
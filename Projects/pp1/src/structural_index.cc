@@ -0,0 +1,227 @@
+// structural_index.cc --- Defines the StructuralIndexer, which finds
+// the structural characters of Racket source 64 bytes at a time.
+
+// structural_index.cc is Copyright (C) 2014 by the University of
+// British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+
+#include "./structural_index.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace {
+int count_trailing_zeros(std::uint64_t x) {
+#if defined(__GNUC__)
+  return __builtin_ctzll(x);
+#else
+  int count = 0;
+  for (; (x & 1) == 0; x >>= 1)
+    count++;
+  return count;
+#endif
+}
+
+int parity(std::uint64_t x) {
+#if defined(__GNUC__)
+  return __builtin_parityll(x);
+#else
+  return static_cast<int>(tokenizer::prefix_xor(x) >> 63);
+#endif
+}
+
+// Appends base + i to offsets for every bit i set in bits.
+void append_offsets(std::uint64_t bits, std::size_t base,
+                    std::vector<std::size_t> *offsets) {
+  for (; bits != 0; bits &= bits - 1)
+    offsets->push_back(base + count_trailing_zeros(bits));
+}
+}  // namespace
+
+namespace tokenizer {
+std::size_t const StructuralIndexer::kBlockSize;
+
+#ifdef __SSE2__
+void classify_block(char const *block, CharacterMasks *masks) {
+  masks->brackets = masks->quotes = masks->backslashes =
+      masks->semicolons = masks->newlines = 0;
+
+  for (int lane = 0; lane < 4; ++lane) {
+    __m128i chars = _mm_loadu_si128(
+        reinterpret_cast<__m128i const *>(block + 16 * lane));
+    int shift = 16 * lane;
+
+    // The brackets pair up in three compares: ( and ) differ only in
+    // bit 0, [ and { (and ] and }) only in bit 5.
+    __m128i with_bit0 = _mm_or_si128(chars, _mm_set1_epi8(0x01));
+    __m128i with_bit5 = _mm_or_si128(chars, _mm_set1_epi8(0x20));
+    __m128i brackets = _mm_or_si128(
+        _mm_cmpeq_epi8(with_bit0, _mm_set1_epi8(')')),
+        _mm_or_si128(_mm_cmpeq_epi8(with_bit5, _mm_set1_epi8('{')),
+                     _mm_cmpeq_epi8(with_bit5, _mm_set1_epi8('}'))));
+
+    masks->brackets |= static_cast<std::uint64_t>(
+        static_cast<unsigned>(_mm_movemask_epi8(brackets))) << shift;
+    masks->quotes |= static_cast<std::uint64_t>(static_cast<unsigned>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(chars, _mm_set1_epi8('"')))))
+        << shift;
+    masks->backslashes |= static_cast<std::uint64_t>(static_cast<unsigned>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(chars, _mm_set1_epi8('\\')))))
+        << shift;
+    masks->semicolons |= static_cast<std::uint64_t>(static_cast<unsigned>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(chars, _mm_set1_epi8(';')))))
+        << shift;
+    masks->newlines |= static_cast<std::uint64_t>(static_cast<unsigned>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(chars, _mm_set1_epi8('\n')))))
+        << shift;
+  }
+}
+#else
+void classify_block(char const *block, CharacterMasks *masks) {
+  masks->brackets = masks->quotes = masks->backslashes =
+      masks->semicolons = masks->newlines = 0;
+
+  for (int i = 0; i < 64; ++i) {
+    std::uint64_t bit = static_cast<std::uint64_t>(1) << i;
+    switch (block[i]) {
+      case '(': case ')': case '[': case ']': case '{': case '}':
+        masks->brackets |= bit;
+        break;
+      case '"':
+        masks->quotes |= bit;
+        break;
+      case '\\':
+        masks->backslashes |= bit;
+        break;
+      case ';':
+        masks->semicolons |= bit;
+        break;
+      case '\n':
+        masks->newlines |= bit;
+        break;
+      default:
+        break;
+    }
+  }
+}
+#endif
+
+bool StructuralIndexer::index_next(std::size_t max_bytes,
+                                   std::vector<std::size_t> *offsets) {
+  if (pos_ == end_)
+    return false;
+
+  for (std::size_t indexed = 0; pos_ != end_ && indexed < max_bytes;
+       indexed += kBlockSize) {
+    std::size_t size = std::min<std::size_t>(kBlockSize, end_ - pos_);
+    CharacterMasks masks;
+    if (size == kBlockSize) {
+      classify_block(pos_, &masks);
+    } else {
+      // Pad the last, partial block with (uninteresting) spaces.
+      char block[kBlockSize];
+      std::memset(block, ' ', kBlockSize);
+      std::memcpy(block, pos_, size);
+      classify_block(block, &masks);
+    }
+    index_block(masks, offsets);
+    pos_ += size;
+  }
+  return true;
+}
+
+std::vector<std::size_t> StructuralIndexer::index(char const *begin,
+                                                  char const *end) {
+  StructuralIndexer indexer(begin, end);
+  std::vector<std::size_t> offsets;
+  indexer.index_next(end - begin, &offsets);
+  return offsets;
+}
+
+void StructuralIndexer::index_block(CharacterMasks const &masks,
+                                    std::vector<std::size_t> *offsets) {
+  std::size_t base = pos_ - begin_;
+  std::uint64_t brackets = masks.brackets;
+  std::uint64_t quotes = masks.quotes;
+  std::uint64_t backslashes = masks.backslashes;
+  std::uint64_t semicolons = masks.semicolons;
+  std::uint64_t newlines = masks.newlines;
+
+  // A backslash ending the last block escaped this block's first
+  // character, which is then just string data.
+  if (escaped_) {
+    std::uint64_t const not_first = ~static_cast<std::uint64_t>(1);
+    brackets &= not_first;
+    quotes &= not_first;
+    backslashes &= not_first;
+    semicolons &= not_first;
+    newlines &= not_first;
+    escaped_ = false;
+  }
+
+  if (in_comment_) {
+    // Nothing to find until the comment ends.
+    if (newlines == 0)
+      return;
+  } else if (!in_string_ && (quotes | semicolons) == 0) {
+    // Every bracket counts.  (Backslashes only matter in strings.)
+    append_offsets(brackets, base, offsets);
+    return;
+  } else if (in_string_ && (quotes | backslashes) == 0) {
+    // Nothing but string data.
+    return;
+  } else if ((semicolons | backslashes) == 0) {
+    // Strings, but no escapes or comments: every quotation mark
+    // counts, and prefix_xor tells which brackets are inside strings.
+    std::uint64_t in_string = prefix_xor(quotes);
+    if (in_string_)
+      in_string = ~in_string;
+    append_offsets((brackets & ~in_string) | quotes, base, offsets);
+    in_string_ = in_string_ != (parity(quotes) == 1);
+    return;
+  }
+
+  // Otherwise, walk the interesting characters in order.
+  std::uint64_t structurals = 0;
+  std::uint64_t bits = brackets | quotes | backslashes | semicolons | newlines;
+  while (bits != 0) {
+    int i = count_trailing_zeros(bits);
+    std::uint64_t bit = static_cast<std::uint64_t>(1) << i;
+    bits &= bits - 1;
+
+    if (in_comment_) {
+      if (newlines & bit)
+        in_comment_ = false;
+    } else if (in_string_) {
+      if (quotes & bit) {
+        structurals |= bit;
+        in_string_ = false;
+      } else if (backslashes & bit) {
+        // Skip the escaped character, which may be in the next block.
+        if (i == 63)
+          escaped_ = true;
+        else
+          bits &= ~(bit << 1);
+      }
+    } else {
+      if (brackets & bit) {
+        structurals |= bit;
+      } else if (quotes & bit) {
+        structurals |= bit;
+        in_string_ = true;
+      } else if (semicolons & bit) {
+        in_comment_ = true;
+      }
+    }
+  }
+  append_offsets(structurals, base, offsets);
+}
+}  // namespace tokenizer
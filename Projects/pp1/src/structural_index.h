@@ -0,0 +1,109 @@
+// structural_index.h --- Declares the StructuralIndexer, which finds
+// the structural characters of Racket source in memory (the brackets
+// and quotation marks a RacketTokenizer would turn into tokens) by
+// classifying 64 bytes at a time into bitmasks.  Part of the
+// RackaBrackaStack project.
+
+// structural_index.h is Copyright (C) 2014 by the University of
+// British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#ifndef RACKET_BRACKET_STACK_STRUCTURAL_INDEX_H_
+#define RACKET_BRACKET_STACK_STRUCTURAL_INDEX_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tokenizer {
+// The characters of interest in (up to) 64 bytes of input, one bit
+// per byte, with byte i in bit i.
+struct CharacterMasks {
+  std::uint64_t brackets;      // ( ) [ ] { }
+  std::uint64_t quotes;        // "
+  std::uint64_t backslashes;   // \ (escapes, but only inside strings)
+  std::uint64_t semicolons;    // ; (starts a comment)
+  std::uint64_t newlines;      // \n (ends a comment)
+};
+
+// Classifies the 64 bytes starting at block (using SSE2 where
+// available).
+void classify_block(char const *block, CharacterMasks *masks);
+
+// Returns the mask whose bit i is the XOR of bits 0 through i of x:
+// for a mask of quotation marks, the bytes inside (or closing) a
+// string.
+inline std::uint64_t prefix_xor(std::uint64_t x) {
+  x ^= x << 1;
+  x ^= x << 2;
+  x ^= x << 4;
+  x ^= x << 8;
+  x ^= x << 16;
+  x ^= x << 32;
+  return x;
+}
+
+// The first stage of tokenizing: finds the offsets, from the start of
+// the input, of its structural characters.  Those are the brackets
+// outside strings and comments and the quotation marks that open and
+// close strings; everything else (identifiers, whitespace, string
+// data, and comments) at most extends a token the balance checker
+// ignores.
+//
+// Most blocks are settled entirely with mask arithmetic: blocks with
+// no quotation marks or comments outside a string, blocks wholly
+// inside a comment or string, and blocks whose strings have no
+// escapes (using prefix_xor).  Only blocks with comments or escapes
+// in play are walked character by character, and then only over the
+// interesting characters.
+class StructuralIndexer {
+ public:
+  // Indexes [begin, end), which must outlive the indexer, starting
+  // outside of any string or comment unless in_string says it starts
+  // inside a string.  Offsets are from begin.
+  StructuralIndexer(char const *begin, char const *end,
+                    bool in_string = false)
+      : begin_(begin), end_(end), pos_(begin), in_string_(in_string) { }
+
+  // Indexes at least max_bytes (rounded up to a whole block) more of
+  // the input, or the rest of it, appending the structural offsets
+  // found to offsets.  Returns false once the whole input has been
+  // indexed (so nothing was appended).
+  bool index_next(std::size_t max_bytes, std::vector<std::size_t> *offsets);
+
+  // Indexes the whole of [begin, end), returning its structural
+  // offsets.
+  static std::vector<std::size_t> index(char const *begin, char const *end);
+
+  // Whether the input indexed so far ends inside a string or a
+  // comment.
+  bool in_string() const {
+    return in_string_;
+  }
+  bool in_comment() const {
+    return in_comment_;
+  }
+
+  static std::size_t const kBlockSize = 64;
+
+ private:
+  // Indexes the 64-byte block at pos_ (whose masks are given),
+  // appending its structural offsets.
+  void index_block(CharacterMasks const &masks,
+                   std::vector<std::size_t> *offsets);
+
+  char const *begin_;
+  char const *end_;
+  char const *pos_;
+
+  // The lexical state carried from one block to the next.
+  bool in_string_;
+  bool in_comment_ = false;
+  bool escaped_ = false;    // In a string, just after a backslash.
+};
+}  // namespace tokenizer
+
+#endif  // RACKET_BRACKET_STACK_STRUCTURAL_INDEX_H_
@@ -0,0 +1,127 @@
+// structural_index_test.cc --- Test code for the StructuralIndexer
+// and StructuralTokenizer classes.
+
+// structural_index_test is Copyright (C) 2014 by CPSC 221 at the
+// University of British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#include <gmock/gmock.h>
+using ::testing::ElementsAre;
+using ::testing::Eq;
+#include <gtest/gtest.h>
+using ::testing::Test;
+
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "./balance_checker.h"
+#include "./racket_tokenizer.h"
+#include "./structural_index.h"
+#include "./structural_tokenizer.h"
+#include "./tokenizer_test_util.h"
+
+namespace tokenizer {
+class StructuralIndexTest : public Test {
+ protected:
+  StructuralIndexTest() { }
+
+  virtual ~StructuralIndexTest() { }
+
+  std::vector<std::size_t> index(std::string const &text) {
+    return StructuralIndexer::index(text.data(), text.data() + text.size());
+  }
+
+  // Checks that a StructuralTokenizer produces exactly the structural
+  // tokens a RacketTokenizer does for text.
+  void check_same_structural_tokens(std::string const &text) {
+    std::stringstream stream(text);
+    RacketTokenizer racket(stream, "file");
+    StructuralTokenizer structural(text.data(), text.data() + text.size(),
+                                   "file");
+    bool at_eof = false;
+    while (!at_eof) {
+      Token expected = racket.next_token();
+      if (!expected.is_eof() &&
+          !RacketTokenizer::is_opening_type(expected.type()) &&
+          !RacketTokenizer::is_closing_type(expected.type()))
+        continue;
+
+      expect_same_token(structural.next_token(), expected, text);
+      at_eof = expected.is_eof();
+    }
+  }
+};
+
+TEST_F(StructuralIndexTest, PrefixXor) {
+  EXPECT_THAT(prefix_xor(0), Eq(0u));
+  // Quotation marks at 1 and 4: bits 1 through 3 are in the string.
+  EXPECT_THAT(prefix_xor(0x12), Eq(0xEu));
+  EXPECT_THAT(prefix_xor(static_cast<std::uint64_t>(1) << 63),
+              Eq(static_cast<std::uint64_t>(1) << 63));
+}
+
+TEST_F(StructuralIndexTest, ClassifyBlock) {
+  std::string block = "(a [b] {c}) \"s\\\" ;x\n";
+  block.resize(StructuralIndexer::kBlockSize, ' ');
+  CharacterMasks masks;
+  classify_block(block.data(), &masks);
+  EXPECT_THAT(masks.brackets, Eq(0x6A9u));
+  EXPECT_THAT(masks.quotes, Eq(0x9000u));
+  EXPECT_THAT(masks.backslashes, Eq(0x4000u));
+  EXPECT_THAT(masks.semicolons, Eq(0x20000u));
+  EXPECT_THAT(masks.newlines, Eq(0x80000u));
+}
+
+TEST_F(StructuralIndexTest, Index) {
+  EXPECT_THAT(index(""), ElementsAre());
+  EXPECT_THAT(index("(a [b])"), ElementsAre(0, 3, 5, 6));
+  EXPECT_THAT(index("\"(\" )"), ElementsAre(0, 2, 4));
+  EXPECT_THAT(index("; (\n)"), ElementsAre(4));
+  EXPECT_THAT(index("\"\\\"(\" ;\"\n\\\""), ElementsAre(0, 4, 10));
+}
+
+TEST_F(StructuralIndexTest, StateCarriesAcrossBlocks) {
+  // A string, a comment and an escape each straddling a block edge.
+  std::string padding(60, 'x');
+  EXPECT_THAT(index(padding + "\"abcdefgh)\" ("),
+              ElementsAre(60, 70, 72));
+  EXPECT_THAT(index(padding + ";abcdefgh)\n("), ElementsAre(71));
+  EXPECT_THAT(index(padding + "  \"\\\")\" ("), ElementsAre(62, 66, 68));
+}
+
+TEST_F(StructuralIndexTest, SameTokensAsRacketTokenizer) {
+  check_same_structural_tokens("");
+  check_same_structural_tokens("(define (f x) ;; cmt\r\n  {\"s\\\"\" [x]})");
+  check_same_structural_tokens(";\r\r\n(\"\r\n\")");
+
+  // Random text heavy in everything the indexer must get right,
+  // long enough to span several blocks.
+  std::default_random_engine random(221);
+  for (int i = 0; i < 500; ++i)
+    check_same_structural_tokens(random_text(&random, 300));
+}
+
+TEST_F(StructuralIndexTest, SameBalance) {
+  std::string const texts[] = {
+    "(* ({+[8 7]} 9))", ";blue({))}\n(+[3 5])", "(stringeq(\"foo\", \"bar)",
+    "{ *[+(3 5) 9] ]", "\"cool(({\" {(12345)}"
+  };
+  for (std::string const &text : texts) {
+    std::stringstream stream(text);
+    RacketTokenizer racket(stream, "file");
+    StructuralTokenizer structural(text.data(), text.data() + text.size(),
+                                   "file");
+    BalanceChecker racket_checker(&racket), structural_checker(&structural);
+    Token expected = racket_checker.check_balance();
+    Token token = structural_checker.check_balance();
+    EXPECT_THAT(token, Eq(expected));
+    EXPECT_THAT(token.start_column(), Eq(expected.start_column()));
+  }
+}
+}  // namespace tokenizer
@@ -0,0 +1,53 @@
+// structural_tokenizer.cc --- Defines the StructuralTokenizer class,
+// which turns the structural characters found by a StructuralIndexer
+// into tokens.
+
+// structural_tokenizer.cc is Copyright (C) 2014 by the University of
+// British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+
+#include "./structural_tokenizer.h"
+
+#include <cstring>
+
+namespace tokenizer {
+typedef RacketTokenizer RT;
+
+Token StructuralTokenizer::next_token() {
+  // Index more of the input once this chunk's offsets run out.
+  while (next_offset_ == offsets_.size()) {
+    offsets_.clear();
+    next_offset_ = 0;
+    if (!indexer_.index_next(kIndexChunkSize, &offsets_)) {
+      // EOF sits just past the last character.
+      advance_to(end_);
+      int column = end_ - line_start_ + 1;
+      return Token(RT::kEof, StringView(), nullptr, nullptr, file_id_,
+                   line_, line_, column, column, end_ - begin_);
+    }
+  }
+
+  char const *position = begin_ + offsets_[next_offset_++];
+  advance_to(position);
+  int column = position - line_start_ + 1;
+
+  return Token(RT::structural_type(*position),
+               RT::structural_data(*position), nullptr, nullptr, file_id_,
+               line_, line_, column, column + 1, position - begin_);
+}
+
+void StructuralTokenizer::advance_to(char const *position) {
+  char const *newline;
+  while (scanned_ < position &&
+         (newline = static_cast<char const *>(
+             std::memchr(scanned_, '\n', position - scanned_))) != nullptr) {
+    line_++;
+    scanned_ = line_start_ = newline + 1;
+  }
+  scanned_ = position;
+}
+}  // namespace tokenizer
@@ -0,0 +1,87 @@
+// structural_tokenizer.h --- Concrete (leaf) class for a tokenizer
+// over Racket source in memory that produces only the tokens that
+// matter to balance checking (brackets and quotation marks), found
+// with a StructuralIndexer.  Part of the RackaBrackaStack project.
+
+// structural_tokenizer.h is Copyright (C) 2014 by the University of
+// British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#ifndef RACKET_BRACKET_STACK_STRUCTURAL_TOKENIZER_H_
+#define RACKET_BRACKET_STACK_STRUCTURAL_TOKENIZER_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "./file_id.h"
+#include "./racket_tokenizer.h"
+#include "./structural_index.h"
+#include "./token.h"
+#include "./tokenizer.h"
+
+namespace tokenizer {
+// Produces exactly the kOpenParen, kCloseParen, kOpenBracket,
+// kCloseBracket, kOpenBrace, kCloseBrace, kQuotationMark and kEof
+// tokens a RacketTokenizer would produce for the same input, with
+// the same data and positions, skipping all the others.  So, a
+// BalanceChecker gives the same answer with either.
+//
+// Positions are worked out only for the tokens produced, by counting
+// the newlines between one and the next.  Tokens' data are views of
+// static strings; so, they need not outlive the input.
+class StructuralTokenizer final : public Tokenizer {
+ public:
+  // Constructs a tokenizer over [begin, end), which must outlive it,
+  // that will report itself as reading the given file.
+  StructuralTokenizer(char const *begin, char const *end,
+                      std::string const &filename)
+      : begin_(begin), end_(end), file_id_(intern_filename(filename)),
+        indexer_(begin, end), line_start_(begin), scanned_(begin) { }
+
+  virtual Token next_token();
+
+  virtual bool are_matching(Token const & opener, Token const & closer) const {
+    return RacketTokenizer::are_matching_types(opener.type(), closer.type());
+  }
+
+  virtual bool is_opening(Token const & token) const {
+    return RacketTokenizer::is_opening_type(token.type());
+  }
+
+  virtual bool is_closing(Token const & token) const {
+    return RacketTokenizer::is_closing_type(token.type());
+  }
+
+  virtual bool classifies_by_type() const {
+    return true;
+  }
+
+  // How much input is indexed at a time.
+  static std::size_t const kIndexChunkSize = 64 * 1024;
+
+ private:
+  // Advances line_ and line_start_ past the newlines before position.
+  void advance_to(char const *position);
+
+  char const *begin_;
+  char const *end_;
+  FileId file_id_;
+
+  // Structural offsets of the current chunk of input not yet
+  // produced as tokens, starting at next_offset_.
+  StructuralIndexer indexer_;
+  std::vector<std::size_t> offsets_;
+  std::size_t next_offset_ = 0;
+
+  // The line scanned_ is on and where that line starts.
+  int line_ = 1;
+  char const *line_start_;
+  char const *scanned_;
+};
+}  // namespace tokenizer
+
+#endif  // RACKET_BRACKET_STACK_STRUCTURAL_TOKENIZER_H_
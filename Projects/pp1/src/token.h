@@ -12,9 +12,16 @@
 #ifndef RACKET_BRACKET_STACK_TOKEN_H_
 #define RACKET_BRACKET_STACK_TOKEN_H_
 
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <ostream>
 
+#include "./file_id.h"
+#include "./line_index.h"
+#include "./string_view.h"
+#include "./token_record.h"
+
 namespace tokenizer {
 class Tokenizer;
 
@@ -61,27 +68,79 @@ class Token {
             filename, start_line, end_line,
             start_column, end_column) { }
 
-  // Constructs a token with the given components.
+  // Constructs a token with the given components.  The token keeps
+  // its own copy of the data.
   Token(int token_type,
         std::string const & token_data,
         Tokenizer const * const source_tokenizer,
         std::string const & filename,
         int start_line, int end_line,
         int start_column, int end_column) :
+      Token(token_type, std::make_shared<std::string const>(token_data),
+            source_tokenizer, intern_filename(filename),
+            start_line, end_line,
+            start_column, end_column) { }
+
+  // Constructs a token whose data is a view of characters it does
+  // not copy.  The token (and its copies) share ownership of owner,
+  // which should keep those characters alive; if owner is empty,
+  // whoever owns them must keep them alive as long as the token.
+  // offset is where the token starts in its file, in characters.
+  Token(int token_type,
+        StringView token_data,
+        std::shared_ptr<void const> const & owner,
+        Tokenizer const * const source_tokenizer,
+        FileId file_id,
+        int start_line, int end_line,
+        int start_column, int end_column,
+        std::uint64_t offset = 0) :
       token_type_(token_type),
       token_data_(token_data),
+      data_owner_(owner),
       source_tokenizer_(source_tokenizer),
-      filename_(filename),
+      file_id_(file_id),
       start_line_(start_line),
       end_line_(end_line),
       start_column_(start_column),
-      end_column_(end_column) { }
+      end_column_(end_column),
+      offset_(offset) { }
+
+  // Constructs a token viewing its data, as above, that records only
+  // where it starts in its file.  Its lines and columns are worked
+  // out from line_index (by its offset and the length of its data)
+  // only if they're asked for, which they usually aren't.  owner must
+  // keep line_index alive, too.
+  Token(int token_type,
+        StringView token_data,
+        std::shared_ptr<void const> const & owner,
+        Tokenizer const * const source_tokenizer,
+        FileId file_id,
+        std::uint64_t offset,
+        LineIndex const *line_index) :
+      token_type_(token_type),
+      token_data_(token_data),
+      data_owner_(owner),
+      source_tokenizer_(source_tokenizer),
+      file_id_(file_id),
+      line_index_(line_index),
+      start_line_(0),
+      end_line_(0),
+      start_column_(0),
+      end_column_(0),
+      offset_(offset) { }
 
   int type() const {
     return token_type_;
   }
 
-  std::string const & data() const {
+  // A copy of this token's data.
+  std::string data() const {
+    return token_data_.to_string();
+  }
+
+  // This token's data, without copying it.  The view is valid as
+  // long as this token (or a copy of it) is.
+  StringView data_view() const {
     return token_data_;
   }
 
@@ -90,41 +149,91 @@ class Token {
   }
 
   std::string const & filename() const {
-    return filename_;
+    return filename_of(file_id_);
+  }
+
+  FileId file_id() const {
+    return file_id_;
   }
 
   int start_line() const {
-    return start_line_;
+    int line = start_line_, column;
+    if (line_index_ != nullptr)
+      line_index_->find_position(offset_, &line, &column);
+    return line;
   }
 
   int end_line() const {
-    return end_line_;
+    int line = end_line_, column;
+    if (line_index_ != nullptr)
+      line_index_->find_position(end_offset(), &line, &column);
+    return line;
   }
 
   int start_column() const {
-    return start_column_;
+    int line, column = start_column_;
+    if (line_index_ != nullptr)
+      line_index_->find_position(offset_, &line, &column);
+    return column;
   }
 
   int end_column() const {
-    return end_column_;
+    int line, column = end_column_;
+    if (line_index_ != nullptr)
+      line_index_->find_position(end_offset(), &line, &column);
+    return column;
+  }
+
+  std::uint64_t offset() const {
+    return offset_;
   }
 
   bool is_eof() const {
     return token_type_ == kEofToken;
   }
 
+  // The compact record of this token: its type, file and where its
+  // data lie in that file.
+  TokenRecord record() const {
+    TokenRecord record;
+    record.offset = offset_;
+    record.length = static_cast<std::uint32_t>(token_data_.size());
+    record.file_id = file_id_;
+    record.type = token_type_;
+    return record;
+  }
+
   // 0 is always the type of an EOF (end of file) token.
   static int const kEofToken = 0;
 
  private:
+  // The offset just past this token's data.
+  std::uint64_t end_offset() const {
+    return offset_ + token_data_.size();
+  }
+
+  // Constructs a token sharing ownership of its data.
+  Token(int token_type,
+        std::shared_ptr<std::string const> const & owned_data,
+        Tokenizer const * const source_tokenizer,
+        FileId file_id,
+        int start_line, int end_line,
+        int start_column, int end_column) :
+      Token(token_type, StringView(*owned_data), owned_data,
+            source_tokenizer, file_id,
+            start_line, end_line,
+            start_column, end_column) { }
+
   // Typically, an enum managed by the tokenizer that produced this
   // token.
-  int const token_type_;
+  int token_type_;
 
   // Data associated with this token, e.g., the text of a CDATA in
   // an XML document, the string representation of an opening
-  // bracket in a Racket document, etc.
-  std::string const token_data_;
+  // bracket in a Racket document, etc.  Usually a view into the
+  // tokenizer's input, which data_owner_ (if set) keeps alive.
+  StringView token_data_;
+  std::shared_ptr<void const> data_owner_;
 
 
   // The tokenizer that produced this token so that tokenizer can
@@ -135,15 +244,22 @@ class Token {
   // Two tokens compare equal if they have the same type, data, and
   // source tokenizer.  (So, for the last: are from the same
   // tokenizer or were created without a tokenizer stipulated.)
-  Tokenizer const * const source_tokenizer_;
+  Tokenizer const * source_tokenizer_;
 
   // The file and line and column range from which the token is
   // drawn.  (Note: it's conceivable as tokenizers work that a token
   // could actually come from multiple files.  We define correct
-  // behaviour in that case as recording the initial file only.)
-  std::string const filename_;
-  int const start_line_, end_line_;
-  int const start_column_, end_column_;
+  // behaviour in that case as recording the initial file only.)  The
+  // lines and columns are either given outright or, if there's a
+  // line_index_ (kept alive by data_owner_), found in it.
+  FileId file_id_;
+  LineIndex const *line_index_ = nullptr;
+  int start_line_, end_line_;
+  int start_column_, end_column_;
+
+  // The offset of the token's first character from the start of its
+  // file, if the tokenizer recorded it (else, 0).
+  std::uint64_t offset_;
 };
 
 
@@ -156,7 +272,7 @@ class Token {
 // 1-based, not 0-based.
 inline bool operator==(Token const &lhs, Token const &rhs) {
   return lhs.type() == rhs.type() &&
-      lhs.data() == rhs.data() &&
+      lhs.data_view() == rhs.data_view() &&
       lhs.source_tokenizer() == rhs.source_tokenizer();
 }
 inline bool operator!=(Token const &lhs, Token const &rhs) {
@@ -165,7 +281,7 @@ inline bool operator!=(Token const &lhs, Token const &rhs) {
 inline std::ostream& operator<<(std::ostream &os, Token const &token) {
   os << "[output for testing only: "
      << "token of type " << token.type()
-     << " with data " << token.data()
+     << " with data " << token.data_view()
      << " from " << token.source_tokenizer()
      << " at " << token.filename()
      << ":" << token.start_line()
@@ -0,0 +1,54 @@
+// token_record.h --- Simple, trivially copyable record of a token,
+// small enough to store by value in bulk (on stacks, in buffers) where
+// a full Token would be heavyweight.  Part of the RackaBrackaStack
+// project.
+
+// token_record.h is Copyright (C) 2014 by the University of British
+// Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#ifndef RACKET_BRACKET_STACK_TOKEN_RECORD_H_
+#define RACKET_BRACKET_STACK_TOKEN_RECORD_H_
+
+#include <cstdint>
+#include <type_traits>
+
+#include "./file_id.h"
+
+namespace tokenizer {
+// A token's type, file, and the range of that file holding its data.
+// Nothing else is stored: the data can be found from the range and
+// the line and column worked out from the offset when (and if) they
+// are needed.
+//
+// As with Tokens, type 0 is always EOF.
+struct TokenRecord {
+  std::uint64_t offset;   // Of the first character, from the start.
+  std::uint32_t length;   // In characters.
+  FileId file_id;
+  std::int32_t type;
+
+  bool is_eof() const {
+    return type == 0;
+  }
+};
+
+static_assert(std::is_trivially_copyable<TokenRecord>::value,
+              "TokenRecords must copy as plain bytes");
+static_assert(sizeof(TokenRecord) <= 24,
+              "TokenRecords must stay compact");
+
+// Two records are equal if they record the same token.
+inline bool operator==(TokenRecord const &lhs, TokenRecord const &rhs) {
+  return lhs.offset == rhs.offset && lhs.length == rhs.length &&
+      lhs.file_id == rhs.file_id && lhs.type == rhs.type;
+}
+inline bool operator!=(TokenRecord const &lhs, TokenRecord const &rhs) {
+  return !(lhs == rhs);
+}
+}  // namespace tokenizer
+
+#endif  // RACKET_BRACKET_STACK_TOKEN_RECORD_H_
@@ -17,7 +17,9 @@ using ::testing::Ne;
 #include <gtest/gtest.h>
 using ::testing::Test;
 
+#include <memory>
 #include <sstream>
+#include <string>
 
 #include "./token.h"
 
@@ -117,6 +119,51 @@ TEST_F(TokenTest, Equality) {
   EXPECT_THAT(token_1a8, Ne(token_1a4));
   EXPECT_THAT(token_1a8, Eq(token_1a8_copy));  // only differs by file/loc'n.
 }
+TEST_F(TokenTest, DataViews) {
+  // A token viewing data it doesn't own keeps its owner alive.
+  std::shared_ptr<std::string const> text =
+      std::make_shared<std::string const>("(hello)");
+  Token hello(85, StringView(text->data() + 1, 5), text, nullptr,
+              intern_filename("somefile.txt"), 1, 1, 2, 7);
+  std::weak_ptr<std::string const> weak_text = text;
+  text.reset();
+  EXPECT_FALSE(weak_text.expired());
+
+  EXPECT_THAT(hello.data(), Eq("hello"));
+  EXPECT_THAT(hello.data_view().size(), Eq(5u));
+  EXPECT_THAT(hello.filename(), Eq("somefile.txt"));
+  EXPECT_THAT(hello, Eq(Token(85, "hello", 5, 5, 5, 5)));
+
+  Token copy(hello);
+  EXPECT_THAT(copy.data_view().data(), Eq(hello.data_view().data()));
+}
+TEST_F(TokenTest, FileIds) {
+  EXPECT_THAT(intern_filename(""), Eq(kNoFileId));
+  EXPECT_THAT(intern_filename("a.rkt"), Eq(intern_filename("a.rkt")));
+  EXPECT_THAT(intern_filename("a.rkt"), Ne(intern_filename("b.rkt")));
+  EXPECT_THAT(filename_of(intern_filename("b.rkt")), Eq("b.rkt"));
+
+  Token t1(1, "x", "a.rkt", 1, 1, 1, 2), t2(2, "y", "a.rkt", 3, 3, 1, 2);
+  EXPECT_THAT(t1.file_id(), Eq(t2.file_id()));
+}
+TEST_F(TokenTest, Assignment) {
+  Token token(1, "a", "foo", 1, 1, 1, 2);
+  token = Token(2, "bc", "bar", 3, 4, 5, 6);
+  EXPECT_THAT(token, Eq(Token(2, "bc", 1, 1, 1, 1)));
+  EXPECT_THAT(token.filename(), Eq("bar"));
+  EXPECT_THAT(token.end_column(), Eq(6));
+}
+TEST_F(TokenTest, Record) {
+  Token token(7, StringView("hello", 5), nullptr, nullptr,
+              intern_filename("foo"), 1, 1, 3, 8, 1234);
+  TokenRecord record = token.record();
+  EXPECT_THAT(record.type, Eq(7));
+  EXPECT_THAT(record.offset, Eq(1234u));
+  EXPECT_THAT(record.length, Eq(5u));
+  EXPECT_THAT(record.file_id, Eq(intern_filename("foo")));
+  EXPECT_FALSE(record.is_eof());
+  EXPECT_TRUE(Token(0, "", 1, 1, 1, 1).record().is_eof());
+}
 // If we later decide to have the constructor do any error-testing,
 // this first template of a test may be handy, but for now, we do not.
 // // TEST(TokenTest, BadConstructorCalls) {
@@ -13,9 +13,13 @@
 #ifndef RACKET_BRACKET_STACK_TOKENIZER_H_
 #define RACKET_BRACKET_STACK_TOKENIZER_H_
 
+#include <cassert>
+#include <cstddef>
 #include <string>
+#include <vector>
 
 #include "./token.h"
+#include "./token_record.h"
 
 namespace tokenizer {
 
@@ -24,11 +28,50 @@ namespace tokenizer {
 // constructor, but that's left to the specific implementation.
 class Tokenizer {
  public:
+  virtual ~Tokenizer() { }
+
   // Consume just enough input to produce the next token and return
   // that token.  Note: ALL tokenizers must be capable of producing
   // the EOF token (the token with a type of 0).
   virtual Token next_token() = 0;
 
+  // Checks whether the tokenizer does next_tokens and token_for
+  // natively, giving back whole tokens from their records.  By
+  // default, no: wrap it in a TokenBatcher to fetch its tokens as
+  // records.
+  virtual bool batches_natively() const {
+    return false;
+  }
+
+  // Produces the next tokens (up to max > 0 of them) as next_token
+  // would, but as records in buffer, and returns how many.  Fewer
+  // than max come back only when the last is the EOF token.  This
+  // saves a call per token (and, where a tokenizer does it natively,
+  // building each Token).
+  //
+  // By default, calls next_token for each token and keeps only its
+  // record.
+  virtual std::size_t next_tokens(TokenRecord *buffer, std::size_t max) {
+    std::size_t count = 0;
+    while (count < max) {
+      buffer[count] = next_token().record();
+      if (buffer[count++].is_eof())
+        break;
+    }
+    return count;
+  }
+
+  // Gives back, whole, the token record stands for, given that it was
+  // the index-th record of the latest call to next_tokens (and that
+  // the tokenizer batches_natively; tokenizers that do may give back
+  // tokens from earlier calls, too).  Otherwise, gives back a token
+  // with only what the record says: no data, line or column.
+  virtual Token token_for(TokenRecord const &record,
+                          std::size_t /* index */) const {
+    return Token(record.type, StringView(), nullptr, nullptr,
+                 record.file_id, record.offset, nullptr);
+  }
+
   // Checks whether the two tokens are a matching pair, i.e., an
   // opening token and a closing token that closes it.
   virtual bool are_matching
@@ -46,6 +89,14 @@ class Tokenizer {
   // many languages " is both an opening and a closing token).
   virtual bool is_closing(Token const & token) const = 0;
 
+  // Checks whether is_opening, is_closing and are_matching look at
+  // nothing but the tokens' types, so that a BalanceChecker may ask
+  // once per type (or pair of types) and reuse the answer.  By
+  // default, no.
+  virtual bool classifies_by_type() const {
+    return false;
+  }
+
   // Checks whether the token is an EOF token.
   //
   // ALL Token types must reserve Token::kEofToken (0) as a token
@@ -54,6 +105,39 @@ class Tokenizer {
     return token.is_eof();
   }
 };
+
+// Fetches the tokens of a TokenizerT (Tokenizer or a subclass) that
+// doesn't batch natively a batch at a time, as records, keeping the
+// tokens of the latest batch to give them back whole.
+template <typename TokenizerT>
+class TokenBatcher {
+ public:
+  explicit TokenBatcher(TokenizerT *tokenizer) : tokenizer_(tokenizer) { }
+
+  // As Tokenizer::next_tokens.
+  std::size_t next_tokens(TokenRecord *buffer, std::size_t max) {
+    batch_.clear();
+    while (batch_.size() < max) {
+      batch_.push_back(tokenizer_->next_token());
+      buffer[batch_.size() - 1] = batch_.back().record();
+      if (batch_.back().is_eof())
+        break;
+    }
+    return batch_.size();
+  }
+
+  // The index-th token of the latest batch, whose record is record.
+  Token const &token_for(TokenRecord const &record,
+                         std::size_t index) const {
+    assert(index < batch_.size() && batch_[index].record() == record);
+    static_cast<void>(record);
+    return batch_[index];
+  }
+
+ private:
+  TokenizerT *tokenizer_;
+  std::vector<Token> batch_;
+};
 }  // namespace tokenizer
 
 #endif  // RACKET_BRACKET_STACK_TOKENIZER_H_
@@ -0,0 +1,199 @@
+// tokenizer_benchmark.cc --- Times tokenizing a synthetic Racket
+// corpus (see corpus_generator.h) with each tokenizer, including the
+// DelimiterTokenizer made from RacketSpec and RacketTokenizer in
+// batches, checking it with a BalanceChecker token by token and in
+// batches, and checking it end to end as racka_bracka does, and
+// reports the throughput in megabytes and tokens per second.
+
+// tokenizer_benchmark.cc is Copyright (C) 2014 by the University of
+// British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#include <cstdio>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "./basic_balance_checker.h"
+#include "./batch_checker.h"
+#include "./bracket_tokenizer.h"
+#include "./corpus_generator.h"
+#include "./language_tokenizers.h"
+#include "./racket_tokenizer.h"
+#include "./small_token_stack.h"
+#include "./structural_tokenizer.h"
+#include "./token_record.h"
+
+namespace {
+typedef std::chrono::steady_clock Clock;
+
+// Each measurement is the best of this many runs.
+int const kRuns = 3;
+
+// Returns the number of tokens, EOF included, tokenizer produces.
+template <typename TokenizerT>
+std::uint64_t count_tokens(TokenizerT *tokenizer) {
+  std::uint64_t tokens = 1;
+  while (!tokenizer->next_token().is_eof())
+    tokens++;
+  return tokens;
+}
+
+void print_throughput(char const *what, std::uint64_t bytes,
+                      std::uint64_t tokens, double seconds) {
+  std::cout << what << bytes / 1e6 / seconds << " MB/s";
+  if (tokens > 0)
+    std::cout << ", " << tokens / 1e6 / seconds << " M tokens/s";
+  std::cout << std::endl;
+}
+
+// Times tokenizing text with the streaming TokenizerT.
+template <typename TokenizerT>
+void time_streaming_tokenizer(char const *name, std::string const &text) {
+  double best = 0;
+  std::uint64_t tokens = 0;
+  for (int run = 0; run < kRuns; ++run) {
+    std::istringstream in(text);
+    Clock::time_point start = Clock::now();
+    TokenizerT tokenizer(in, "corpus");
+    tokens = count_tokens(&tokenizer);
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    best = run == 0 ? elapsed.count() : std::min(best, elapsed.count());
+  }
+  print_throughput(name, text.size(), tokens, best);
+}
+
+// Times tokenizing text with a RacketTokenizer's next_tokens.
+void time_next_tokens(char const *name, std::string const &text) {
+  double best = 0;
+  std::uint64_t tokens = 0;
+  for (int run = 0; run < kRuns; ++run) {
+    std::istringstream in(text);
+    Clock::time_point start = Clock::now();
+    tokenizer::RacketTokenizer tokenizer(in, "corpus");
+    tokenizer::TokenRecord batch[256];
+    tokens = 0;
+    std::size_t count;
+    do {
+      count = tokenizer.next_tokens(batch, 256);
+      tokens += count;
+    } while (!batch[count - 1].is_eof());
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    best = run == 0 ? elapsed.count() : std::min(best, elapsed.count());
+  }
+  print_throughput(name, text.size(), tokens, best);
+}
+
+// Times checking text with a BalanceChecker's checker over a
+// RacketTokenizer, through the Tokenizer interface, one token at a
+// time or in batches.
+void time_balance_checker(char const *name, std::string const &text,
+                          bool in_batches) {
+  double best = 0;
+  for (int run = 0; run < kRuns; ++run) {
+    std::istringstream in(text);
+    Clock::time_point start = Clock::now();
+    tokenizer::RacketTokenizer tokenizer(in, "corpus");
+    tokenizer::BasicBalanceChecker<tokenizer::Tokenizer,
+                                   tokenizer::SmallTokenStack>
+        checker(&tokenizer);
+    tokenizer::Token token = in_batches ? checker.check_balance_in_batches() :
+        checker.check_balance();
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    best = run == 0 ? elapsed.count() : std::min(best, elapsed.count());
+    if (!token.is_eof())
+      std::cerr << "Error: the corpus is not balanced." << std::endl;
+  }
+  print_throughput(name, text.size(), 0, best);
+}
+
+// Times checking the file as racka_bracka does, streaming it (on
+// one thread or pipelined on two) or mapping it.
+void time_check_file(char const *name, std::string const &filename,
+                     bool use_mmap, bool pipelined) {
+  double best = 0;
+  tokenizer::FileCheckResult result;
+  for (int run = 0; run < kRuns; ++run) {
+    Clock::time_point start = Clock::now();
+    result = tokenizer::check_file(filename, use_mmap, pipelined);
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    best = run == 0 ? elapsed.count() : std::min(best, elapsed.count());
+  }
+  if (!result.balanced)
+    std::cerr << "Error: the corpus is not balanced." << std::endl;
+  print_throughput(name, result.size, 0, best);
+}
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  std::uint64_t size = argc > 1 ? tokenizer::parse_corpus_size(argv[1]) : 0;
+  tokenizer::CorpusOptions options;
+  bool options_ok = true;
+  for (int i = 2; i < argc; ++i)
+    options_ok = options_ok && tokenizer::parse_corpus_option(argv[i],
+                                                              &options);
+  if (size == 0 || !options_ok) {
+    std::cerr << "Usage: " << argv[0] << " <size> [<option>...]"
+              << std::endl;
+    std::cerr << "\tGenerates a corpus of size bytes (or 64k, 16M, ...) "
+              << "with the options" << std::endl
+              << "\tmake_corpus takes, and times tokenizing and "
+              << "checking it." << std::endl;
+    return 1;
+  }
+
+  tokenizer::CorpusGenerator generator(options);
+  std::string text = generator.generate(size);
+
+  // racka_bracka reads files, so the end-to-end times need one.
+  std::string const filename = "tokenizer_benchmark_corpus.rkt";
+  {
+    std::ofstream file(filename, std::ofstream::binary);
+    file.write(text.data(), text.size());
+    if (!file) {
+      std::cerr << "Error: could not write " << filename << std::endl;
+      return 1;
+    }
+  }
+
+  std::cout << "Corpus of " << text.size() << " bytes:" << std::endl;
+  time_streaming_tokenizer<tokenizer::RacketTokenizer>(
+      "RacketTokenizer::next_token:     ", text);
+  time_next_tokens("RacketTokenizer::next_tokens:    ", text);
+  time_streaming_tokenizer<tokenizer::BracketTokenizer>(
+      "BracketTokenizer::next_token:    ", text);
+  time_streaming_tokenizer<tokenizer::RacketDelimiterTokenizer>(
+      "DelimiterTokenizer<RacketSpec>:  ", text);
+
+  double best = 0;
+  std::uint64_t tokens = 0;
+  for (int run = 0; run < kRuns; ++run) {
+    Clock::time_point start = Clock::now();
+    tokenizer::StructuralTokenizer structural(
+        text.data(), text.data() + text.size(), "corpus");
+    tokens = count_tokens(&structural);
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    best = run == 0 ? elapsed.count() : std::min(best, elapsed.count());
+  }
+  print_throughput("StructuralTokenizer::next_token: ", text.size(), tokens,
+                   best);
+
+  time_balance_checker("BalanceChecker, token by token: ", text, false);
+  time_balance_checker("BalanceChecker, in batches:     ", text, true);
+  time_check_file("racka_bracka, streamed:          ", filename, false,
+                  false);
+  time_check_file("racka_bracka --pipeline:         ", filename, false,
+                  true);
+  time_check_file("racka_bracka --mmap:             ", filename, true,
+                  false);
+  std::remove(filename.c_str());
+  return 0;
+}
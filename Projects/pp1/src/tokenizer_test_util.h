@@ -0,0 +1,69 @@
+// tokenizer_test_util.h --- Helpers shared by the tests that check a
+// tokenizer or balance checker against RacketTokenizer: random text
+// to check them on and the comparison of the tokens they find.
+
+// tokenizer_test_util.h is Copyright (C) 2014 by CPSC 221 at the
+// University of British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#ifndef RACKET_BRACKET_STACK_TOKENIZER_TEST_UTIL_H_
+#define RACKET_BRACKET_STACK_TOKENIZER_TEST_UTIL_H_
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <random>
+#include <string>
+
+#include "./token.h"
+
+namespace tokenizer {
+// What random text is made of unless a test says otherwise:
+// everything some tokenizer treats specially (brackets, quotation
+// marks, escapes, comments and line endings, and the #, | and ' that
+// start Racket's other comments, symbols and quotations) and a few
+// characters nothing does.
+char const kRandomTextAlphabet[] = "()[]{}\"\\;#|'\n\r\t ab";
+
+// Returns fewer than max_length (> 0) characters drawn from alphabet.
+inline std::string random_text(
+    std::default_random_engine *random, std::size_t max_length,
+    std::string const &alphabet = kRandomTextAlphabet) {
+  std::string text((*random)() % max_length, ' ');
+  for (char &c : text)
+    c = alphabet[(*random)() % alphabet.size()];
+  return text;
+}
+
+// Expects token to have been found in text just where expected was:
+// in the same file, at the same offset and lines and columns.
+inline void expect_same_position(Token const &token, Token const &expected,
+                                 std::string const &text) {
+  EXPECT_THAT(token.filename(), ::testing::Eq(expected.filename()))
+      << "in: " << text;
+  EXPECT_THAT(token.offset(), ::testing::Eq(expected.offset()))
+      << "in: " << text;
+  EXPECT_THAT(token.start_line(), ::testing::Eq(expected.start_line()))
+      << "in: " << text;
+  EXPECT_THAT(token.start_column(), ::testing::Eq(expected.start_column()))
+      << "in: " << text;
+  EXPECT_THAT(token.end_line(), ::testing::Eq(expected.end_line()))
+      << "in: " << text;
+  EXPECT_THAT(token.end_column(), ::testing::Eq(expected.end_column()))
+      << "in: " << text;
+}
+
+// Expects token to be expected (see operator==), found just where it
+// was in text.
+inline void expect_same_token(Token const &token, Token const &expected,
+                              std::string const &text) {
+  EXPECT_THAT(token, ::testing::Eq(expected)) << "in: " << text;
+  expect_same_position(token, expected, text);
+}
+}  // namespace tokenizer
+
+#endif  // RACKET_BRACKET_STACK_TOKENIZER_TEST_UTIL_H_
@@ -0,0 +1,68 @@
+// adversary.cc --- Defines how Evil Hangman picks which WordSet to
+// commit to after each guess.
+
+
+// adversary.cc is Copyright (C) 2014 by the University of British
+// Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+
+#include "./adversary.h"
+
+#include <algorithm>
+#include <cassert>
+#include <string>
+
+namespace evil_hangman {
+namespace {
+// choose_wordset, for either kind of options.
+template <typename Options>
+typename Options::size_type
+choose_option(Options const & options, char guess,
+              Tablebase const * tablebase) {
+  typedef typename Options::size_type size_type;
+  assert(!options.empty());
+  Arena::Scope scope(&turn_arena());
+
+  // Score every option from the tablebase, giving up on it entirely if
+  // any option is missing: a partial answer could mislead us.
+  std::vector<int, ArenaAllocator<int> > scores(
+      options.size(), 0, ArenaAllocator<int>(&turn_arena()));
+  bool scored = tablebase != nullptr && tablebase->is_open();
+  for (size_type i = 0; scored && i < options.size(); i++) {
+    int value;
+    if (tablebase->probe(options[i], &value)) {
+      int missed = options[i].pattern().find(guess) == std::string::npos;
+      scores[i] = missed + value;
+    } else {
+      scored = false;
+    }
+  }
+  if (!scored)
+    std::fill(scores.begin(), scores.end(), 0);
+
+  size_type best = 0;
+  for (size_type i = 1; i < options.size(); i++) {
+    if (scores[i] > scores[best] ||
+        (scores[i] == scores[best] && options[i].size() > options[best].size()))
+      best = i;
+  }
+  return best;
+}
+}  // namespace
+
+std::vector<WordSet>::size_type
+choose_wordset(std::vector<WordSet> const & options, char guess,
+               Tablebase const * tablebase) {
+  return choose_option(options, guess, tablebase);
+}
+
+WordSet::Options::size_type
+choose_wordset(WordSet::Options const & options, char guess,
+               Tablebase const * tablebase) {
+  return choose_option(options, guess, tablebase);
+}
+}  // namespace evil_hangman
@@ -0,0 +1,42 @@
+// adversary.h --- Declares how Evil Hangman picks which WordSet to
+// commit to after each guess.
+
+
+// adversary.h is Copyright (C) 2014 by the University of British
+// Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#ifndef DYNAMIC_HANGMAN_ADVERSARY_H_
+#define DYNAMIC_HANGMAN_ADVERSARY_H_
+
+#include <vector>
+
+#include "./word_set.h"
+#include "./tablebase.h"
+
+namespace evil_hangman {
+// Given the WordSets produced by partitioning the current WordSet on
+// guess, returns the index of the one the adversary commits to.
+//
+// If tablebase is non-null and has values for every option, picks the
+// option that forces the most further misses (counting this guess's
+// own miss).  Otherwise, or to break ties, picks the largest option,
+// and then the first in order.
+//
+// precondition: options is non-empty.
+//
+// Its temporaries come from the turn arena.
+std::vector<WordSet>::size_type
+choose_wordset(std::vector<WordSet> const & options, char guess,
+               Tablebase const * tablebase);
+
+// As above, for options partitioned into an arena.
+WordSet::Options::size_type
+choose_wordset(WordSet::Options const & options, char guess,
+               Tablebase const * tablebase);
+}  // namespace evil_hangman
+
+#endif  // DYNAMIC_HANGMAN_ADVERSARY_H_
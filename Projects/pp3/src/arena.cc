@@ -0,0 +1,57 @@
+// arena.cc --- Defines the bump allocator used for per-turn
+// temporaries in Evil Hangman.
+
+
+// arena.cc is Copyright (C) 2014 by the University of British Columbia,
+// Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+
+#include "./arena.h"
+
+#include <cassert>
+#include <algorithm>
+
+namespace evil_hangman {
+void *Arena::allocate(std::size_t bytes, std::size_t alignment) {
+  assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+  // Walk forward through the blocks we already own until one has
+  // room.  (Only the tail of the current block and whole later
+  // blocks are free.)
+  while (current_ < blocks_.size()) {
+    std::size_t aligned = (offset_ + alignment - 1) & ~(alignment - 1);
+    if (aligned + bytes <= blocks_[current_].size) {
+      offset_ = aligned + bytes;
+      return blocks_[current_].data.get() + aligned;
+    }
+    ++current_;
+    offset_ = 0;
+  }
+
+  // Out of blocks: grow.  Oversized requests get a block of their
+  // own.  (new char[] is suitably aligned for any fundamental type.)
+  Block block;
+  block.size = std::max(block_size_, bytes + alignment);
+  block.data.reset(new char[block.size]);
+  blocks_.push_back(std::move(block));
+  current_ = blocks_.size() - 1;
+  offset_ = bytes;
+  return blocks_[current_].data.get();
+}
+
+std::size_t Arena::capacity() const {
+  std::size_t total = 0;
+  for (Block const &block : blocks_)
+    total += block.size;
+  return total;
+}
+
+Arena & turn_arena() {
+  static thread_local Arena arena;
+  return arena;
+}
+}  // namespace evil_hangman
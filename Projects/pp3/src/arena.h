@@ -0,0 +1,134 @@
+// arena.h --- Declares a bump ("arena") allocator for the short-lived
+// temporaries produced while playing a single turn of hangman.
+
+
+// arena.h is Copyright (C) 2014 by the University of British Columbia,
+// Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#ifndef DYNAMIC_HANGMAN_ARENA_H_
+#define DYNAMIC_HANGMAN_ARENA_H_
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace evil_hangman {
+// An Arena hands out memory by bumping a pointer through a list of
+// large blocks.  Individual allocations are never freed; instead, the
+// whole arena (or everything allocated since a Scope began) is
+// released at once in O(1) time.  Blocks are kept after a reset so
+// that, once the arena has grown to the size a turn needs, later
+// turns never go back to the global operator new.
+//
+// Arenas are not thread-safe; use turn_arena() to get one per thread.
+class Arena {
+ public:
+  static std::size_t const kDefaultBlockSize = 64 * 1024;
+
+  explicit Arena(std::size_t block_size = kDefaultBlockSize)
+      : block_size_(block_size) { }
+
+  // Returns memory for bytes bytes aligned to alignment (which must
+  // be a power of two).  Never returns nullptr; throws
+  // std::bad_alloc if a new block cannot be allocated.
+  void *allocate(std::size_t bytes, std::size_t alignment);
+
+  // Releases everything allocated from this arena, keeping its
+  // blocks for reuse.
+  void reset() {
+    current_ = 0;
+    offset_ = 0;
+  }
+
+  // Total bytes held by the arena's blocks (used or not).
+  std::size_t capacity() const;
+
+  // Records the arena's position on construction and rewinds to it on
+  // destruction, releasing everything allocated in between.  Scopes
+  // nest, so a search can open one per node.
+  class Scope {
+   public:
+    explicit Scope(Arena *arena)
+        : arena_(arena), block_(arena->current_), offset_(arena->offset_) { }
+
+    ~Scope() {
+      arena_->current_ = block_;
+      arena_->offset_ = offset_;
+    }
+
+   private:
+    Scope(Scope const &);
+    Scope & operator=(Scope const &);
+
+    Arena *arena_;
+    std::size_t block_;
+    std::size_t offset_;
+  };
+
+ private:
+  struct Block {
+    std::unique_ptr<char[]> data;
+    std::size_t size;
+  };
+
+  Arena(Arena const &);
+  Arena & operator=(Arena const &);
+
+  std::size_t block_size_;
+  std::vector<Block> blocks_;
+
+  // Index of the block being bumped through and the first free byte
+  // within it.
+  std::size_t current_ = 0;
+  std::size_t offset_ = 0;
+};
+
+// The arena used for the temporaries of the current turn on this
+// thread.
+Arena & turn_arena();
+
+// A standard-library allocator drawing from an Arena.  deallocate is
+// a no-op; memory comes back when the arena (or Scope) is rewound.
+// Containers using it must not outlive that rewind.
+template <typename T>
+class ArenaAllocator {
+ public:
+  typedef T value_type;
+
+  explicit ArenaAllocator(Arena *arena) : arena_(arena) { }
+
+  template <typename U>
+  ArenaAllocator(ArenaAllocator<U> const &other)  // NOLINT(runtime/explicit)
+      : arena_(other.arena()) { }
+
+  T *allocate(std::size_t n) {
+    return static_cast<T *>(arena_->allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T *, std::size_t) { }
+
+  Arena *arena() const {
+    return arena_;
+  }
+
+ private:
+  Arena *arena_;
+};
+
+template <typename T, typename U>
+inline bool operator==(ArenaAllocator<T> const &lhs,
+                       ArenaAllocator<U> const &rhs) {
+  return lhs.arena() == rhs.arena();
+}
+template <typename T, typename U>
+inline bool operator!=(ArenaAllocator<T> const &lhs,
+                       ArenaAllocator<U> const &rhs) {
+  return !(lhs == rhs);
+}
+}  // namespace evil_hangman
+
+#endif  // DYNAMIC_HANGMAN_ARENA_H_
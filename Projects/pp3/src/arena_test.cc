@@ -0,0 +1,210 @@
+// arena_test.cc --- Test code for the Arena allocator declared in
+// arena.h, including a check that, once the turn arena has warmed up,
+// a turn's only global allocations are for the WordSets it hands on.
+
+// arena_test.cc is Copyright (C) 2014 by CPSC 221 at the
+// University of British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#include <gmock/gmock.h>
+using ::testing::Eq;
+using ::testing::Ne;
+using ::testing::Gt;
+using ::testing::Le;
+#include <gtest/gtest.h>
+using ::testing::Test;
+
+#include <cstdlib>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "./adversary.h"
+#include "./arena.h"
+#include "./word_set.h"
+
+// Count every trip through the global operator new so the tests can
+// prove a stretch of code never makes one.
+namespace {
+std::size_t global_new_calls = 0;
+}  // namespace
+
+void *operator new(std::size_t size) {
+  ++global_new_calls;
+  void *memory = std::malloc(size == 0 ? 1 : size);
+  if (memory == nullptr)
+    throw std::bad_alloc();
+  return memory;
+}
+void *operator new[](std::size_t size) {
+  return operator new(size);
+}
+void operator delete(void *memory) noexcept {
+  std::free(memory);
+}
+void operator delete[](void *memory) noexcept {
+  std::free(memory);
+}
+void operator delete(void *memory, std::size_t) noexcept {
+  std::free(memory);
+}
+void operator delete[](void *memory, std::size_t) noexcept {
+  std::free(memory);
+}
+
+namespace evil_hangman {
+namespace testing {
+class ArenaTest : public Test {
+ protected:
+  ArenaTest() : root_("________", make_words()) { }
+
+  // 26^3 eight-letter words (short enough for std::string to keep
+  // them inline), varied in their first three letters.
+  static WordSet::StrSet make_words() {
+    WordSet::StrSet words;
+    for (char a = 'a'; a <= 'z'; a++)
+      for (char b = 'a'; b <= 'z'; b++)
+        for (char c = 'a'; c <= 'z'; c++)
+          words.insert(std::string{a, b, c, 'q', 'u', 'i', 'z', 'z'});
+    return words;
+  }
+
+  virtual ~ArenaTest() { }
+
+  // What a turn of play_game allocated globally, and how many of its
+  // options were too large to keep their ids inline.
+  struct Turn {
+    std::size_t allocations;
+    std::size_t large_options;
+  };
+
+  // Plays a game of guesses 'a' to 'z' from root as Game does
+  // (partitioning each guess into the turn arena and committing to
+  // choose_wordset's option, with no tablebase), resetting the turn
+  // arena before each turn, and records each turn in turns.  Returns
+  // the final WordSet's size.
+  static std::size_t play_game(WordSet const &root, Turn turns[26]) {
+    WordSet word_set(root);
+    for (char guess = 'a'; guess <= 'z'; guess++) {
+      turn_arena().reset();
+      std::size_t calls = global_new_calls;
+      WordSet::Options options = word_set.partition(guess, &turn_arena());
+      word_set = options[choose_wordset(options, guess, nullptr)];
+      Turn &turn = turns[guess - 'a'];
+      turn.allocations = global_new_calls - calls;
+      turn.large_options = 0;
+      for (WordSet const &option : options) {
+        if (option.size() > WordSet::kInlineWords)
+          ++turn.large_options;
+      }
+    }
+    return word_set.size();
+  }
+
+  WordSet root_;
+};
+
+TEST_F(ArenaTest, AllocationsAreAlignedAndDistinct) {
+  Arena arena(128);
+  char *a = static_cast<char *>(arena.allocate(3, 1));
+  void *b = arena.allocate(sizeof(double), alignof(double));
+  void *c = arena.allocate(sizeof(std::int64_t), alignof(std::int64_t));
+
+  EXPECT_THAT(reinterpret_cast<std::uintptr_t>(b) % alignof(double), Eq(0));
+  EXPECT_THAT(reinterpret_cast<std::uintptr_t>(c) % alignof(std::int64_t),
+              Eq(0));
+  EXPECT_THAT(static_cast<void *>(a), Ne(b));
+  EXPECT_THAT(b, Ne(c));
+
+  // Requests larger than a block still succeed.
+  EXPECT_THAT(arena.allocate(1000, 8), Ne(nullptr));
+  EXPECT_THAT(arena.capacity(), Gt(1000u));
+}
+
+TEST_F(ArenaTest, ScopeRewinds) {
+  Arena arena(128);
+  void *before = nullptr;
+  {
+    Arena::Scope scope(&arena);
+    before = arena.allocate(16, 8);
+  }
+  // The scope released its allocation; the same memory comes back.
+  EXPECT_THAT(arena.allocate(16, 8), Eq(before));
+
+  arena.reset();
+  EXPECT_THAT(arena.allocate(16, 8), Eq(before));
+}
+
+TEST_F(ArenaTest, ResetKeepsBlocks) {
+  Arena arena(64);
+  for (int i = 0; i < 10; i++)
+    arena.allocate(48, 8);
+  std::size_t capacity = arena.capacity();
+
+  arena.reset();
+  std::size_t calls = global_new_calls;
+  for (int i = 0; i < 10; i++)
+    arena.allocate(48, 8);
+  std::size_t new_calls = global_new_calls - calls;
+
+  EXPECT_THAT(new_calls, Eq(0u));
+  EXPECT_THAT(arena.capacity(), Eq(capacity));
+}
+
+TEST_F(ArenaTest, AllocatorWorksWithVector) {
+  Arena arena;
+  std::vector<int, ArenaAllocator<int> > numbers{ArenaAllocator<int>(&arena)};
+  for (int i = 0; i < 1000; i++)
+    numbers.push_back(i);
+  EXPECT_THAT(numbers.size(), Eq(1000u));
+  EXPECT_THAT(numbers[999], Eq(999));
+}
+
+// A turn's temporaries (the options, the sorting in partition and
+// choose_wordset's scores) all come from the turn arena.  Once it has
+// grown to what a turn needs, a late-game turn, all of whose options
+// keep their ids inline, makes no global allocation at all.
+TEST_F(ArenaTest, SteadyStateLateGameTurnsDoNotAllocate) {
+  WordSet::StrSet words;
+  for (char a = 'a'; words.size() < WordSet::kInlineWords; a++)
+    words.insert(std::string{a, 'q', 'u', 'i', 'z', 'z', 'e', 'd'});
+  WordSet late_game("________", words);
+
+  Turn turns[26];
+  std::size_t warm_up = play_game(late_game, turns);
+
+  std::size_t calls = global_new_calls;
+  std::size_t steady = 0;
+  for (int round = 0; round < 3; round++)
+    steady += play_game(late_game, turns);
+  // Read the counter before gtest itself allocates anything.
+  std::size_t new_calls = global_new_calls - calls;
+
+  EXPECT_THAT(new_calls, Eq(0u));
+  EXPECT_THAT(steady, Eq(3 * warm_up));
+}
+
+// Earlier in a game, the options too large to keep their ids inline
+// are handed on with ids of their own: a shared list (the list and its
+// ids) each.  Those are a turn's only global allocations.
+TEST_F(ArenaTest, SteadyStateTurnsAllocateOnlyLargeOptions) {
+  Turn turns[26];
+  play_game(root_, turns);
+  play_game(root_, turns);
+
+  std::size_t late_turns = 0;
+  for (Turn const &turn : turns) {
+    EXPECT_THAT(turn.allocations, Le(2 * turn.large_options));
+    if (turn.large_options == 0) {
+      EXPECT_THAT(turn.allocations, Eq(0u));
+      ++late_turns;
+    }
+  }
+  EXPECT_THAT(late_turns, Gt(0u));
+}
+}  // namespace testing
+}  // namespace evil_hangman
@@ -0,0 +1,144 @@
+// build_tablebase.cc --- Offline tool that solves the small endgame
+// positions reachable from the dictionary and writes them out as an
+// Evil Hangman tablebase.
+
+
+// build_tablebase.cc is Copyright (C) 2014 by the University of
+// British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#include <cstdlib>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "./evil_hangman_utils.h"
+#include "./tablebase.h"
+#include "./word_set.h"
+
+namespace eh = evil_hangman;
+
+namespace {
+// The guesses of the players the tablebase is built for, at every
+// word length: letter-frequency orders of a few kinds.  (Transcripts
+// named on the command line add their own.)
+char const *const kGuessOrders[] = {
+  "etaoinshrdlcumwfgypbvkjxqz",
+  "eaiosrnltudcmphgbfywkvxzjq",
+  "aeiouystrnlcdmpbghfwkvxzjq",
+  "srtlnmdcpbghkfwvyzxjqeaiou",
+};
+
+void print_usage(char const *program) {
+  std::cerr << "Usage: " << program
+            << " [--max-words=N] [--output=FILE] [--transcripts-only]"
+            << std::endl
+            << "\t[FILE.in.txt...]" << std::endl
+            << "\tSolves the positions of at most N words (default 24) "
+            << "that games" << std::endl
+            << "\tagainst a few common guess orders reach, at every word "
+            << "length," << std::endl
+            << "\tand those each FILE.in.txt's game reaches, and writes "
+            << "them to FILE." << std::endl
+            << "\tWith --transcripts-only, just those of the FILE.in.txt "
+            << "games." << std::endl;
+}
+}  // namespace
+
+int main(int argc, char *argv[]) {
+#if defined(DICTIONARY_FILENAME) && defined(TABLEBASE_FILENAME)
+  std::string dictionary_filename{DICTIONARY_FILENAME};
+  std::string output_filename{TABLEBASE_FILENAME};
+#else
+  #error DICTIONARY_FILENAME and TABLEBASE_FILENAME must both be supplied.
+#endif
+
+  int max_words = 24;
+  bool transcripts_only = false;
+  std::vector<std::string> transcripts;
+  std::string const max_words_option("--max-words=");
+  std::string const output_option("--output=");
+  for (int i = 1; i < argc; i++) {
+    std::string arg(argv[i]);
+    if (arg.compare(0, max_words_option.size(), max_words_option) == 0) {
+      max_words = std::atoi(arg.c_str() + max_words_option.size());
+    } else if (arg.compare(0, output_option.size(), output_option) == 0) {
+      output_filename = arg.substr(output_option.size());
+    } else if (arg == "--transcripts-only") {
+      transcripts_only = true;
+    } else if (arg.compare(0, 2, "--") != 0) {
+      transcripts.push_back(arg);
+    } else {
+      print_usage(argv[0]);
+      return 1;
+    }
+  }
+  if (max_words < 1 || output_filename.empty()) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  // Load the dictionary exactly as the game does.
+  std::ifstream dictionary_input_stream(dictionary_filename);
+  eh::WordList words = eh::get_words_from_stream(&dictionary_input_stream);
+  std::transform(words.begin(), words.end(),
+                 words.begin(), eh::normalize_word);
+  std::set<std::string> words_as_set(words.cbegin(), words.cend());
+  eh::WordToLengthMap words_by_length = eh::get_words_by_length(words_as_set);
+  if (words_by_length.size() == 0) {
+    std::cerr << "Error: no words were present in the dictionary at: "
+              << dictionary_filename << std::endl;
+    return 1;
+  }
+
+  eh::TablebaseBuilder builder(max_words);
+  if (!transcripts_only) {
+    for (auto const &length_words : words_by_length) {
+      eh::WordSet root(std::string(length_words.first, '_'),
+                       length_words.second);
+      for (char const *guesses : kGuessOrders)
+        builder.seed(root, guesses);
+    }
+    std::cerr << "Common guess orders: " << builder.size()
+              << " positions solved." << std::endl;
+  }
+
+  // A transcript is the word length followed by the guesses.
+  for (std::string const &transcript : transcripts) {
+    std::ifstream in(transcript);
+    int length = 0;
+    std::string guesses;
+    char guess;
+    if (in >> length) {
+      while (in >> guess)
+        guesses.push_back(guess);
+    }
+    eh::WordToLengthMap::const_iterator length_words =
+        words_by_length.find(length);
+    if (length_words == words_by_length.cend()) {
+      std::cerr << "Error: no game of a dictionary word length in: "
+                << transcript << std::endl;
+      return 1;
+    }
+    builder.seed(eh::WordSet(std::string(length, '_'), length_words->second),
+                 guesses);
+    std::cerr << transcript << ": " << builder.size()
+              << " positions solved so far." << std::endl;
+  }
+
+  if (!builder.write(output_filename)) {
+    std::cerr << "Error: could not write the tablebase to: "
+              << output_filename << std::endl;
+    return 1;
+  }
+  std::cerr << "Wrote " << builder.size() << " positions to "
+            << output_filename << "." << std::endl;
+  return 0;
+}
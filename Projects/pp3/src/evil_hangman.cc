@@ -9,18 +9,59 @@
 // International License. To view a copy of this license, visit
 // http://creativecommons.org/licenses/by/4.0/.
 
-#include <cassert>
-
-#include <string>
-#include <iostream>
+#include <algorithm>
+#include <cctype>
 #include <fstream>
-#include <iterator>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
 
-#include "./word_set.h"
-#include "./evil_hangman_utils.h"
+#include "./game.h"
+#include "./replay.h"
+#include "./tablebase.h"
+#include "./turn_stats.h"
 
 namespace eh = evil_hangman;
 
+namespace {
+// The most threads --replay will use, however many are asked for.
+unsigned const kMaxJobs = 64;
+
+void print_usage(char const *program) {
+  std::cerr << "Usage: " << program
+            << " [--tablebase=FILE] [--stats=json]" << std::endl
+            << "       " << program
+            << " [--tablebase=FILE] --replay [--jobs=N] [--seed=N] "
+            << "FILE.in.txt..." << std::endl
+            << "\tWith --replay, plays each FILE.in.txt against one loaded "
+            << "dictionary" << std::endl
+            << "\t(on N threads, at most " << kMaxJobs
+            << ", with random choices seeded by N)" << std::endl
+            << "\tand compares the game with FILE.out.txt." << std::endl
+            << "\t--tablebase names the endgame tablebase to use (by default,"
+            << std::endl
+            << "\tthe one build_tablebase writes); --tablebase= uses none."
+            << std::endl;
+}
+
+// Parses the N of "<prefix>N" into *value.  Returns false if arg
+// does not start with prefix or N is not a number.  (N must be all
+// digits: unsigned extraction would otherwise take "-1" and wrap it.)
+bool parse_number(std::string const & arg, std::string const & prefix,
+                  unsigned *value) {
+  if (arg.compare(0, prefix.size(), prefix) != 0 ||
+      arg.size() == prefix.size() ||
+      !std::isdigit(static_cast<unsigned char>(arg[prefix.size()])))
+    return false;
+  std::istringstream number(arg.substr(prefix.size()));
+  return (number >> *value) && number.eof();
+}
+}  // namespace
+
 int main(int argc, char *argv[]) {
   // Check for the preconfigured dictionary filename.
 #ifdef DICTIONARY_FILENAME
@@ -32,121 +73,105 @@ int main(int argc, char *argv[]) {
   #error No value for the preprocessor constant DICTIONARY_FILENAME supplied.
 #endif
 
-  // Load the dictionary, separating words by length.
-
-  // Load the words from the file.
-  std::ifstream dictionary_input_stream(filename);
-  eh::WordList words = eh::get_words_from_stream(&dictionary_input_stream);
-  std::transform(words.begin(), words.end(),
-                 words.begin(), eh::normalize_word);
-  dictionary_input_stream.close();
-
-  // Convert the list to a set.
-  std::set<std::string> words_as_set(words.cbegin(), words.cend());
+  // --stats=json turns on the per-turn instrumentation and dumps it
+  // (to stderr, leaving the game's own output untouched) at exit.
+  // --replay switches to batch mode; see print_usage.
+  bool stats_json = false;
+  std::string tablebase_filename;
+#ifdef TABLEBASE_FILENAME
+  tablebase_filename = TABLEBASE_FILENAME;
+#endif
+  std::string const tablebase_option("--tablebase=");
+  bool replay = false;
+  unsigned jobs = std::min(kMaxJobs,
+                           std::max(1u, std::thread::hardware_concurrency()));
+  unsigned seed = 0;
+  // (Options may come in any order; whether those only --replay takes
+  // came without it is checked after.)
+  bool replay_options = false;
+  std::vector<std::string> transcripts;
+  for (int i = 1; i < argc; i++) {
+    std::string arg(argv[i]);
+    if (arg == "--stats=json") {
+      stats_json = true;
+    } else if (arg.compare(0, tablebase_option.size(), tablebase_option) == 0) {
+      tablebase_filename = arg.substr(tablebase_option.size());
+    } else if (arg == "--replay") {
+      replay = true;
+    } else if (parse_number(arg, "--jobs=", &jobs) && jobs > 0) {
+      jobs = std::min(jobs, kMaxJobs);
+      replay_options = true;
+    } else if (parse_number(arg, "--seed=", &seed)) {
+      replay_options = true;
+    } else if (arg.compare(0, 2, "--") != 0) {
+      transcripts.push_back(arg);
+    } else {
+      print_usage(argv[0]);
+      return 1;
+    }
+  }
+  if (replay ? stats_json || transcripts.empty()
+             : replay_options || !transcripts.empty()) {
+    print_usage(argv[0]);
+    return 1;
+  }
+  eh::TurnStats stats(stats_json);
+
+  // Open the endgame tablebase, if one has been built (see
+  // build_tablebase).  Without it, the game just plays on without
+  // exact endgame values.  Either way, say so (on stderr, leaving the
+  // game's own output untouched): the adversary plays differently.
+  eh::Tablebase tablebase;
+  if (tablebase_filename.empty()) {
+    std::cerr << "Playing without a tablebase." << std::endl;
+  } else if (tablebase.open(tablebase_filename)) {
+    std::cerr << "Using the tablebase " << tablebase_filename << " ("
+              << tablebase.size() << " positions of up to "
+              << tablebase.max_words() << " words)." << std::endl;
+  } else {
+    std::cerr << "No tablebase at " << tablebase_filename
+              << "; playing without one." << std::endl;
+  }
 
-  eh::WordToLengthMap words_by_length = eh::get_words_by_length(words_as_set);
-  if (words_by_length.size() == 0) {
+  // Load the dictionary, separating words by length.
+  std::unique_ptr<eh::Dictionary> dictionary;
+  {
+    eh::TurnStats::Timer timer(&stats, eh::TurnStats::kDictionaryLoad);
+    std::ifstream dictionary_input_stream(filename);
+    dictionary.reset(new eh::Dictionary(&dictionary_input_stream));
+  }
+  if (dictionary->empty()) {
     std::cerr << "Error: no words were present in the dictionary at: "
               << filename << std::endl;
     return 1;
   }
 
-
-  // Find out how many letters long the word should be.  Let the user
-  // know their options, and ensure a legal option is chosen.  (Just
-  // correct illegal options by picking the closest value; shortest if
-  // <= 0, largest if >= max, next larger otherwise if numeric,
-  // shortest if non-numeric.)
-  int length = eh::input_legal_length(&std::cin, &std::cout, words_by_length);
-
-
-  int const kNumWrongGuesses = 15;
-  int num_wrong_guesses = 0;
-  std::set<char> unguessed_letters;
-  for (char c = 'a'; c <= 'z'; c++)
-    unguessed_letters.insert(c);
-
-  // Generate a wordset with an empty pattern of the appropriate
-  // length and all the words of the appropriate length.
-  std::string init_pattern(length, '_');
-  eh::WordSet word_set(init_pattern, words_by_length[length]);
-
-  char guess;
-
-  // While the user has guesses left and hasn't guessed the word:
-  while (num_wrong_guesses < kNumWrongGuesses &&
-         word_set.pattern().find('_') != std::string::npos) {
-    // 1. print out the status/pattern so far
-    std::cout << "So far, you've got: "
-              << word_set.pattern()
-              << std::endl
-              << "You have " << kNumWrongGuesses - num_wrong_guesses
-              << " guesses left."
-              << std::endl
-              << std::endl;
-
-    // 2. print out the remaining letters to guess
-    std::cout << "Letters remaining to guess: ";
-    std::ostream_iterator<char> out_it(std::cout, " ");
-    std::copy(unguessed_letters.begin(), unguessed_letters.end(), out_it);
-    std::cout << std::endl << std::endl;
-
-    // 3. ask the user for a guess
-    std::cout << "What (lowercase) letter would you like to guess? ";
-    std::cin >> guess;
-    if (guess < 'a' || guess > 'z') {
-      std::cout << "Ooh.. I'm sorry, " << guess
-                << " is not a lowercase letter, and.." << std::endl
-                << "I'm evil. So, that counts against you."
-                << std::endl << std::endl;
-      num_wrong_guesses++;
-      continue;
-    } else if (unguessed_letters.find(guess) == unguessed_letters.end()) {
-      std::cout << "Actually you already guessed that, and since I'm evil.."
-                << std::endl << "I'll count it against you."
-                << std::endl << std::endl;
-      num_wrong_guesses++;
-      continue;
-    } else {
-      unguessed_letters.erase(guess);
-    }
-
-    word_set = word_set.generate_new_wordset(guess);
-
-    // TODO(you): use WordSet::partition to produce the list of
-    // distinct WordSets induced by the guess and choose the WordSet
-    // that is longest.
-    //
-    // Note: for the bonus, you might choose some OTHER strategy for
-    // selecting the WordSet.  (The longest isn't always the best, in
-    // our experience!  A REALLY good algorithm might perform a
-    // "minimax" search over the "moves" available to the player
-    // (guesses from a-z) and the "moves" available to the computer
-    // (partition options).)
-
-
-    // 5. indicate whether guess was in the word (if not, increment guesses)
-    if (word_set.pattern().find(guess) == std::string::npos) {
-      std::cout << "The letter '" << guess << "' was not in the word."
-                << std::endl;
-      num_wrong_guesses++;
-    } else {
-      std::cout << "Congratulations! The letter '" << guess
-                << "' was in the word!" << std::endl;
+  if (replay) {
+    std::vector<eh::ReplayResult> results =
+        eh::replay_transcripts(*dictionary, tablebase, transcripts,
+                               jobs, seed);
+    std::size_t matched = 0;
+    for (eh::ReplayResult const &result : results) {
+      if (result.matched) {
+        ++matched;
+      } else if (!result.error.empty()) {
+        std::cout << result.name << ": error: " << result.error << '\n';
+      } else {
+        std::cout << result.name << ":" << result.line << ": expected \""
+                  << result.expected << "\" but got \"" << result.actual
+                  << "\"\n";
+      }
     }
+    std::cout << matched << " of " << results.size()
+              << " transcripts matched." << std::endl;
+    return matched == results.size() ? 0 : 1;
   }
 
-  // indicate who won
-  if (num_wrong_guesses == kNumWrongGuesses) {
-    // Choose the "real word" at random, and inform the disappointed
-    // user.
-    std::cout << "Looks like I won. Huh.. what a surprise." << std::endl
-              << "Better luck next time. My word was: "
-              << word_set.choose_random_word() << std::endl;
-  } else {
-    std::cout << "My word was: " << *word_set.words().begin() << std::endl
-              << "You beat me?!  Try that again!" << std::endl;
-  }
+  std::default_random_engine random{std::random_device()()};
+  eh::play_game(*dictionary, tablebase, &std::cin, &std::cout,
+                &random, &stats);
 
+  if (stats.enabled())
+    stats.write_json(&std::cerr);
   return 0;
 }
@@ -70,7 +70,7 @@ std::string normalize_word(std::string const &word) {
 // zero and has at least one word associated with it, and the map has
 // at least one non-empty word in it.
 int convert_to_legal_length(int length,
-                            WordToLengthMap const word_to_length_map) {
+                            WordToLengthMap const & word_to_length_map) {
   assert(word_to_length_map.size() > 0);
 
   if (word_to_length_map.find(length) == word_to_length_map.cend()) {
@@ -104,7 +104,7 @@ int convert_to_legal_length(int length,
 // &output_stream.
 int input_legal_length(std::istream *input_stream,
                        std::ostream *output_stream,
-                       WordToLengthMap const word_to_length_map) {
+                       WordToLengthMap const & word_to_length_map) {
   assert(word_to_length_map.size() > 0);
 
   int length = 0;
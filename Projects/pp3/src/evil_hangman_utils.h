@@ -57,7 +57,7 @@ std::string normalize_word(std::string const &word);
 // zero and has at least one word associated with it, and the map has
 // at least one non-empty word in it.
 int convert_to_legal_length(int length,
-                            WordToLengthMap const word_to_length_map);
+                            WordToLengthMap const & word_to_length_map);
 
 // Get a legal length from the given input stream (i.e., a length that
 // has at least one word associated with it in the map).  Communicates
@@ -69,7 +69,7 @@ int convert_to_legal_length(int length,
 // at least one non-empty word in it.
 int input_legal_length(std::istream *input_stream,
                        std::ostream *output_stream,
-                       WordToLengthMap const word_to_length_map);
+                       WordToLengthMap const & word_to_length_map);
 }  // namespace evil_hangman
 
 #endif  // DYNAMIC_HANGMAN_EVIL_HANGMAN_UTILS_H_
@@ -0,0 +1,172 @@
+// game.cc --- Defines a single game of Evil Hangman, played over
+// arbitrary streams, and the Dictionary shared by every game.
+
+
+// game.cc is Copyright (C) 2014 by the University of British Columbia,
+// Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+
+#include "./game.h"
+
+#include <algorithm>
+#include <iterator>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "./adversary.h"
+#include "./arena.h"
+
+namespace evil_hangman {
+Dictionary::Dictionary(std::istream *input_stream) {
+  // Load the words, normalize them, and separate them by length.
+  WordList words = get_words_from_stream(input_stream);
+  std::transform(words.begin(), words.end(), words.begin(), normalize_word);
+  std::set<std::string> words_as_set(words.cbegin(), words.cend());
+  words_by_length_ = get_words_by_length(words_as_set);
+
+  for (auto const &length_words : words_by_length_) {
+    std::string init_pattern(length_words.first, '_');
+    roots_.insert(std::make_pair(length_words.first,
+                                 WordSet(init_pattern, length_words.second)));
+  }
+}
+
+// Output ends lines with '\n' rather than std::endl: nothing needs
+// flushing until the player is asked for input, and reading from
+// std::cin flushes std::cout (they are tied) anyway.
+void play_game(Dictionary const & dictionary,
+               Tablebase const & tablebase,
+               std::istream *input_stream,
+               std::ostream *output_stream,
+               std::default_random_engine *random,
+               TurnStats *stats) {
+  std::ostream &out = *output_stream;
+
+  // Find out how many letters long the word should be.  Let the user
+  // know their options, and ensure a legal option is chosen.  (Just
+  // correct illegal options by picking the closest value; shortest if
+  // <= 0, largest if >= max, next larger otherwise if numeric,
+  // shortest if non-numeric.)
+  int length;
+  {
+    TurnStats::Timer timer(stats, TurnStats::kInputLength);
+    length = input_legal_length(input_stream, output_stream,
+                                dictionary.words_by_length());
+  }
+
+  int num_wrong_guesses = 0;
+  std::set<char> unguessed_letters;
+  for (char c = 'a'; c <= 'z'; c++)
+    unguessed_letters.insert(c);
+
+  // Start from all the words of the appropriate length, with an
+  // empty pattern.
+  WordSet word_set(dictionary.root(length));
+
+  // (Starts as '\0', a wrong guess, in case the input runs out.)
+  char guess = '\0';
+
+  // While the user has guesses left and hasn't guessed the word:
+  while (num_wrong_guesses < kNumWrongGuesses &&
+         word_set.pattern().find('_') != std::string::npos) {
+    // Release last turn's temporaries (O(1); the arena keeps its
+    // blocks for this turn).
+    turn_arena().reset();
+    stats->begin_turn(word_set.size());
+
+    // 1. print out the status/pattern so far
+    {
+      TurnStats::Timer timer(stats, TurnStats::kOutput);
+      out << "So far, you've got: "
+          << word_set.pattern()
+          << '\n'
+          << "You have " << kNumWrongGuesses - num_wrong_guesses
+          << " guesses left."
+          << '\n'
+          << '\n';
+
+      // 2. print out the remaining letters to guess
+      out << "Letters remaining to guess: ";
+      std::ostream_iterator<char> out_it(out, " ");
+      std::copy(unguessed_letters.begin(), unguessed_letters.end(), out_it);
+      out << '\n' << '\n';
+
+      out << "What (lowercase) letter would you like to guess? ";
+    }
+
+    // 3. ask the user for a guess
+    (*input_stream) >> guess;
+    if (guess < 'a' || guess > 'z') {
+      stats->record_guess(guess, 0, 0);
+      TurnStats::Timer timer(stats, TurnStats::kOutput);
+      out << "Ooh.. I'm sorry, " << guess
+          << " is not a lowercase letter, and.." << '\n'
+          << "I'm evil. So, that counts against you."
+          << '\n' << '\n';
+      num_wrong_guesses++;
+      continue;
+    } else if (unguessed_letters.find(guess) == unguessed_letters.end()) {
+      stats->record_guess(guess, 0, 0);
+      TurnStats::Timer timer(stats, TurnStats::kOutput);
+      out << "Actually you already guessed that, and since I'm evil.."
+          << '\n' << "I'll count it against you."
+          << '\n' << '\n';
+      num_wrong_guesses++;
+      continue;
+    } else {
+      unguessed_letters.erase(guess);
+    }
+
+    // 4. partition the words on the guess and commit to the option
+    // that's worst for the player: the one forcing the most misses
+    // according to the tablebase, if it knows, or else the largest.
+    // The options are the turn's, in its arena.
+    WordSet::Options options{ArenaAllocator<WordSet>(&turn_arena())};
+    {
+      TurnStats::Timer timer(stats, TurnStats::kPartition);
+      options = word_set.partition(guess, &turn_arena());
+    }
+    if (stats->enabled()) {
+      WordSet::size_type largest = 0;
+      for (WordSet const &option : options)
+        largest = std::max(largest, option.size());
+      stats->record_guess(guess, options.size(), largest);
+    }
+    {
+      TurnStats::Timer timer(stats, TurnStats::kStrategy);
+      word_set = options[choose_wordset(options, guess, &tablebase)];
+    }
+
+
+    // 5. indicate whether guess was in the word (if not, increment guesses)
+    TurnStats::Timer timer(stats, TurnStats::kOutput);
+    if (word_set.pattern().find(guess) == std::string::npos) {
+      out << "The letter '" << guess << "' was not in the word."
+          << '\n';
+      num_wrong_guesses++;
+    } else {
+      out << "Congratulations! The letter '" << guess
+          << "' was in the word!" << '\n';
+    }
+  }
+
+  // indicate who won
+  TurnStats::Timer timer(stats, TurnStats::kOutput);
+  if (num_wrong_guesses == kNumWrongGuesses) {
+    // Choose the "real word" at random, and inform the disappointed
+    // user.
+    out << "Looks like I won. Huh.. what a surprise." << '\n'
+        << "Better luck next time. My word was: "
+        << word_set.choose_random_word(random) << '\n';
+  } else {
+    out << "My word was: " << *word_set.words().begin() << '\n'
+        << "You beat me?!  Try that again!" << '\n';
+  }
+  out.flush();
+}
+}  // namespace evil_hangman
@@ -0,0 +1,75 @@
+// game.h --- Declares a single game of Evil Hangman, played over
+// arbitrary streams, and the Dictionary shared by every game.
+
+
+// game.h is Copyright (C) 2014 by the University of British Columbia,
+// Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#ifndef DYNAMIC_HANGMAN_GAME_H_
+#define DYNAMIC_HANGMAN_GAME_H_
+
+#include <istream>
+#include <map>
+#include <ostream>
+#include <random>
+
+#include "./evil_hangman_utils.h"
+#include "./tablebase.h"
+#include "./turn_stats.h"
+#include "./word_set.h"
+
+namespace evil_hangman {
+// The number of wrong guesses that loses the game.
+int const kNumWrongGuesses = 15;
+
+// The words available to the game, loaded once.  A Dictionary is
+// never modified after construction, so any number of games (on any
+// number of threads) may share one.
+class Dictionary {
+ public:
+  // Reads whitespace-separated words from the given stream,
+  // normalizing them as the game always has (see normalize_word).
+  explicit Dictionary(std::istream *input_stream);
+
+  bool empty() const {
+    return words_by_length_.empty();
+  }
+
+  WordToLengthMap const & words_by_length() const {
+    return words_by_length_;
+  }
+
+  // All the words of the given length, with a blank pattern.  Every
+  // game of that length starts from (a cheap copy of) this set.
+  //
+  // precondition: words_by_length() has a key length.
+  WordSet const & root(int length) const {
+    return roots_.at(length);
+  }
+
+ private:
+  WordToLengthMap words_by_length_;
+  std::map<int, WordSet> roots_;
+};
+
+// Plays one game: reads the length and the guesses from input_stream
+// and writes the game to output_stream.  random picks the word
+// revealed when the player loses; tablebase (which may be closed)
+// guides the adversary; stats (which may be disabled) records the
+// turns.
+//
+// Note: our style guideline disallows non-const references. So, these
+// are pointers.
+void play_game(Dictionary const & dictionary,
+               Tablebase const & tablebase,
+               std::istream *input_stream,
+               std::ostream *output_stream,
+               std::default_random_engine *random,
+               TurnStats *stats);
+}  // namespace evil_hangman
+
+#endif  // DYNAMIC_HANGMAN_GAME_H_
@@ -0,0 +1,85 @@
+// game_test.cc --- Test code for the Dictionary and play_game
+// declared in game.h.
+
+// game_test.cc is Copyright (C) 2014 by CPSC 221 at the
+// University of British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#include <gmock/gmock.h>
+using ::testing::ElementsAre;
+using ::testing::Eq;
+using ::testing::HasSubstr;
+using ::testing::EndsWith;
+#include <gtest/gtest.h>
+using ::testing::Test;
+
+#include <random>
+#include <sstream>
+#include <string>
+
+#include "./game.h"
+
+namespace evil_hangman {
+namespace testing {
+class GameTest : public Test {
+ protected:
+  GameTest() : words_("Cat hat\n b-a-t  rabbit\tDOG"), dictionary_(&words_) { }
+
+  virtual ~GameTest() { }
+
+  // Plays a game on the given input, returning the output.
+  std::string play(std::string const & input, unsigned seed) {
+    std::istringstream input_stream(input);
+    std::ostringstream output_stream;
+    std::default_random_engine random(seed);
+    TurnStats stats;
+    play_game(dictionary_, tablebase_, &input_stream, &output_stream,
+              &random, &stats);
+    return output_stream.str();
+  }
+
+  std::istringstream words_;
+  Dictionary const dictionary_;
+  Tablebase const tablebase_;
+};
+
+TEST_F(GameTest, Dictionary) {
+  EXPECT_FALSE(dictionary_.empty());
+  EXPECT_THAT(dictionary_.words_by_length().size(), Eq(2u));
+  EXPECT_THAT(dictionary_.root(3).pattern(), Eq("___"));
+  EXPECT_THAT(dictionary_.root(3).words(),
+              ElementsAre("bat", "cat", "dog", "hat"));
+  EXPECT_THAT(dictionary_.root(6).words(), ElementsAre("rabbit"));
+
+  std::istringstream nothing("  ");
+  EXPECT_TRUE(Dictionary(&nothing).empty());
+}
+
+TEST_F(GameTest, PlayerWins) {
+  // a: all but dog have it; b, c: misses the adversary keeps dodging.
+  std::string output = play("3 a b c h t", 0);
+  EXPECT_THAT(output, HasSubstr("Congratulations! The letter 'a' was in"));
+  EXPECT_THAT(output, HasSubstr("The letter 'b' was not in the word."));
+  EXPECT_THAT(output, HasSubstr("The letter 'c' was not in the word."));
+  EXPECT_THAT(output, EndsWith("My word was: hat\n"
+                               "You beat me?!  Try that again!\n"));
+}
+
+TEST_F(GameTest, SeededLossesRepeat) {
+  // Fifteen non-letters lose; the word revealed depends only on the
+  // seed.
+  std::string input = "3 1 2 3 4 5 6 7 8 9 1 2 3 4 5 6";
+  std::string output = play(input, 42);
+  EXPECT_THAT(output, HasSubstr("Better luck next time. My word was: "));
+  EXPECT_THAT(play(input, 42), Eq(output));
+}
+
+TEST_F(GameTest, InputRunningOutEndsTheGame) {
+  std::string output = play("3", 0);
+  EXPECT_THAT(output, HasSubstr("Looks like I won."));
+}
+}  // namespace testing
+}  // namespace evil_hangman
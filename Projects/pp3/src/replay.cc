@@ -0,0 +1,154 @@
+// replay.cc --- Defines the batch replay of Evil Hangman transcripts:
+// many recorded games played at once against one loaded dictionary
+// and checked against their expected output.
+
+
+// replay.cc is Copyright (C) 2014 by the University of British Columbia,
+// Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+
+#include "./replay.h"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <thread>
+
+namespace {
+std::string const kInSuffix = ".in.txt";
+std::string const kOutSuffix = ".out.txt";
+
+// The line revealing the adversary's word when the player loses.
+std::string const kRandomLinePrefix = "Better luck next time.";
+
+bool ends_with(std::string const & str, std::string const & suffix) {
+  return str.size() >= suffix.size() &&
+      str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+bool read_file(std::string const & filename, std::string *contents) {
+  std::ifstream in(filename, std::ios::binary);
+  if (!in)
+    return false;
+  std::ostringstream buffer;
+  buffer << in.rdbuf();
+  *contents = buffer.str();
+  return true;
+}
+
+// Reads the next line worth comparing from text, starting at *pos.
+// Returns false once text runs out.
+bool next_line(std::string const & text, std::string::size_type *pos,
+               std::string *line) {
+  while (*pos < text.size()) {
+    std::string::size_type end = text.find('\n', *pos);
+    if (end == std::string::npos)
+      end = text.size();
+    line->assign(text, *pos, end - *pos);
+    *pos = end + 1;
+    if (line->compare(0, kRandomLinePrefix.size(), kRandomLinePrefix) != 0)
+      return true;
+  }
+  return false;
+}
+
+evil_hangman::ReplayResult replay_one(
+    evil_hangman::Dictionary const & dictionary,
+    evil_hangman::Tablebase const & tablebase,
+    std::string const & in_filename,
+    std::default_random_engine *random) {
+  evil_hangman::ReplayResult result;
+  result.name = in_filename;
+
+  if (!ends_with(in_filename, kInSuffix)) {
+    result.error = "not a " + kInSuffix + " file";
+    return result;
+  }
+  std::string out_filename =
+      in_filename.substr(0, in_filename.size() - kInSuffix.size()) +
+      kOutSuffix;
+
+  std::string input, expected;
+  if (!read_file(in_filename, &input)) {
+    result.error = "could not read " + in_filename;
+    return result;
+  }
+  if (!read_file(out_filename, &expected)) {
+    result.error = "could not read " + out_filename;
+    return result;
+  }
+
+  std::istringstream input_stream(input);
+  std::ostringstream output_stream;
+  evil_hangman::TurnStats no_stats;
+  evil_hangman::play_game(dictionary, tablebase, &input_stream,
+                          &output_stream, random, &no_stats);
+
+  evil_hangman::compare_transcripts(output_stream.str(), expected, &result);
+  return result;
+}
+}  // namespace
+
+namespace evil_hangman {
+void compare_transcripts(std::string const & actual,
+                         std::string const & expected,
+                         ReplayResult *result) {
+  std::string::size_type actual_pos = 0, expected_pos = 0;
+  std::string actual_line, expected_line;
+  for (std::size_t line = 1; ; line++) {
+    bool more_actual = next_line(actual, &actual_pos, &actual_line);
+    bool more_expected = next_line(expected, &expected_pos, &expected_line);
+    if (!more_actual && !more_expected)
+      break;
+    if (more_actual != more_expected || actual_line != expected_line) {
+      result->matched = false;
+      result->line = line;
+      result->actual = more_actual ? actual_line : "";
+      result->expected = more_expected ? expected_line : "";
+      return;
+    }
+  }
+  result->matched = true;
+  result->line = 0;
+  result->actual.clear();
+  result->expected.clear();
+}
+
+std::vector<ReplayResult> replay_transcripts(
+    Dictionary const & dictionary,
+    Tablebase const & tablebase,
+    std::vector<std::string> const & in_filenames,
+    unsigned jobs,
+    unsigned seed) {
+  std::vector<ReplayResult> results(in_filenames.size());
+
+  // Workers claim transcripts one at a time; each writes only its own
+  // results, so nothing else is shared but the (read-only)
+  // dictionary and tablebase.
+  std::atomic<std::size_t> next(0);
+  auto work = [&]() {
+    for (std::size_t i = next++; i < in_filenames.size(); i = next++) {
+      std::seed_seq seeds{seed, static_cast<unsigned>(i)};
+      std::default_random_engine random(seeds);
+      results[i] = replay_one(dictionary, tablebase, in_filenames[i],
+                              &random);
+    }
+  };
+
+  jobs = std::max(1u, std::min<unsigned>(jobs, in_filenames.size()));
+  std::vector<std::thread> threads;
+  for (unsigned i = 1; i < jobs; i++)
+    threads.push_back(std::thread(work));
+  work();
+  for (std::thread &thread : threads)
+    thread.join();
+
+  return results;
+}
+}  // namespace evil_hangman
@@ -0,0 +1,59 @@
+// replay.h --- Declares the batch replay of Evil Hangman transcripts:
+// many recorded games played at once against one loaded dictionary
+// and checked against their expected output.
+
+
+// replay.h is Copyright (C) 2014 by the University of British Columbia,
+// Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#ifndef DYNAMIC_HANGMAN_REPLAY_H_
+#define DYNAMIC_HANGMAN_REPLAY_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "./game.h"
+#include "./tablebase.h"
+
+namespace evil_hangman {
+// The outcome of replaying one transcript.
+struct ReplayResult {
+  std::string name;             // The .in.txt file replayed.
+  bool matched = false;
+  std::string error;            // Why the replay could not run, if so.
+
+  // If not matched (and no error), the first line that differs
+  // (1-based) and its text in each output.  An empty text past the
+  // end of an output means that output ran out.
+  std::size_t line = 0;
+  std::string expected;
+  std::string actual;
+};
+
+// Compares a game's output with the expected output line by line,
+// ignoring the lines revealing the adversary's word when the player
+// loses, which is chosen at random (as check_output_conformance
+// does).  Sets result's matched, line, expected and actual.
+void compare_transcripts(std::string const & actual,
+                         std::string const & expected,
+                         ReplayResult *result);
+
+// Replays every transcript X.in.txt in in_filenames, on up to jobs
+// threads, and compares each game with X.out.txt.  The i-th game
+// draws its random choices from an engine seeded with (seed, i), so
+// the results never depend on scheduling.  Returns the results in
+// the order of in_filenames.
+std::vector<ReplayResult> replay_transcripts(
+    Dictionary const & dictionary,
+    Tablebase const & tablebase,
+    std::vector<std::string> const & in_filenames,
+    unsigned jobs,
+    unsigned seed);
+}  // namespace evil_hangman
+
+#endif  // DYNAMIC_HANGMAN_REPLAY_H_
@@ -0,0 +1,130 @@
+// replay_test.cc --- Test code for the batch transcript replay
+// declared in replay.h.
+
+// replay_test.cc is Copyright (C) 2014 by CPSC 221 at the
+// University of British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#include <gmock/gmock.h>
+using ::testing::Eq;
+using ::testing::HasSubstr;
+#include <gtest/gtest.h>
+using ::testing::Test;
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "./replay.h"
+
+namespace evil_hangman {
+namespace testing {
+class ReplayTest : public Test {
+ protected:
+  ReplayTest() : words_("bat cat hat dog"), dictionary_(&words_) {
+    // A game the player wins and one the player loses, with their
+    // expected output generated by playing them once.
+    write_transcript("replay_test_win", "3 a b c h t");
+    write_transcript("replay_test_lose", "3 1 2 3 4 5 6 7 8 9 1 2 3 4 5 6");
+  }
+
+  virtual ~ReplayTest() {
+    for (std::string const &name : names_) {
+      std::remove((name + ".in.txt").c_str());
+      std::remove((name + ".out.txt").c_str());
+    }
+  }
+
+  void write_transcript(std::string const & name, std::string const & input) {
+    std::istringstream input_stream(input);
+    std::ostringstream output_stream;
+    std::default_random_engine random;
+    TurnStats stats;
+    play_game(dictionary_, tablebase_, &input_stream, &output_stream,
+              &random, &stats);
+    write_file(name + ".in.txt", input);
+    write_file(name + ".out.txt", output_stream.str());
+    names_.push_back(name);
+  }
+
+  void write_file(std::string const & filename, std::string const & text) {
+    std::ofstream out(filename);
+    out << text;
+  }
+
+  std::istringstream words_;
+  Dictionary const dictionary_;
+  Tablebase const tablebase_;
+  std::vector<std::string> names_;
+};
+
+TEST_F(ReplayTest, CompareTranscripts) {
+  ReplayResult result;
+  compare_transcripts("a\nb\n", "a\nb\n", &result);
+  EXPECT_TRUE(result.matched);
+
+  // The randomly chosen word is ignored.
+  compare_transcripts("a\nBetter luck next time. My word was: cat\nb\n",
+                      "a\nBetter luck next time. My word was: hat\nb\n",
+                      &result);
+  EXPECT_TRUE(result.matched);
+
+  compare_transcripts("a\nx\nc\n", "a\nb\nc\n", &result);
+  EXPECT_FALSE(result.matched);
+  EXPECT_THAT(result.line, Eq(2u));
+  EXPECT_THAT(result.actual, Eq("x"));
+  EXPECT_THAT(result.expected, Eq("b"));
+
+  // One output running out early is a difference, too.
+  compare_transcripts("a\n", "a\nb\n", &result);
+  EXPECT_FALSE(result.matched);
+  EXPECT_THAT(result.line, Eq(2u));
+  EXPECT_THAT(result.actual, Eq(""));
+}
+
+TEST_F(ReplayTest, ReplayMatches) {
+  std::vector<std::string> in_filenames;
+  for (int i = 0; i < 20; i++) {
+    in_filenames.push_back("replay_test_win.in.txt");
+    in_filenames.push_back("replay_test_lose.in.txt");
+  }
+
+  std::vector<ReplayResult> results =
+      replay_transcripts(dictionary_, tablebase_, in_filenames, 4, 7);
+  ASSERT_THAT(results.size(), Eq(in_filenames.size()));
+  for (std::vector<ReplayResult>::size_type i = 0; i < results.size(); i++) {
+    EXPECT_THAT(results[i].name, Eq(in_filenames[i]));
+    EXPECT_TRUE(results[i].matched) << results[i].name << ":"
+                                    << results[i].line;
+  }
+}
+
+TEST_F(ReplayTest, ReplayReportsDifferencesAndErrors) {
+  write_file("replay_test_win.out.txt", "Please enter something else\n");
+
+  std::vector<ReplayResult> results =
+      replay_transcripts(dictionary_, tablebase_,
+                         {"replay_test_win.in.txt",
+                          "replay_test_missing.in.txt",
+                          "replay_test_win.out.txt"},
+                         2, 0);
+  ASSERT_THAT(results.size(), Eq(3u));
+
+  EXPECT_FALSE(results[0].matched);
+  EXPECT_THAT(results[0].line, Eq(1u));
+  EXPECT_THAT(results[0].actual, HasSubstr("Please enter a length"));
+
+  EXPECT_FALSE(results[1].matched);
+  EXPECT_THAT(results[1].error, HasSubstr("replay_test_missing.in.txt"));
+
+  EXPECT_FALSE(results[2].matched);
+  EXPECT_THAT(results[2].error, HasSubstr(".in.txt"));
+}
+}  // namespace testing
+}  // namespace evil_hangman
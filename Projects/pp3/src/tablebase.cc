@@ -0,0 +1,277 @@
+// tablebase.cc --- Defines the Evil Hangman endgame tablebase: the
+// exact solver used to build it offline and the mapped reader used to
+// probe it during play.
+
+
+// tablebase.cc is Copyright (C) 2014 by the University of British
+// Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+
+#include "./tablebase.h"
+
+#include <cassert>
+#include <cstring>
+#include <climits>
+
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
+#include "./adversary.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+// 64-bit FNV-1a.
+std::uint64_t const kFnvOffset = 14695981039346656037ULL;
+std::uint64_t const kFnvPrime = 1099511628211ULL;
+
+std::uint64_t hash_bytes(std::uint64_t hash, std::string const & bytes) {
+  for (char c : bytes) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= kFnvPrime;
+  }
+  return hash;
+}
+
+std::uint64_t hash_separator(std::uint64_t hash) {
+  hash ^= '\n';
+  return hash * kFnvPrime;
+}
+
+// The part of an Entry holding its value.
+std::uint64_t const kValueMask =
+    (std::uint64_t(1) << evil_hangman::Tablebase::kValueBits) - 1;
+}  // namespace
+
+namespace evil_hangman {
+std::uint64_t position_key(WordSet const & word_set) {
+  std::uint64_t hash = hash_separator(hash_bytes(kFnvOffset,
+                                                 word_set.pattern()));
+  for (std::string const &word : word_set.words())
+    hash = hash_separator(hash_bytes(hash, word));
+  return hash;
+}
+
+char const Tablebase::kMagic[8] = {'E', 'H', 'T', 'B', 'A', 'S', 'E', '\0'};
+int const Tablebase::kValueBits;
+
+Tablebase::Entry Tablebase::make_entry(std::uint64_t key, int value) {
+  assert(value >= 0 && static_cast<std::uint64_t>(value) <= kValueMask);
+  // The key's top bits go in as is, but for a key with none set,
+  // which would make an empty slot of a value of 0.
+  std::uint64_t tag = key & ~kValueMask;
+  if (tag == 0)
+    tag = kValueMask + 1;
+  return tag | static_cast<std::uint64_t>(value);
+}
+
+bool Tablebase::entry_has_key(Entry entry, std::uint64_t key) {
+  return entry != 0 &&
+      (entry & ~kValueMask) == (make_entry(key, 0) & ~kValueMask);
+}
+
+bool Tablebase::open(std::string const & filename) {
+  close();
+
+  char const *bytes = nullptr;
+  std::size_t size = 0;
+
+#ifndef _WIN32
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat info;
+  if (fstat(fd, &info) == 0 && info.st_size > 0) {
+    size = static_cast<std::size_t>(info.st_size);
+    void *mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapped != MAP_FAILED) {
+      mapping_ = mapped;
+      mapping_size_ = size;
+      bytes = static_cast<char const *>(mapped);
+    }
+  }
+  ::close(fd);
+#endif
+
+  if (bytes == nullptr) {
+    // No mapping available: read the whole file instead.
+    std::ifstream in(filename, std::ios::binary);
+    if (!in)
+      return false;
+    in.seekg(0, std::ios::end);
+    size = static_cast<std::size_t>(in.tellg());
+    in.seekg(0, std::ios::beg);
+    copy_ = new char[size == 0 ? 1 : size];
+    if (!in.read(copy_, size)) {
+      close();
+      return false;
+    }
+    bytes = copy_;
+  }
+
+  Header const *header = reinterpret_cast<Header const *>(bytes);
+  if (size < sizeof(Header) ||
+      std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 ||
+      header->version != kVersion ||
+      header->capacity == 0 || header->count > header->capacity ||
+      (size - sizeof(Header)) / sizeof(Entry) < header->capacity) {
+    close();
+    return false;
+  }
+
+  header_ = header;
+  entries_ = reinterpret_cast<Entry const *>(bytes + sizeof(Header));
+  return true;
+}
+
+void Tablebase::close() {
+#ifndef _WIN32
+  if (mapping_ != nullptr)
+    munmap(mapping_, mapping_size_);
+#endif
+  mapping_ = nullptr;
+  mapping_size_ = 0;
+  delete [] copy_;
+  copy_ = nullptr;
+  header_ = nullptr;
+  entries_ = nullptr;
+}
+
+bool Tablebase::probe(WordSet const & word_set, int *value) const {
+  if (header_ == nullptr || word_set.size() > header_->max_words)
+    return false;
+
+  std::uint64_t key = position_key(word_set);
+  std::uint64_t capacity = header_->capacity;
+  std::uint64_t slot = key % capacity;
+  // The builder leaves a fifth of the table empty, so an empty slot
+  // ends the probe long before it wraps around; only a corrupt file
+  // (with no empty slot) could go on past capacity steps.
+  for (std::uint64_t step = 0; step < capacity; step++) {
+    Entry entry = entries_[slot];
+    if (entry_has_key(entry, key)) {
+      *value = static_cast<int>(entry & kValueMask);
+      return true;
+    }
+    if (entry == 0)
+      return false;
+    if (++slot == capacity)
+      slot = 0;
+  }
+  return false;
+}
+
+int TablebaseBuilder::solve(WordSet const & word_set) {
+  assert(word_set.size() <= max_words_);
+
+  std::uint64_t key = position_key(word_set);
+  std::unordered_map<std::uint64_t, int>::const_iterator found =
+      values_.find(key);
+  if (found != values_.cend())
+    return found->second;
+
+  // The letters worth guessing: in some word but not yet revealed.
+  bool candidate[26] = {false};
+  for (std::string const &word : word_set.words())
+    for (char c : word)
+      candidate[c - 'a'] = true;
+  for (char c : word_set.pattern())
+    if (c != '_')
+      candidate[c - 'a'] = false;
+
+  // One word (or nothing left to reveal) costs no more misses.
+  int best = 0;
+  if (word_set.size() > 1) {
+    best = INT_MAX;
+    for (char guess = 'a'; guess <= 'z'; guess++) {
+      if (!candidate[guess - 'a'])
+        continue;
+
+      // The adversary answers with the worst option for the player.
+      // No pruning here: the game probes every option of whatever
+      // the player guesses, so every child must end up in the table.
+      int worst = 0;
+      for (WordSet const &option : word_set.partition(guess)) {
+        int missed = option.pattern().find(guess) == std::string::npos;
+        worst = std::max(worst, missed + solve(option));
+      }
+      best = std::min(best, worst);
+    }
+  }
+
+  values_[key] = best;
+  return best;
+}
+
+void TablebaseBuilder::seed(WordSet const & word_set,
+                            std::string const & guesses) {
+  WordSet position(word_set);
+  for (char guess : guesses) {
+    if (position.size() <= max_words_) {
+      solve(position);
+      return;
+    }
+    if (guess < 'a' || guess > 'z' ||
+        position.pattern().find(guess) != std::string::npos)
+      continue;
+
+    // Whatever the player guesses here, the game probes every option
+    // of it; solve them all where it can use the answers.
+    for (char other = 'a'; other <= 'z'; other++) {
+      if (position.pattern().find(other) != std::string::npos)
+        continue;
+      std::vector<WordSet> options = position.partition(other);
+      if (std::all_of(options.cbegin(), options.cend(),
+                      [this](WordSet const & option) {
+                        return option.size() <= max_words_;
+                      })) {
+        for (WordSet const &option : options)
+          solve(option);
+      }
+    }
+
+    std::vector<WordSet> options = position.partition(guess);
+    position = options[choose_wordset(options, guess, nullptr)];
+  }
+  if (position.size() <= max_words_)
+    solve(position);
+}
+
+bool TablebaseBuilder::write(std::string const & filename) const {
+  // Keep the table about 80% full: compact, with probes still short.
+  std::uint64_t capacity = values_.size() + values_.size() / 4 + 1;
+
+  std::vector<Tablebase::Entry> entries(capacity);
+  for (auto const &value : values_) {
+    std::uint64_t slot = value.first % capacity;
+    while (entries[slot] != 0) {
+      if (++slot == capacity)
+        slot = 0;
+    }
+    entries[slot] = Tablebase::make_entry(value.first, value.second);
+  }
+
+  Tablebase::Header header;
+  std::memcpy(header.magic, Tablebase::kMagic, sizeof(header.magic));
+  header.version = Tablebase::kVersion;
+  header.max_words = static_cast<std::uint32_t>(max_words_);
+  header.capacity = capacity;
+  header.count = values_.size();
+
+  std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<char const *>(&header), sizeof(header));
+  out.write(reinterpret_cast<char const *>(entries.data()),
+            entries.size() * sizeof(Tablebase::Entry));
+  return static_cast<bool>(out);
+}
+}  // namespace evil_hangman
@@ -0,0 +1,155 @@
+// tablebase.h --- Declares the endgame tablebase for Evil Hangman: a
+// precomputed table of exact adversary values for small WordSets,
+// built offline by build_tablebase and probed by the game.
+
+
+// tablebase.h is Copyright (C) 2014 by the University of British
+// Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#ifndef DYNAMIC_HANGMAN_TABLEBASE_H_
+#define DYNAMIC_HANGMAN_TABLEBASE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "./word_set.h"
+
+namespace evil_hangman {
+// The value of a position (a WordSet) is the number of wrong guesses
+// the adversary can force before the word is fully revealed, assuming
+// the player guesses optimally and the adversary always answers with
+// the worst partition for the player.  It depends only on the words
+// and the pattern: a sensible player never repeats a guess or guesses
+// a letter that no remaining word contains.
+
+// Hashes the pattern and words of a WordSet into the 64-bit key used
+// by the tablebase.
+//
+// Only the key's top 56 bits are stored, so two positions that agree
+// in them are indistinguishable: probing one gives the other's value.
+// With n positions in a table, the chance of any such collision is
+// about n^2 / 2^57 (under one in 10^5 for a million positions), which
+// the game accepts rather than storing the positions themselves.
+std::uint64_t position_key(WordSet const & word_set);
+
+// A read-only tablebase file, memory-mapped where the platform allows.
+//
+// File layout (native byte order): a Header followed by a linearly
+// probed hash table of capacity Entry slots, a position's probe
+// starting at its key modulo capacity.  The table is kept about 80%
+// full, so a file takes about 10 bytes per position.
+class Tablebase {
+ public:
+  struct Header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t max_words;      // Largest WordSet solved.
+    std::uint64_t capacity;       // Number of Entry slots.
+    std::uint64_t count;          // Number of slots in use.
+  };
+
+  // A position's entry holds the top 56 bits of its key over its
+  // value in the low kValueBits bits (see make_entry).  An empty
+  // slot's entry is 0.
+  typedef std::uint64_t Entry;
+  static int const kValueBits = 8;
+
+  // The entry for the position with the given key and value (at most
+  // 2^kValueBits - 1).  Never 0.
+  static Entry make_entry(std::uint64_t key, int value);
+
+  // Whether entry is the one for a position with the given key.
+  static bool entry_has_key(Entry entry, std::uint64_t key);
+
+  static char const kMagic[8];
+  static std::uint32_t const kVersion = 2;
+
+  Tablebase() { }
+  ~Tablebase() { close(); }
+
+  // Opens (and maps) the given file.  Returns false, leaving the
+  // tablebase empty, if the file is missing or not a tablebase.
+  bool open(std::string const & filename);
+
+  void close();
+
+  bool is_open() const {
+    return header_ != nullptr;
+  }
+
+  // The largest WordSet size the tablebase covers (0 if closed).
+  std::size_t max_words() const {
+    return header_ == nullptr ? 0 : header_->max_words;
+  }
+
+  std::size_t size() const {
+    return header_ == nullptr ? 0 : header_->count;
+  }
+
+  // Looks up the value of the given position.  Returns false if the
+  // position is not in the table.  (See position_key on collisions:
+  // a position that isn't in the table may, very rarely, come back
+  // with the value of one that is.)
+  bool probe(WordSet const & word_set, int *value) const;
+
+ private:
+  Tablebase(Tablebase const &);
+  Tablebase & operator=(Tablebase const &);
+
+  Header const *header_ = nullptr;
+  Entry const *entries_ = nullptr;
+
+  // Where the file's bytes live: either a mapping or, where mapping
+  // is unavailable, a heap copy.
+  void *mapping_ = nullptr;
+  std::size_t mapping_size_ = 0;
+  char *copy_ = nullptr;
+};
+
+// Solves small positions exactly and writes them out as a tablebase
+// file.  Used by the offline build_tablebase tool.
+class TablebaseBuilder {
+ public:
+  // Positions with more than max_words words are never solved.
+  explicit TablebaseBuilder(std::size_t max_words) : max_words_(max_words) { }
+
+  // Returns the exact value of the position, memoizing it and every
+  // position searched on the way.
+  //
+  // precondition: word_set.size() <= max_words().
+  int solve(WordSet const & word_set);
+
+  // Plays a game from word_set as evil_hangman would against a player
+  // making the given guesses in order, the adversary keeping the
+  // largest option (as choose_wordset does without a tablebase).  On
+  // the way, solves every position the game could probe: whenever all
+  // the options of some guess have at most max_words() words, all of
+  // them, and finally the first position that small (which covers
+  // everything reachable from it, too).
+  void seed(WordSet const & word_set, std::string const & guesses);
+
+  // Writes all solved positions to the given file.  Returns false if
+  // the file could not be written.
+  bool write(std::string const & filename) const;
+
+  std::size_t max_words() const {
+    return max_words_;
+  }
+
+  std::size_t size() const {
+    return values_.size();
+  }
+
+ private:
+  std::size_t max_words_;
+  std::unordered_map<std::uint64_t, int> values_;
+};
+}  // namespace evil_hangman
+
+#endif  // DYNAMIC_HANGMAN_TABLEBASE_H_
@@ -0,0 +1,208 @@
+// tablebase_test.cc --- Test code for the endgame tablebase declared
+// in tablebase.h and the adversary's choice in adversary.h.
+
+// tablebase_test.cc is Copyright (C) 2014 by CPSC 221 at the
+// University of British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#include <gmock/gmock.h>
+using ::testing::Eq;
+using ::testing::Ne;
+#include <gtest/gtest.h>
+using ::testing::Test;
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "./adversary.h"
+#include "./tablebase.h"
+#include "./word_set.h"
+
+namespace evil_hangman {
+namespace testing {
+class TablebaseTest : public Test {
+ protected:
+  TablebaseTest() :
+      one_("___", {"bat"}),
+      two_("___", {"bat", "cat"}),
+      three_("___", {"bat", "cat", "hat"}),
+      disjoint_("__", {"ab", "cd"}),
+      filename_("tablebase_test.bin") {
+  }
+
+  virtual ~TablebaseTest() {
+    std::remove(filename_.c_str());
+  }
+
+  WordSet const one_;
+  WordSet const two_;
+  WordSet const three_;
+  WordSet const disjoint_;
+  std::string const filename_;
+};
+
+TEST_F(TablebaseTest, Entries) {
+  std::uint64_t key = position_key(three_);
+  Tablebase::Entry entry = Tablebase::make_entry(key, 17);
+  EXPECT_THAT(entry & 0xff, Eq(17u));
+  EXPECT_TRUE(Tablebase::entry_has_key(entry, key));
+  EXPECT_FALSE(Tablebase::entry_has_key(entry, ~key));
+  EXPECT_FALSE(Tablebase::entry_has_key(0, key));
+
+  // A key with only low bits set still makes a non-empty entry.
+  EXPECT_THAT(Tablebase::make_entry(5, 0), Ne(0u));
+  EXPECT_TRUE(Tablebase::entry_has_key(Tablebase::make_entry(5, 0), 5));
+}
+
+TEST_F(TablebaseTest, PositionKey) {
+  EXPECT_THAT(position_key(two_), Eq(position_key(WordSet(two_))));
+  EXPECT_THAT(position_key(two_), Ne(position_key(three_)));
+  EXPECT_THAT(position_key(two_), Ne(position_key(WordSet("_a_",
+                                                          two_.words()))));
+}
+
+TEST_F(TablebaseTest, Solve) {
+  TablebaseBuilder builder(8);
+
+  // One word never costs a miss.
+  EXPECT_THAT(builder.solve(one_), Eq(0));
+
+  // b or c: whichever is guessed, the adversary picks the other word.
+  EXPECT_THAT(builder.solve(two_), Eq(1));
+  EXPECT_THAT(builder.solve(disjoint_), Eq(1));
+
+  // Each first letter guessed is one more the adversary can dodge.
+  EXPECT_THAT(builder.solve(three_), Eq(2));
+
+  // Fully revealed.
+  EXPECT_THAT(builder.solve(WordSet("bat", {"bat"})), Eq(0));
+}
+
+TEST_F(TablebaseTest, SeedSolvesWhatTheGameProbes) {
+  TablebaseBuilder builder(2);
+  builder.seed(three_, "b");
+  ASSERT_TRUE(builder.write(filename_));
+  Tablebase tablebase;
+  ASSERT_TRUE(tablebase.open(filename_));
+
+  // three_ is too big to solve, but every option of guessing one of
+  // its first letters is small enough, so the game can use them all.
+  int value = -1;
+  EXPECT_FALSE(tablebase.probe(three_, &value));
+  for (char guess : {'b', 'c', 'h'}) {
+    for (WordSet const &option : three_.partition(guess))
+      EXPECT_TRUE(tablebase.probe(option, &value)) << option;
+  }
+  TablebaseBuilder reference(8);
+  EXPECT_TRUE(tablebase.probe(WordSet("___", {"cat", "hat"}), &value));
+  EXPECT_THAT(value, Eq(reference.solve(WordSet("___", {"cat", "hat"}))));
+}
+
+TEST_F(TablebaseTest, WriteAndProbe) {
+  TablebaseBuilder builder(4);
+  builder.solve(three_);
+  builder.solve(disjoint_);
+  ASSERT_TRUE(builder.write(filename_));
+
+  Tablebase tablebase;
+  ASSERT_TRUE(tablebase.open(filename_));
+  EXPECT_THAT(tablebase.max_words(), Eq(4u));
+  EXPECT_THAT(tablebase.size(), Eq(builder.size()));
+
+  int value = -1;
+  EXPECT_TRUE(tablebase.probe(three_, &value));
+  EXPECT_THAT(value, Eq(2));
+  EXPECT_TRUE(tablebase.probe(two_, &value));
+  EXPECT_THAT(value, Eq(1));
+  EXPECT_TRUE(tablebase.probe(disjoint_, &value));
+  EXPECT_THAT(value, Eq(1));
+
+  // Never solved.
+  EXPECT_FALSE(tablebase.probe(WordSet("___", {"dog", "fog"}), &value));
+
+  // Eight bytes a slot, at most a fifth of them (and one) empty.
+  std::ifstream in(filename_, std::ios::binary | std::ios::ate);
+  EXPECT_THAT(static_cast<std::size_t>(in.tellg()),
+              Eq(sizeof(Tablebase::Header) +
+                 8 * (builder.size() + builder.size() / 4 + 1)));
+}
+
+TEST_F(TablebaseTest, OpenRejectsBadFiles) {
+  Tablebase tablebase;
+  EXPECT_FALSE(tablebase.open("no_such_tablebase.bin"));
+
+  std::ofstream out(filename_);
+  out << "definitely not a tablebase";
+  out.close();
+  EXPECT_FALSE(tablebase.open(filename_));
+  EXPECT_FALSE(tablebase.is_open());
+
+  int value;
+  EXPECT_FALSE(tablebase.probe(two_, &value));
+}
+
+TEST_F(TablebaseTest, ProbeStopsOnAFullTable) {
+  // A corrupt table with no empty slot to end a probe.
+  Tablebase::Header header;
+  std::memcpy(header.magic, Tablebase::kMagic, sizeof(header.magic));
+  header.version = Tablebase::kVersion;
+  header.max_words = 4;
+  header.capacity = 4;
+  header.count = 4;
+  std::vector<Tablebase::Entry> entries(4);
+  for (std::uint64_t i = 0; i < entries.size(); i++)
+    entries[i] = Tablebase::make_entry(~position_key(three_), 1);
+  std::ofstream out(filename_, std::ios::binary);
+  out.write(reinterpret_cast<char const *>(&header), sizeof(header));
+  out.write(reinterpret_cast<char const *>(entries.data()),
+            entries.size() * sizeof(Tablebase::Entry));
+  out.close();
+
+  Tablebase tablebase;
+  ASSERT_TRUE(tablebase.open(filename_));
+  int value;
+  EXPECT_FALSE(tablebase.probe(three_, &value));
+}
+
+TEST_F(TablebaseTest, ChooseWordsetWithoutTablebase) {
+  // Partitioning "bat", "cat", "hat" on 'a' gives one option;
+  // on 'b' the largest is the miss.
+  std::vector<WordSet> options = three_.partition('b');
+  ASSERT_THAT(options.size(), Eq(2u));
+  EXPECT_THAT(options[choose_wordset(options, 'b', nullptr)].size(), Eq(2u));
+
+  // Ties go to the first option.
+  options = disjoint_.partition('a');
+  EXPECT_THAT(choose_wordset(options, 'a', nullptr), Eq(0u));
+}
+
+TEST_F(TablebaseTest, ChooseWordsetWithTablebase) {
+  // Guessing 'd' splits off "dabc", "dbca", "dcab", which one guess
+  // of 'a' then tells apart at no cost, from "bxyz" and "cxyz", which
+  // cost this miss and one more.  The tablebase prefers the smaller,
+  // harder option.
+  WordSet position("____", {"bxyz", "cxyz", "dabc", "dbca", "dcab"});
+  TablebaseBuilder builder(8);
+  builder.solve(position);
+  ASSERT_TRUE(builder.write(filename_));
+  Tablebase tablebase;
+  ASSERT_TRUE(tablebase.open(filename_));
+
+  std::vector<WordSet> options = position.partition('d');
+  ASSERT_THAT(options.size(), Eq(2u));
+  std::vector<WordSet>::size_type largest =
+      choose_wordset(options, 'd', nullptr);
+  std::vector<WordSet>::size_type hardest =
+      choose_wordset(options, 'd', &tablebase);
+
+  EXPECT_THAT(options[largest].size(), Eq(3u));
+  EXPECT_THAT(options[hardest], Eq(WordSet("____", {"bxyz", "cxyz"})));
+}
+}  // namespace testing
+}  // namespace evil_hangman
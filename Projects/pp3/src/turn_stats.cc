@@ -0,0 +1,81 @@
+// turn_stats.cc --- Defines the TurnStats class for timing the phases
+// of an Evil Hangman game, turn by turn, and exporting the results.
+
+
+// turn_stats.cc is Copyright (C) 2014 by the University of British
+// Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+
+#include "./turn_stats.h"
+
+namespace evil_hangman {
+char const * TurnStats::phase_name(Phase phase) {
+  switch (phase) {
+    case kDictionaryLoad: return "dictionary_load";
+    case kInputLength:    return "input_legal_length";
+    case kPartition:      return "partition";
+    case kStrategy:       return "strategy";
+    case kOutput:         return "output";
+    default:              return "unknown";
+  }
+}
+
+void TurnStats::add(Phase phase, Clock::duration elapsed) {
+  std::uint64_t nanoseconds = static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+  if (turns_.empty())
+    setup_[phase] += nanoseconds;
+  else
+    turns_.back().nanoseconds[phase] += nanoseconds;
+}
+
+std::uint64_t TurnStats::total_nanoseconds(Phase phase) const {
+  std::uint64_t total = setup_[phase];
+  for (Turn const &turn : turns_)
+    total += turn.nanoseconds[phase];
+  return total;
+}
+
+void TurnStats::write_json(std::ostream *out) const {
+  // Phases as "<name>_ns": <nanoseconds> members of an object.
+  auto write_phases = [out](std::uint64_t const *nanoseconds) {
+    for (int phase = 0; phase < kNumPhases; phase++) {
+      *out << (phase == 0 ? "" : ", ") << "\""
+           << phase_name(static_cast<Phase>(phase)) << "_ns\": "
+           << nanoseconds[phase];
+    }
+  };
+
+  *out << "{\n  \"setup\": {";
+  write_phases(setup_);
+  *out << "},\n  \"turns\": [";
+  for (std::vector<Turn>::size_type i = 0; i < turns_.size(); i++) {
+    Turn const &turn = turns_[i];
+    *out << (i == 0 ? "\n" : ",\n") << "    {\"turn\": " << i + 1
+         << ", \"guess\": ";
+    // The player may have typed anything; escape all but plain
+    // printable characters.
+    if (turn.guess >= ' ' && turn.guess <= '~' &&
+        turn.guess != '"' && turn.guess != '\\')
+      *out << "\"" << turn.guess << "\"";
+    else
+      *out << "\"\\u00" << "0123456789abcdef"[(turn.guess >> 4) & 0xf]
+           << "0123456789abcdef"[turn.guess & 0xf] << "\"";
+    *out << ", \"set_size\": " << turn.set_size
+         << ", \"buckets\": " << turn.buckets
+         << ", \"largest_bucket\": " << turn.largest_bucket << ", ";
+    write_phases(turn.nanoseconds);
+    *out << "}";
+  }
+  *out << (turns_.empty() ? "" : "\n  ") << "],\n  \"totals\": {";
+  std::uint64_t totals[kNumPhases];
+  for (int phase = 0; phase < kNumPhases; phase++)
+    totals[phase] = total_nanoseconds(static_cast<Phase>(phase));
+  write_phases(totals);
+  *out << "}\n}\n";
+}
+}  // namespace evil_hangman
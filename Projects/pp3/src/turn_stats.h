@@ -0,0 +1,121 @@
+// turn_stats.h --- Declares the TurnStats class for timing the phases
+// of an Evil Hangman game, turn by turn, and exporting the results.
+
+
+// turn_stats.h is Copyright (C) 2014 by the University of British
+// Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#ifndef DYNAMIC_HANGMAN_TURN_STATS_H_
+#define DYNAMIC_HANGMAN_TURN_STATS_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace evil_hangman {
+// Counters and timers for one game.  A disabled TurnStats (the
+// default) records nothing and never reads the clock, so the
+// instrumentation can stay in the game at the cost of a branch.
+//
+// Time measured before the first turn (loading the dictionary,
+// choosing a length) is kept as setup time; everything after
+// begin_turn is charged to the current turn.
+class TurnStats {
+ public:
+  enum Phase {
+    kDictionaryLoad,
+    kInputLength,
+    kPartition,       // partition or generate_new_wordset
+    kStrategy,        // choosing among the partitioned options
+    kOutput,
+    kNumPhases
+  };
+
+  struct Turn {
+    char guess = '\0';
+    std::size_t set_size = 0;       // Words before the guess.
+    std::size_t buckets = 0;        // Options the guess produced.
+    std::size_t largest_bucket = 0;
+    std::uint64_t nanoseconds[kNumPhases] = {0};
+  };
+
+  // Times one phase from construction to destruction (if enabled).
+  class Timer {
+   public:
+    Timer(TurnStats *stats, Phase phase) : stats_(stats), phase_(phase) {
+      if (stats_->enabled_)
+        start_ = Clock::now();
+    }
+
+    ~Timer() {
+      if (stats_->enabled_)
+        stats_->add(phase_, Clock::now() - start_);
+    }
+
+   private:
+    Timer(Timer const &);
+    Timer & operator=(Timer const &);
+
+    TurnStats *stats_;
+    Phase phase_;
+    std::chrono::steady_clock::time_point start_;
+  };
+
+  explicit TurnStats(bool enabled = false) : enabled_(enabled) { }
+
+  bool enabled() const {
+    return enabled_;
+  }
+
+  // Starts a new turn with set_size words in play.
+  void begin_turn(std::size_t set_size) {
+    if (enabled_) {
+      turns_.push_back(Turn());
+      turns_.back().set_size = set_size;
+    }
+  }
+
+  // Records the guess and the shape of its partition for this turn.
+  void record_guess(char guess, std::size_t buckets,
+                    std::size_t largest_bucket) {
+    if (enabled_ && !turns_.empty()) {
+      turns_.back().guess = guess;
+      turns_.back().buckets = buckets;
+      turns_.back().largest_bucket = largest_bucket;
+    }
+  }
+
+  std::vector<Turn> const & turns() const {
+    return turns_;
+  }
+
+  std::uint64_t setup_nanoseconds(Phase phase) const {
+    return setup_[phase];
+  }
+
+  // Sum of a phase over setup and every turn.
+  std::uint64_t total_nanoseconds(Phase phase) const;
+
+  // Writes everything recorded as a single JSON object.
+  void write_json(std::ostream *out) const;
+
+  static char const * phase_name(Phase phase);
+
+ private:
+  typedef std::chrono::steady_clock Clock;
+
+  void add(Phase phase, Clock::duration elapsed);
+
+  bool enabled_;
+  std::uint64_t setup_[kNumPhases] = {0};
+  std::vector<Turn> turns_;
+};
+}  // namespace evil_hangman
+
+#endif  // DYNAMIC_HANGMAN_TURN_STATS_H_
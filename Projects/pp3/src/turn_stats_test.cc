@@ -0,0 +1,109 @@
+// turn_stats_test.cc --- Test code for the TurnStats instrumentation
+// declared in turn_stats.h.
+
+// turn_stats_test.cc is Copyright (C) 2014 by CPSC 221 at the
+// University of British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#include <gmock/gmock.h>
+using ::testing::Eq;
+using ::testing::Gt;
+using ::testing::HasSubstr;
+#include <gtest/gtest.h>
+using ::testing::Test;
+
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "./turn_stats.h"
+
+namespace evil_hangman {
+namespace testing {
+class TurnStatsTest : public Test {
+ protected:
+  TurnStatsTest() { }
+  virtual ~TurnStatsTest() { }
+
+  // Spends a little measurable time in the given phase.
+  void spend(TurnStats *stats, TurnStats::Phase phase) {
+    TurnStats::Timer timer(stats, phase);
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+  }
+};
+
+TEST_F(TurnStatsTest, DisabledRecordsNothing) {
+  TurnStats stats;
+  EXPECT_FALSE(stats.enabled());
+
+  spend(&stats, TurnStats::kDictionaryLoad);
+  stats.begin_turn(100);
+  spend(&stats, TurnStats::kPartition);
+  stats.record_guess('e', 3, 60);
+
+  EXPECT_THAT(stats.turns().size(), Eq(0u));
+  EXPECT_THAT(stats.total_nanoseconds(TurnStats::kDictionaryLoad), Eq(0u));
+  EXPECT_THAT(stats.total_nanoseconds(TurnStats::kPartition), Eq(0u));
+}
+
+TEST_F(TurnStatsTest, SetupAndTurnsAreSeparate) {
+  TurnStats stats(true);
+  spend(&stats, TurnStats::kDictionaryLoad);
+  spend(&stats, TurnStats::kInputLength);
+  EXPECT_THAT(stats.setup_nanoseconds(TurnStats::kDictionaryLoad), Gt(0u));
+  EXPECT_THAT(stats.setup_nanoseconds(TurnStats::kInputLength), Gt(0u));
+
+  stats.begin_turn(100);
+  spend(&stats, TurnStats::kPartition);
+  spend(&stats, TurnStats::kStrategy);
+  stats.record_guess('e', 3, 60);
+  stats.begin_turn(60);
+  stats.record_guess('7', 0, 0);
+  spend(&stats, TurnStats::kOutput);
+
+  ASSERT_THAT(stats.turns().size(), Eq(2u));
+  TurnStats::Turn const &first = stats.turns()[0];
+  EXPECT_THAT(first.guess, Eq('e'));
+  EXPECT_THAT(first.set_size, Eq(100u));
+  EXPECT_THAT(first.buckets, Eq(3u));
+  EXPECT_THAT(first.largest_bucket, Eq(60u));
+  EXPECT_THAT(first.nanoseconds[TurnStats::kPartition], Gt(0u));
+  EXPECT_THAT(first.nanoseconds[TurnStats::kStrategy], Gt(0u));
+  EXPECT_THAT(first.nanoseconds[TurnStats::kOutput], Eq(0u));
+
+  TurnStats::Turn const &second = stats.turns()[1];
+  EXPECT_THAT(second.set_size, Eq(60u));
+  EXPECT_THAT(second.nanoseconds[TurnStats::kOutput], Gt(0u));
+
+  EXPECT_THAT(stats.setup_nanoseconds(TurnStats::kPartition), Eq(0u));
+  EXPECT_THAT(stats.total_nanoseconds(TurnStats::kPartition),
+              Eq(first.nanoseconds[TurnStats::kPartition]));
+}
+
+TEST_F(TurnStatsTest, WriteJson) {
+  TurnStats stats(true);
+  stats.begin_turn(100);
+  stats.record_guess('e', 3, 60);
+  stats.begin_turn(60);
+  stats.record_guess('"', 0, 0);
+
+  std::ostringstream out;
+  stats.write_json(&out);
+  std::string json = out.str();
+
+  EXPECT_THAT(json, HasSubstr("\"setup\": {\"dictionary_load_ns\": 0, "
+                              "\"input_legal_length_ns\": 0, "
+                              "\"partition_ns\": 0, \"strategy_ns\": 0, "
+                              "\"output_ns\": 0}"));
+  EXPECT_THAT(json, HasSubstr("{\"turn\": 1, \"guess\": \"e\", "
+                              "\"set_size\": 100, \"buckets\": 3, "
+                              "\"largest_bucket\": 60, "));
+  EXPECT_THAT(json, HasSubstr("{\"turn\": 2, \"guess\": \"\\u0022\", "));
+  EXPECT_THAT(json, HasSubstr("\"totals\": {"));
+}
+}  // namespace testing
+}  // namespace evil_hangman
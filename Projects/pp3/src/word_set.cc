@@ -24,12 +24,11 @@ std::string make_quoted(std::string const & str) {
 
 std::random_device rd;
 std::default_random_engine generator(rd());
-}  // namespace
-
-namespace evil_hangman {
 
-void WordSet::validate(std::string const & pattern,
-                       StrSet const & words) {
+// Checks the WordSet constructor's conditions on any range of words;
+// see WordSet::validate.
+template <typename Words>
+void validate_words(std::string const & pattern, Words const & words) {
   // Special case if no words:
   if (words.size() == 0) {
     if (pattern != "") {
@@ -50,7 +49,7 @@ void WordSet::validate(std::string const & pattern,
                                 "or underscores _");
   }
 
-  for (std::string word : words) {
+  for (std::string const &word : words) {
     if (word.size() != pattern.size()) {
       throw std::invalid_argument("all words and the pattern "
                                   "must be the same length");
@@ -89,93 +88,253 @@ void WordSet::validate(std::string const & pattern,
   }
 }
 
+// Orders and groups words by the pattern a guess reveals in them.
+// Two such patterns first differ where one word has the guess and
+// the other does not, and there the other pattern has an underscore,
+// which sorts before any letter.  So, reading the guess's positions
+// as a number with the first letter most significant, smaller
+// numbers mean earlier patterns.  Words of more than 64 letters fall
+// back on comparing the words themselves.
+unsigned const kMaxKeyedLength = 64;
+
+std::uint64_t reveal_key(std::string const & word, char guess) {
+  std::uint64_t key = 0;
+  for (std::string::size_type i = 0; i < word.size(); i++) {
+    key <<= 1;
+    key |= word[i] == guess;
+  }
+  return key;
+}
+
+bool reveals_less(std::string const & lhs, std::string const & rhs,
+                  char guess) {
+  for (std::string::size_type i = 0; i < lhs.size(); i++) {
+    if ((lhs[i] == guess) != (rhs[i] == guess))
+      return rhs[i] == guess;
+  }
+  return false;
+}
+}  // namespace
+
+namespace evil_hangman {
+WordSet::WordSet(std::string const pattern, StrSet const words)
+    : pattern_(pattern) {
+  validate(pattern_, words);
+
+  // Both the lexicon and the ids come out sorted, since words is.
+  lexicon_ = std::make_shared<Lexicon const>(words.cbegin(), words.cend());
+
+  std::vector<WordId> ids(words.size());
+  for (WordId id = 0; id < ids.size(); id++)
+    ids[id] = id;
+  assign_ids(ids.data(), ids.size());
+}
+
+WordSet::WordSet(std::string const pattern, Words const words)
+    : pattern_(pattern), lexicon_(words.word_set_->lexicon_) {
+  validate_words(pattern_, words);
+  copy_ids(*words.word_set_);
+}
+
+WordSet::WordSet(std::string const & pattern,
+                 std::shared_ptr<Lexicon const> const & lexicon,
+                 WordId const * ids, size_type count)
+    : pattern_(pattern), lexicon_(lexicon) {
+  assign_ids(ids, count);
+}
+
+void WordSet::assign_ids(WordId const * ids, size_type count) {
+  release_ids();
+  if (count <= kInlineWords) {
+    std::copy(ids, ids + count, inline_ids_);
+  } else {
+    new (&shared_ids_) SharedIds(
+        std::make_shared<std::vector<WordId> const>(ids, ids + count));
+  }
+  size_ = count;
+}
+
+void WordSet::copy_ids(WordSet const & other) {
+  if (this == &other)
+    return;
+
+  // Large sets never change their ids, so they can share them.
+  release_ids();
+  if (other.ids_shared()) {
+    new (&shared_ids_) SharedIds(other.shared_ids_);
+  } else {
+    std::copy(other.inline_ids_, other.inline_ids_ + other.size_,
+              inline_ids_);
+  }
+  size_ = other.size_;
+}
+
+void WordSet::release_ids() {
+  if (ids_shared())
+    shared_ids_.~SharedIds();
+  size_ = 0;
+}
+
+void WordSet::validate(std::string const & pattern,
+                       StrSet const & words) {
+  validate_words(pattern, words);
+}
+
 WordSet WordSet::generate_new_wordset(char guess) const {
   if (!(guess >= 'a' && guess <= 'z'))
     throw std::invalid_argument("guess must be a lower-case letter");
 
+  // Everything but the resulting WordSet lives in the turn arena and
+  // is released when this scope closes.
+  Arena::Scope scope(&turn_arena());
+
   // find all words that contain the guessed character
-  std::vector<std::string> wordsWithGuess = find_matching_words(guess);
+  WordRefs wordsWithGuess = find_matching_word_refs(guess, &turn_arena());
 
   if (wordsWithGuess.size() == 0)
       return *this;
 
   std::uniform_int_distribution<int>  distribution(0, wordsWithGuess.size()-1);
   int index = distribution(generator);
-  std::string templateWord = wordsWithGuess[index];
-  std::string newPattern = extract_pattern(templateWord, guess);
+  std::string newPattern = extract_pattern(*wordsWithGuess[index], guess);
+
+  // The refs point into the lexicon, so they give back the ids (still
+  // in order).
+  std::vector<WordId, ArenaAllocator<WordId> > newIds{
+    ArenaAllocator<WordId>(&turn_arena())};
+  newIds.reserve(wordsWithGuess.size());
+  for (std::string const *word : wordsWithGuess) {
+    if (matches_pattern(*word, newPattern, guess))
+      newIds.push_back(static_cast<WordId>(word - lexicon_data()));
+  }
 
-  return generate_wordset_from_pattern(newPattern, guess, wordsWithGuess);
+  return WordSet(newPattern, lexicon_, newIds.data(), newIds.size());
 }
 
 std::vector<std::string> WordSet::find_matching_words(char guess) const {
+  Arena::Scope scope(&turn_arena());
+  WordRefs refs = find_matching_word_refs(guess, &turn_arena());
+
   std::vector<std::string>  matchingWords;
-  for (std::string word : words_) {
+  matchingWords.reserve(refs.size());
+  for (std::string const *word : refs)
+    matchingWords.push_back(*word);
+
+  return matchingWords;
+}
+
+WordSet::WordRefs WordSet::find_matching_word_refs(char guess,
+                                                   Arena *arena) const {
+  WordRefs matchingWords{ArenaAllocator<std::string const *>(arena)};
+  // One up-front reservation so the vector never regrows in the arena.
+  matchingWords.reserve(size_);
+  for (std::string const &word : words()) {
     if (word.find(guess) != std::string::npos)
-      matchingWords.push_back(word);
-    }
+      matchingWords.push_back(&word);
+  }
 
   return matchingWords;
 }
 
-std::string WordSet::extract_pattern(std::string word, char guess) const {
-  std::string newPattern;
+std::string WordSet::extract_pattern(std::string const & word,
+                                     char guess) const {
+  // Sized once up front rather than grown a character at a time.
+  std::string newPattern(word.size(), '_');
 
-  for (int i = 0; i < word.size(); i++) {
-      if (word[i] == guess)
-        newPattern += word[i];
-      else if (pattern_[i] != '_')
-        newPattern += pattern_[i];
-      else
-        newPattern += '_';
-    }
+  for (std::string::size_type i = 0; i < word.size(); i++) {
+    if (word[i] == guess)
+      newPattern[i] = guess;
+    else
+      newPattern[i] = pattern_[i];
+  }
 
   return newPattern;
 }
 
-WordSet
-WordSet::generate_wordset_from_pattern(std::string pattern,
-                                       char guess,
-                                       std::vector<std::string> words) const {
-  // TODO(you): Fix the bug(s) in this method
-  StrSet newWords;
-
-  for (std::string word : words) {
-    std::string wordPattern;
-    for (int i = 0; i < word.size(); i++) {
-      if (word[i] == guess)
-        wordPattern += word[i];
-      else
-        wordPattern += '_';
-    }
+bool WordSet::matches_pattern(std::string const & word,
+                              std::string const & pattern,
+                              char guess) {
+  for (std::string::size_type i = 0; i < word.size(); i++) {
+    if ((word[i] == guess) != (pattern[i] == guess))
+      return false;
+  }
+  return true;
+}
 
-    bool acc = true;
-    for (int i = 0; i < word.size(); i++) {
-      if (pattern[i] =='_')
-          acc &= (wordPattern[i] == '_');
-      else if (pattern[i] == guess)
-          acc &= (wordPattern[i] == guess);
-      else
-        acc &= (wordPattern[i] == '_');
-    }
+WordSet WordSet::generate_wordset_from_pattern(
+    std::string const & pattern,
+    char guess,
+    std::vector<std::string> const & words) const {
+  StrSet newWords;
 
-    if (acc)
+  for (std::string const &word : words) {
+    if (matches_pattern(word, pattern, guess))
       newWords.insert(word);
   }
 
   // We shouldn't "usually" fall into this case, but empty wordlists
   // must have empty patterns.
   if (newWords.size() == 0)
-    pattern = "";
+    return WordSet("", newWords);
 
   return WordSet(pattern, newWords);
 }
 
 std::vector<WordSet> WordSet::partition(char guess) const {
+  Arena::Scope scope(&turn_arena());
+  Options options = partition(guess, &turn_arena());
+  return std::vector<WordSet>(options.cbegin(), options.cend());
+}
+
+WordSet::Options WordSet::partition(char guess, Arena *arena) const {
   if (!(guess >= 'a' && guess <= 'z'))
     throw std::invalid_argument("guess must be a lower-case letter");
 
-  std::vector<WordSet> sets;
-  // TODO(you): fill in the rest of the code
+  // Words land in the same WordSet exactly when the guess reveals
+  // the same new pattern in them.  Sort the ids by that pattern (and
+  // then by id, keeping each group in order) and cut the groups out.
+  std::string const *lexicon = lexicon_data();
+  std::vector<WordId, ArenaAllocator<WordId> > order{
+    ArenaAllocator<WordId>(arena)};
+  order.reserve(size_);
+  if (pattern_.size() <= kMaxKeyedLength) {
+    typedef std::pair<std::uint64_t, WordId> KeyedId;
+    std::vector<KeyedId, ArenaAllocator<KeyedId> > keyed{
+      ArenaAllocator<KeyedId>(arena)};
+    keyed.reserve(size_);
+    for (WordId const *id = ids(); id != ids() + size_; ++id)
+      keyed.push_back(KeyedId(reveal_key(lexicon[*id], guess), *id));
+    std::sort(keyed.begin(), keyed.end());
+    for (KeyedId const &keyed_id : keyed)
+      order.push_back(keyed_id.second);
+  } else {
+    order.assign(ids(), ids() + size_);
+    std::stable_sort(order.begin(), order.end(),
+                     [lexicon, guess](WordId lhs, WordId rhs) {
+                       return reveals_less(lexicon[lhs], lexicon[rhs], guess);
+                     });
+  }
+
+  // Count the groups (where the guess reveals something new in the
+  // next word) to make room for them all at once.
+  Options sets{ArenaAllocator<WordSet>(arena)};
+  size_type groups = order.empty() ? 0 : 1;
+  for (size_type i = 1; i < order.size(); i++) {
+    if (!matches_pattern(lexicon[order[i]], lexicon[order[i - 1]], guess))
+      ++groups;
+  }
+  sets.reserve(groups);
+
+  for (size_type first = 0; first < order.size(); ) {
+    std::string const &word = lexicon[order[first]];
+    std::string pattern = extract_pattern(word, guess);
+    size_type last = first + 1;
+    while (last < order.size() &&
+           matches_pattern(lexicon[order[last]], pattern, guess))
+      ++last;
+    sets.push_back(WordSet(pattern, lexicon_, &order[first], last - first));
+    first = last;
+  }
 
   return sets;
 }
@@ -184,26 +343,28 @@ std::vector<WordSet> WordSet::partition(char guess) const {
 std::ostream& operator<<(std::ostream & os, WordSet const & ws) {
   os << "\"" << ws.pattern() << "\", ";
   os << "{";
-  if (ws.size() > 0) {
-    std::transform(ws.words().cbegin(), --ws.words().cend(),
-                   std::ostream_iterator<std::string>(os, ", "),
-                   make_quoted);
-    os << "\"" << *ws.words().crbegin() << "\"";
+  char const *separator = "";
+  for (std::string const &word : ws.words()) {
+    os << separator << make_quoted(word);
+    separator = ", ";
   }
   os << "}";
   return os;
 }
 
 std::string WordSet::choose_random_word() const {
+  return choose_random_word(&generator);
+}
+
+std::string WordSet::choose_random_word(
+    std::default_random_engine *random) const {
   // Degenerate case defined to return the empty string.
-  if (words_.size() == 0)
+  if (size_ == 0)
     return "";
 
   // Minus one because distribution generates something in the range
   // [a,b], NOT the range [a,b).
-  Distribution distribution(0, words_.size() - 1);
-  StrSet::const_iterator chosen_word = words_.cbegin();
-  std::advance(chosen_word, distribution(generator));
-  return *chosen_word;
+  Distribution distribution(0, size_ - 1);
+  return lexicon_data()[ids()[distribution(*random)]];
 }
 }  // namespace evil_hangman
@@ -13,21 +13,133 @@
 #ifndef DYNAMIC_HANGMAN_WORD_SET_H_
 #define DYNAMIC_HANGMAN_WORD_SET_H_
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <set>
+#include <memory>
+#include <new>
+#include <random>
 #include <stdexcept>
 #include <algorithm>
 #include <iterator>
 #include <ostream>
 #include <map>
 
+#include "./arena.h"
+
 namespace evil_hangman {
 class WordSet {
  public:
   typedef std::set<std::string> StrSet;
   typedef StrSet::size_type size_type;
 
+  // Words are stored once, sorted, in a Lexicon shared by a WordSet
+  // and every WordSet partitioned from it; a WordSet itself holds
+  // only the sorted ids (indexes into the lexicon) of its words.
+  typedef std::vector<std::string> Lexicon;
+  typedef std::uint32_t WordId;
+
+  // Sets of at most this many words (most options late in a game)
+  // keep their ids inline, with no allocation of their own.  Larger
+  // sets share an immutable, heap-allocated id list instead.  The two
+  // share their storage, which keeps WordSets (copied into every
+  // vector of options) small.
+  static size_type const kInlineWords = 16;
+
+  // A read-only, sorted view of the words in a WordSet, usable like
+  // a container of std::string.  Valid as long as the WordSet is.
+  class Words {
+   public:
+    class const_iterator {
+     public:
+      typedef std::bidirectional_iterator_tag iterator_category;
+      typedef std::string value_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef std::string const * pointer;
+      typedef std::string const & reference;
+
+      const_iterator() : lexicon_(nullptr), id_(nullptr) { }
+
+      reference operator*() const {
+        return lexicon_[*id_];
+      }
+      pointer operator->() const {
+        return &lexicon_[*id_];
+      }
+
+      const_iterator & operator++() {
+        ++id_;
+        return *this;
+      }
+      const_iterator operator++(int) {
+        const_iterator old(*this);
+        ++id_;
+        return old;
+      }
+      const_iterator & operator--() {
+        --id_;
+        return *this;
+      }
+      const_iterator operator--(int) {
+        const_iterator old(*this);
+        --id_;
+        return old;
+      }
+
+      bool operator==(const_iterator const &other) const {
+        return id_ == other.id_;
+      }
+      bool operator!=(const_iterator const &other) const {
+        return id_ != other.id_;
+      }
+
+     private:
+      friend class Words;
+      const_iterator(std::string const * lexicon, WordId const * id)
+          : lexicon_(lexicon), id_(id) { }
+
+      std::string const *lexicon_;
+      WordId const *id_;
+    };
+    typedef const_iterator iterator;
+    typedef std::string value_type;
+    typedef WordSet::size_type size_type;
+
+    const_iterator begin() const {
+      return const_iterator(word_set_->lexicon_data(), word_set_->ids());
+    }
+    const_iterator end() const {
+      return const_iterator(word_set_->lexicon_data(),
+                            word_set_->ids() + word_set_->size_);
+    }
+    const_iterator cbegin() const {
+      return begin();
+    }
+    const_iterator cend() const {
+      return end();
+    }
+
+    size_type size() const {
+      return word_set_->size_;
+    }
+    bool empty() const {
+      return word_set_->size_ == 0;
+    }
+
+   private:
+    friend class WordSet;
+    explicit Words(WordSet const * word_set) : word_set_(word_set) { }
+
+    WordSet const *word_set_;
+  };
+
+  // Borrowed pointers to words in a WordSet, held in an Arena.  Valid
+  // only until either the WordSet dies or the arena is rewound.
+  typedef std::vector<std::string const *,
+                      ArenaAllocator<std::string const *> > WordRefs;
+
   static void validate(std::string const & pattern,
                        StrSet const & words);
 
@@ -39,27 +151,41 @@ class WordSet {
   // letter as any non-underscore at any OTHER location in the
   // pattern.  SPECIAL CASE: an empty word list must have an empty
   // pattern.
-  WordSet(std::string const pattern, StrSet const words)
-      : pattern_(pattern), words_(words) {
-    validate(pattern_, words_);
-  }
+  //
+  // The words are copied into a new lexicon.
+  WordSet(std::string const pattern, StrSet const words);
+
+  // As above, but for the words of another WordSet, sharing its
+  // lexicon rather than copying the words.
+  WordSet(std::string const pattern, Words const words);
 
   // Copy constructor.
   WordSet(WordSet const & other)
-      : pattern_(other.pattern_), words_(other.words_) { }
+      : pattern_(other.pattern_), lexicon_(other.lexicon_) {
+    copy_ids(other);
+  }
 
-  virtual ~WordSet() { }
+  WordSet & operator=(WordSet const & other) {
+    pattern_ = other.pattern_;
+    lexicon_ = other.lexicon_;
+    copy_ids(other);
+    return *this;
+  }
+
+  virtual ~WordSet() {
+    release_ids();
+  }
 
   size_type size() const {
-    return words_.size();
+    return size_;
   }
 
   std::string const & pattern() const {
     return pattern_;
   }
 
-  StrSet const & words() const {
-    return words_;
+  Words words() const {
+    return Words(this);
   }
 
   // Generates a new wordset by picking a random word from the current
@@ -75,15 +201,28 @@ class WordSet {
   // that character
   std::vector<std::string> find_matching_words(char guess) const;
 
+  // As find_matching_words, but without copying: returns pointers to
+  // the matching words in this set, allocated in the given arena.
+  WordRefs find_matching_word_refs(char guess, Arena *arena) const;
+
+  // Checks whether word belongs in the wordset with the given pattern
+  // after guessing guess, i.e., whether guess appears in word at
+  // exactly the positions it appears in pattern.  (word is assumed to
+  // already match the rest of the pattern.)
+  static bool matches_pattern(std::string const & word,
+                              std::string const & pattern,
+                              char guess);
+
   // Given a word and guess, construct a new pattern by building on
   // the existing pattern.
-  std::string extract_pattern(std::string word, char guess) const;
+  std::string extract_pattern(std::string const & word, char guess) const;
 
   // Given a pattern and words, extract all words that match the
   // pattern and generate a WordSet.
-  WordSet generate_wordset_from_pattern(std::string pattern,
-                                        char guess,
-                                        std::vector<std::string> words) const;
+  WordSet generate_wordset_from_pattern(
+      std::string const & pattern,
+      char guess,
+      std::vector<std::string> const & words) const;
 
   // Creates a list of new wordsets representing the result of
   // partitioning the current list according to the given guess.
@@ -97,17 +236,77 @@ class WordSet {
   // wordset but no word appears in multiple produced wordsets.
   std::vector<WordSet> partition(char guess) const;
 
+  // The options of a partition, held in an Arena.
+  typedef std::vector<WordSet, ArenaAllocator<WordSet> > Options;
+
+  // As above, but with the options and every temporary on the way
+  // allocated in arena, so that the only global allocations are for
+  // what the options hold themselves (the id lists of options too
+  // large to keep them inline, and patterns too long for std::string
+  // to keep inline).  The options must not outlive arena's next
+  // rewind.
+  Options partition(char guess, Arena *arena) const;
+
   // Choose a word at random from the set.  If the set is empty,
   // returns the empty string.
   std::string choose_random_word() const;
 
+  // As above, but drawing from the given engine (so that, e.g., a
+  // replayed game can be seeded deterministically).
+  std::string choose_random_word(std::default_random_engine *random) const;
+
  private:
   typedef std::uniform_int_distribution<size_type> Distribution;
 
-  StrSet words_;
+  // Trusted constructor for sets built from this one's ids (which
+  // need no validation): takes count sorted ids into lexicon.
+  WordSet(std::string const & pattern,
+          std::shared_ptr<Lexicon const> const & lexicon,
+          WordId const * ids, size_type count);
+
+  typedef std::shared_ptr<std::vector<WordId> const> SharedIds;
+
+  void assign_ids(WordId const * ids, size_type count);
+  void copy_ids(WordSet const & other);
+  // Ends the life of shared_ids_, if it's the live one, and empties
+  // the set.
+  void release_ids();
+
+  bool ids_shared() const {
+    return size_ > kInlineWords;
+  }
+
+  WordId const * ids() const {
+    return ids_shared() ? shared_ids_->data() : inline_ids_;
+  }
+
+  std::string const * lexicon_data() const {
+    return lexicon_ ? lexicon_->data() : nullptr;
+  }
+
   std::string pattern_;
+  std::shared_ptr<Lexicon const> lexicon_;
+  size_type size_ = 0;
+
+  // Exactly one of these holds the ids, and is alive: inline_ids_ for
+  // sets of at most kInlineWords words, shared_ids_ for anything
+  // larger (see ids_shared).
+  union {
+    WordId inline_ids_[kInlineWords];
+    SharedIds shared_ids_;
+  };
 };
 
+inline bool operator==(WordSet::Words const &lhs,
+                       WordSet::Words const &rhs) {
+  return lhs.size() == rhs.size() &&
+      std::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin());
+}
+inline bool operator!=(WordSet::Words const &lhs,
+                       WordSet::Words const &rhs) {
+  return !(lhs == rhs);
+}
+
 std::ostream& operator<<(std::ostream &, WordSet const &);
 inline bool operator==(WordSet const &lhs, WordSet const &rhs) {
   return lhs.pattern() == rhs.pattern() &&
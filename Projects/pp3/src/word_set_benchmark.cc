@@ -0,0 +1,138 @@
+// word_set_benchmark.cc --- Times the late-game turns of Evil
+// Hangman: partitioning the small WordSets (fewer than 64 words) that
+// a game narrows down to and picking (and copying) the adversary's
+// option.
+
+
+// word_set_benchmark.cc is Copyright (C) 2014 by the University of
+// British Columbia, Some Rights Reserved.
+//
+// This work is licensed under the Creative Commons Attribution 4.0
+// International License. To view a copy of this license, visit
+// http://creativecommons.org/licenses/by/4.0/.
+
+#include <cstdlib>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "./evil_hangman_utils.h"
+#include "./word_set.h"
+
+namespace eh = evil_hangman;
+
+namespace {
+// The largest set a "late game" position may hold.
+eh::WordSet::size_type const kLateGameWords = 64;
+
+// Guess orders used to walk each word length down to its late game;
+// each gives a different family of positions.
+char const *const kGuessOrders[] = {
+  "etaoinshrdlcumwfgypbvkjxqz",
+  "zqxjkvbpygfwmucldrhsnioate",
+  "aeioustrnlcdmpbghfywkvxzjq",
+  "srtlnmdcpbghkfwvyzxjqeaiou",
+};
+
+// Plays guesses from the given order, the adversary always keeping
+// the largest option, recording every position along the way with
+// between 2 and kLateGameWords words.
+void collect_late_game(eh::WordSet word_set, std::string const & guesses,
+                       std::vector<eh::WordSet> *positions) {
+  for (char guess : guesses) {
+    if (word_set.size() < 2)
+      return;
+    if (word_set.pattern().find(guess) != std::string::npos)
+      continue;
+
+    std::vector<eh::WordSet> options = word_set.partition(guess);
+    std::vector<eh::WordSet>::size_type largest = 0;
+    for (std::vector<eh::WordSet>::size_type i = 1; i < options.size(); i++) {
+      if (options[i].size() > options[largest].size())
+        largest = i;
+    }
+    word_set = options[largest];
+
+    if (word_set.size() > 1 && word_set.size() <= kLateGameWords)
+      positions->push_back(word_set);
+  }
+}
+}  // namespace
+
+int main(int argc, char *argv[]) {
+#ifdef DICTIONARY_FILENAME
+  std::string dictionary_filename{DICTIONARY_FILENAME};
+#else
+  #error DICTIONARY_FILENAME must be supplied.
+#endif
+
+  if (argc > 2) {
+    std::cerr << "Usage: " << argv[0] << " [rounds]" << std::endl;
+    return 1;
+  }
+  int rounds = argc > 1 ? std::atoi(argv[1]) : 20;
+  if (rounds < 1) {
+    std::cerr << "Error: rounds must be positive." << std::endl;
+    return 1;
+  }
+
+  // Load the dictionary exactly as the game does.
+  std::ifstream dictionary_input_stream(dictionary_filename);
+  eh::WordList words = eh::get_words_from_stream(&dictionary_input_stream);
+  std::transform(words.begin(), words.end(),
+                 words.begin(), eh::normalize_word);
+  std::set<std::string> words_as_set(words.cbegin(), words.cend());
+  eh::WordToLengthMap words_by_length = eh::get_words_by_length(words_as_set);
+
+  std::vector<eh::WordSet> positions;
+  for (auto const &length_words : words_by_length) {
+    eh::WordSet root(std::string(length_words.first, '_'),
+                     length_words.second);
+    for (char const *guesses : kGuessOrders)
+      collect_late_game(root, guesses, &positions);
+  }
+  if (positions.empty()) {
+    std::cerr << "Error: no late-game positions found in: "
+              << dictionary_filename << std::endl;
+    return 1;
+  }
+
+  // One turn: the player's guess is partitioned and the adversary
+  // keeps (copies, as Game does) the largest option.  Every unrevealed
+  // letter is tried.
+  typedef std::chrono::steady_clock Clock;
+  std::size_t turns = 0;
+  std::size_t checksum = 0;
+  eh::WordSet kept(positions.front());
+  Clock::time_point start = Clock::now();
+  for (int round = 0; round < rounds; round++) {
+    for (eh::WordSet const &position : positions) {
+      for (char guess = 'a'; guess <= 'z'; guess++) {
+        if (position.pattern().find(guess) != std::string::npos)
+          continue;
+        std::vector<eh::WordSet> options = position.partition(guess);
+        std::vector<eh::WordSet>::size_type largest = 0;
+        for (std::vector<eh::WordSet>::size_type i = 1; i < options.size();
+             i++) {
+          if (options[i].size() > options[largest].size())
+            largest = i;
+        }
+        kept = options[largest];
+        checksum += kept.size();
+        ++turns;
+      }
+    }
+  }
+  std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+
+  std::cout << positions.size() << " late-game positions, "
+            << turns << " turns (checksum " << checksum << ")" << std::endl;
+  std::cout << "  " << elapsed.count() / turns << " ns per turn ("
+            << sizeof(eh::WordSet) << " bytes per WordSet)" << std::endl;
+  return 0;
+}
@@ -324,6 +324,26 @@ TEST_F(WordSetTest, CopyConstructor) {
   EXPECT_THAT(other2, Eq(ws2_));
   EXPECT_THAT(other3, Eq(ws3_));
 }
+
+// Assigning between sets that keep their ids inline and sets that
+// share them switches which one holds them.
+TEST_F(WordSetTest, Assignment) {
+  WordSet::StrSet words;
+  for (char c = 'a'; words.size() <= WordSet::kInlineWords; c++)
+    words.insert(std::string{'q', c});
+  WordSet const large("__", words);
+
+  WordSet set(ws2_);
+  set = large;
+  EXPECT_THAT(set, Eq(large));
+  set = set;
+  EXPECT_THAT(set, Eq(large));
+  set = ws3_;
+  EXPECT_THAT(set, Eq(ws3_));
+  set = ws1_;
+  EXPECT_THAT(set, Eq(ws1_));
+  EXPECT_THAT(set.size(), Eq(0u));
+}
 TEST_F(WordSetTest, ChooseRandomWord) {
   // Just test a few times.
   EXPECT_THAT(ws3_.words(), Contains(ws3_.choose_random_word()));